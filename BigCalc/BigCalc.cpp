@@ -0,0 +1,85 @@
+/* BigCalc
+ * Evaluates newline separated BigInt expressions in bulk
+ *
+ * Usage: BigCalc [file]
+ * Reads the file, or stdin when no file (or "-") is given. Each expression's
+ * value is written to stdout on its own line; assignments print nothing.
+ * See Evaluator.hpp for the syntax. A line that fails prints its error to
+ * stderr and evaluation carries on with the next line. When done, line counts
+ * and throughput are reported on stderr */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono> /* std::chrono::steady_clock */
+#include <exception>
+#include "Evaluator.hpp"
+#include "BufferedWriter.hpp"
+
+int main(int argc, char *argv[]) {
+	std::ios::sync_with_stdio(false);
+
+	if (argc > 2) {
+		std::cerr << "Usage: " << argv[0] << " [file]" << std::endl;
+		return 2;
+	}
+
+	std::ifstream file;
+	std::istream *in = &std::cin;
+	if (argc == 2 && std::string(argv[1]) != "-") {
+		file.open(argv[1]);
+		if (!file) {
+			std::cerr << "Cannot open " << argv[1] << std::endl;
+			return 1;
+		}
+		in = &file;
+	}
+
+	Evaluator evaluator;
+	BufferedWriter out(stdout);
+
+	unsigned long long lines = 0;
+	unsigned long long results = 0;
+	unsigned long long errors = 0;
+	unsigned long long bytesRead = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::string line;
+	while (std::getline(*in, line)) {
+		++lines;
+		bytesRead += line.size() + 1;
+
+		try {
+			if (BigInt const *result = evaluator.execute(line)) {
+				out.write(result->toString());
+				out.put('\n');
+				++results;
+			}
+		}
+		catch (std::exception const &e) {
+			++errors;
+			std::cerr << "line " << lines << ": " << e.what() << '\n';
+		}
+	}
+
+	bool written = out.flush();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (seconds <= 0) {
+		seconds = 1e-9;
+	}
+
+	std::cerr << lines << " lines, " << results << " results, " << errors << " errors in " << seconds << " s\n"
+		<< lines / seconds << " lines/s, "
+		<< bytesRead / seconds / (1 << 20) << " MiB/s in, "
+		<< out.bytesWritten() / seconds / (1 << 20) << " MiB/s out\n"
+		<< evaluator.instructionCount() << " instructions run, "
+		<< evaluator.reusedCount() << " reused" << std::endl;
+
+	if (!written) {
+		std::cerr << "Error writing output" << std::endl;
+		return 1;
+	}
+
+	return errors ? 1 : 0;
+}
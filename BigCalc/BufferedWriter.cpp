@@ -0,0 +1,59 @@
+#include "BufferedWriter.hpp"
+#include <cstring> /* std::memcpy */
+
+// -------------- Public
+/* Constructor
+ * Buffers up to capacity bytes before writing to file */
+BufferedWriter::BufferedWriter(std::FILE *file, size_t capacity)
+	: m_file(file), m_buffer(capacity ? capacity : 1), m_used(0), m_written(0) {}
+
+/* Destructor
+ * Flushes what remains */
+BufferedWriter::~BufferedWriter() {
+	flush();
+}
+
+/* Appends a string
+ * Strings larger than the whole buffer skip it and go straight to the file */
+void BufferedWriter::write(std::string const &s) {
+	m_written += s.size();
+
+	if (m_used + s.size() > m_buffer.size()) {
+		flush();
+	}
+
+	if (s.size() > m_buffer.size()) {
+		std::fwrite(s.data(), 1, s.size(), m_file);
+		return;
+	}
+
+	std::memcpy(m_buffer.data() + m_used, s.data(), s.size());
+	m_used += s.size();
+}
+
+/* Appends a single character */
+void BufferedWriter::put(char c) {
+	++m_written;
+
+	if (m_used == m_buffer.size()) {
+		flush();
+	}
+
+	m_buffer[m_used++] = c;
+}
+
+/* Writes the buffer out to the file
+ * Returns false if the file reported an error */
+bool BufferedWriter::flush() {
+	if (m_used) {
+		std::fwrite(m_buffer.data(), 1, m_used, m_file);
+		m_used = 0;
+	}
+
+	return std::fflush(m_file) == 0 && !std::ferror(m_file);
+}
+
+/* Returns the number of bytes written, buffered ones included */
+unsigned long long BufferedWriter::bytesWritten() const {
+	return m_written;
+}
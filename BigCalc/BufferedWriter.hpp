@@ -0,0 +1,37 @@
+/* BufferedWriter
+ * Collects output in a large buffer and hands it to a FILE in big blocks,
+ * so writing millions of short lines costs few system calls */
+
+#pragma once
+#include <cstdio> /* std::FILE */
+#include <string>
+#include <vector> /* std::vector */
+
+class BufferedWriter {
+public:
+/* Constructors */
+	// Buffers up to capacity bytes before writing to file
+	explicit BufferedWriter(std::FILE *file, size_t capacity = 1 << 20);
+	// Flushes what remains
+	~BufferedWriter();
+
+	BufferedWriter(BufferedWriter const &) = delete;
+	BufferedWriter &operator=(BufferedWriter const &) = delete;
+
+/* Function members */
+	void write(std::string const &s);
+	void put(char c);
+
+	// Writes the buffer out to the file
+	// Returns false if the file reported an error
+	bool flush();
+
+	// Returns the number of bytes written, buffered ones included
+	unsigned long long bytesWritten() const;
+
+private:
+	std::FILE *m_file;
+	std::vector<char> m_buffer;
+	size_t m_used;
+	unsigned long long m_written;
+};
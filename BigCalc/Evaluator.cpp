@@ -0,0 +1,403 @@
+#include "Evaluator.hpp"
+#include <cctype> /* std::isdigit, std::isalpha, std::isalnum */
+#include <climits> /* SIZE_MAX */
+#include <utility> /* std::swap */
+
+// -------------- Helpers
+namespace {
+	// Longest literal which always fits a long long
+	const size_t IMMEDIATE_DIGITS = 18;
+
+	bool isNameStart(char c) {
+		return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+	}
+
+	bool isNameChar(char c) {
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+	}
+}
+
+// -------------- Public
+/* Default constructor */
+Evaluator::Evaluator() : m_line(nullptr), m_pos(0), m_instructionCount(0), m_reusedCount(0) {}
+
+/* Compiles and runs one line
+ * Returns the result of an expression, or nullptr for an assignment or a blank line
+ * Throws std::invalid_argument on syntax errors, division by zero or a bad exponent */
+BigInt const *Evaluator::execute(std::string const &line) {
+	m_line = &line;
+	m_pos = 0;
+	m_plan.clear();
+	m_emitted.clear();
+	m_constants.clear();
+
+	if (!peek()) {
+		return nullptr;
+	}
+
+	// An assignment starts with a name followed by '='
+	size_t target = SIZE_MAX;
+	if (isNameStart(peek())) {
+		size_t start = m_pos;
+		std::string name = readName();
+		if (peek() == '=') {
+			++m_pos;
+			target = slotOf(name);
+		}
+		else {
+			m_pos = start;
+		}
+	}
+
+	Operand result = parseExpression();
+	if (char c = peek()) {
+		throw error(std::string("Unexpected '") + c + "'");
+	}
+
+	run();
+
+	if (target == SIZE_MAX) {
+		switch (result.kind) {
+		case Operand::Kind::Register: return &m_registers[result.index];
+		case Operand::Kind::Variable: return &m_variables[result.index];
+		case Operand::Kind::Immediate: break;
+		}
+
+		m_immediateResult = result.immediate;
+		return &m_immediateResult;
+	}
+
+	BigInt &variable = m_variables[target];
+	switch (result.kind) {
+	case Operand::Kind::Register:
+		// The register is rewritten before it is read again, so its value can be taken
+		std::swap(variable, m_registers[result.index]);
+		break;
+	case Operand::Kind::Variable:
+		if (result.index != target) {
+			variable = m_variables[result.index];
+		}
+		break;
+	case Operand::Kind::Immediate:
+		variable = result.immediate;
+		break;
+	}
+
+	return nullptr;
+}
+
+/* Returns the number of instructions run over every line so far */
+unsigned long long Evaluator::instructionCount() const {
+	return m_instructionCount;
+}
+
+/* Returns the number of instructions skipped because an identical one was already in the plan */
+unsigned long long Evaluator::reusedCount() const {
+	return m_reusedCount;
+}
+
+// -------------- Private
+/* Checks if two operands read the same value */
+bool Evaluator::Operand::operator==(Operand const &other) const {
+	return kind == other.kind && index == other.index && immediate == other.immediate;
+}
+
+/* Checks if two instructions compute the same value */
+bool Evaluator::Instruction::operator==(Instruction const &other) const {
+	return op == other.op && lhs == other.lhs && rhs == other.rhs;
+}
+
+/* Hashes every field of an instruction */
+size_t Evaluator::InstructionHash::operator()(Instruction const &instruction) const {
+	size_t hash = static_cast<size_t>(instruction.op);
+	for (Operand const *operand : {&instruction.lhs, &instruction.rhs}) {
+		hash = hash * 31 + static_cast<size_t>(operand->kind);
+		hash = hash * 1000003 + operand->index;
+		hash = hash * 1000003 + static_cast<size_t>(operand->immediate);
+	}
+
+	return hash;
+}
+
+/* expression = term (('+' | '-') term)* */
+Evaluator::Operand Evaluator::parseExpression() {
+	Operand lhs = parseTerm();
+	for (char c = peek(); c == '+' || c == '-'; c = peek()) {
+		++m_pos;
+		Operand rhs = parseTerm();
+		lhs = emit(c == '+' ? Op::Add : Op::Subtract, lhs, rhs);
+	}
+
+	return lhs;
+}
+
+/* term = factor (('*' | '/' | '%') factor)* */
+Evaluator::Operand Evaluator::parseTerm() {
+	Operand lhs = parseFactor();
+	for (char c = peek(); c == '*' || c == '/' || c == '%'; c = peek()) {
+		++m_pos;
+		Operand rhs = parseFactor();
+		lhs = emit(c == '*' ? Op::Multiply : c == '/' ? Op::Divide : Op::Modulo, lhs, rhs);
+	}
+
+	return lhs;
+}
+
+/* factor = unary ('^' factor)?
+ * Recursing on the right makes ^ right associative */
+Evaluator::Operand Evaluator::parseFactor() {
+	Operand base = parseUnary();
+	if (peek() != '^') {
+		return base;
+	}
+
+	++m_pos;
+	Operand exponent = parseFactor();
+
+	return emit(Op::Power, base, exponent);
+}
+
+/* unary = '-' unary | primary */
+Evaluator::Operand Evaluator::parseUnary() {
+	if (peek() != '-') {
+		return parsePrimary();
+	}
+
+	++m_pos;
+	Operand operand = parseUnary();
+
+	return emit(Op::Negate, operand, Operand{Operand::Kind::Immediate, 0, 0});
+}
+
+/* primary = number | name | '(' expression ')' */
+Evaluator::Operand Evaluator::parsePrimary() {
+	char c = peek();
+
+	if (c == '(') {
+		++m_pos;
+		Operand inner = parseExpression();
+		if (peek() != ')') {
+			throw error("Expected ')'");
+		}
+		++m_pos;
+
+		return inner;
+	}
+
+	if (std::isdigit(static_cast<unsigned char>(c))) {
+		size_t start = m_pos;
+		while (m_pos < m_line->size() && std::isdigit(static_cast<unsigned char>((*m_line)[m_pos]))) {
+			++m_pos;
+		}
+
+		std::string digits = m_line->substr(start, m_pos - start);
+		if (digits.size() <= IMMEDIATE_DIGITS) {
+			return Operand{Operand::Kind::Immediate, 0, std::stoll(digits)};
+		}
+
+		return constant(digits, BigInt(digits));
+	}
+
+	if (isNameStart(c)) {
+		return Operand{Operand::Kind::Variable, slotOf(readName()), 0};
+	}
+
+	if (!c) {
+		throw error("Unexpected end of expression");
+	}
+
+	throw error(std::string("Unexpected '") + c + "'");
+}
+
+/* Skips whitespace and returns the next character
+ * Returns 0 at the end of the line or at a comment */
+char Evaluator::peek() {
+	std::string const &line = *m_line;
+	while (m_pos < line.size() && std::isspace(static_cast<unsigned char>(line[m_pos]))) {
+		++m_pos;
+	}
+
+	if (m_pos == line.size() || line[m_pos] == '#') {
+		return 0;
+	}
+
+	return line[m_pos];
+}
+
+/* Reads an identifier starting at the current position */
+std::string Evaluator::readName() {
+	size_t start = m_pos;
+	while (m_pos < m_line->size() && isNameChar((*m_line)[m_pos])) {
+		++m_pos;
+	}
+
+	return m_line->substr(start, m_pos - start);
+}
+
+/* Returns the slot of a variable, creating it as 0 if new */
+size_t Evaluator::slotOf(std::string const &name) {
+	auto found = m_slots.find(name);
+	if (found != m_slots.end()) {
+		return found->second;
+	}
+
+	m_slots.emplace(name, m_variables.size());
+	m_variables.emplace_back();
+
+	return m_variables.size() - 1;
+}
+
+/* Appends an instruction unless an identical one is already in the plan
+ * Operands are first put in a canonical order so a + b and b + a share an instruction */
+Evaluator::Operand Evaluator::emit(Op op, Operand lhs, Operand rhs) {
+	bool lhsImmediate = lhs.kind == Operand::Kind::Immediate;
+	bool rhsImmediate = rhs.kind == Operand::Kind::Immediate;
+
+	switch (op) {
+	case Op::Negate:
+		if (lhsImmediate) { // literals are at most 18 digits, so this can't overflow
+			return Operand{Operand::Kind::Immediate, 0, -lhs.immediate};
+		}
+		break;
+	case Op::Add:
+	case Op::Multiply:
+		// Keep an immediate on the right, where BigInt's member overloads take it
+		if (lhsImmediate && rhsImmediate) {
+			lhs = materialize(lhs);
+		}
+		else if (lhsImmediate || (!rhsImmediate && (lhs.kind > rhs.kind || (lhs.kind == rhs.kind && lhs.index > rhs.index)))) {
+			std::swap(lhs, rhs);
+		}
+		break;
+	case Op::Power:
+		if (lhsImmediate) {
+			lhs = materialize(lhs);
+		}
+		break;
+	default:
+		if (lhsImmediate && rhsImmediate) {
+			lhs = materialize(lhs);
+		}
+		break;
+	}
+
+	Instruction instruction{op, lhs, rhs};
+	auto found = m_emitted.find(instruction);
+	if (found != m_emitted.end()) {
+		++m_reusedCount;
+		return Operand{Operand::Kind::Register, found->second, 0};
+	}
+
+	m_plan.push_back(instruction);
+	if (m_registers.size() < m_plan.size()) {
+		m_registers.resize(m_plan.size());
+	}
+	m_emitted.emplace(instruction, m_plan.size() - 1);
+
+	return Operand{Operand::Kind::Register, m_plan.size() - 1, 0};
+}
+
+/* Returns a register operand holding value
+ * Constants are written into their register while compiling, so running them is free */
+Evaluator::Operand Evaluator::constant(std::string const &digits, BigInt const &value) {
+	auto found = m_constants.find(digits);
+	if (found != m_constants.end()) {
+		++m_reusedCount;
+		return Operand{Operand::Kind::Register, found->second, 0};
+	}
+
+	Operand unused{Operand::Kind::Immediate, 0, 0};
+	m_plan.push_back(Instruction{Op::Constant, unused, unused});
+	if (m_registers.size() < m_plan.size()) {
+		m_registers.resize(m_plan.size());
+	}
+	m_registers[m_plan.size() - 1] = value;
+	m_constants.emplace(digits, m_plan.size() - 1);
+
+	return Operand{Operand::Kind::Register, m_plan.size() - 1, 0};
+}
+
+/* Moves an immediate into a register so it can be used where a BigInt is needed */
+Evaluator::Operand Evaluator::materialize(Operand operand) {
+	if (operand.kind != Operand::Kind::Immediate) {
+		return operand;
+	}
+
+	return constant(std::to_string(operand.immediate), BigInt(operand.immediate));
+}
+
+/* Runs the plan
+ * Each instruction only reads registers written before it, and variables,
+ * which can't change until the line has finished */
+void Evaluator::run() {
+	m_instructionCount += m_plan.size();
+
+	for (size_t i = 0; i < m_plan.size(); ++i) {
+		Instruction const &instruction = m_plan[i];
+		Operand const &lhs = instruction.lhs;
+		Operand const &rhs = instruction.rhs;
+		BigInt &out = m_registers[i];
+
+		switch (instruction.op) {
+		case Op::Constant:
+			break;
+		case Op::Negate:
+			out = 0 - valueOf(lhs);
+			break;
+		case Op::Power: {
+			unsigned long long exponent;
+			if (rhs.kind == Operand::Kind::Immediate) {
+				if (rhs.immediate < 0) {
+					throw std::invalid_argument("Exponent must not be negative");
+				}
+				exponent = static_cast<unsigned long long>(rhs.immediate);
+			}
+			else {
+				BigInt const &value = valueOf(rhs);
+				if (value.sign() < 0 || !value.fitsIn<unsigned long long>()) {
+					throw std::invalid_argument("Exponent must be a non-negative 64 bit integer: " + value.toString());
+				}
+				exponent = value.toULongLong();
+			}
+
+			out = pow(valueOf(lhs), exponent);
+			break;
+		}
+		default:
+			if (rhs.kind == Operand::Kind::Immediate) {
+				out = apply(instruction.op, valueOf(lhs), rhs.immediate);
+			}
+			else if (lhs.kind == Operand::Kind::Immediate) {
+				out = apply(instruction.op, lhs.immediate, valueOf(rhs));
+			}
+			else {
+				out = apply(instruction.op, valueOf(lhs), valueOf(rhs));
+			}
+			break;
+		}
+	}
+}
+
+/* Returns the BigInt an operand refers to. Not for immediates */
+BigInt const &Evaluator::valueOf(Operand const &operand) const {
+	return operand.kind == Operand::Kind::Variable ? m_variables[operand.index] : m_registers[operand.index];
+}
+
+/* Applies a binary operator
+ * L and R are BigInt or long long, so overload resolution picks the native kernels */
+template<class L, class R>
+BigInt Evaluator::apply(Op op, L const &lhs, R const &rhs) {
+	switch (op) {
+	case Op::Add: return lhs + rhs;
+	case Op::Subtract: return lhs - rhs;
+	case Op::Multiply: return lhs * rhs;
+	case Op::Divide: return lhs / rhs;
+	case Op::Modulo: return lhs % rhs;
+	default: throw std::invalid_argument("Not a binary operator");
+	}
+}
+
+/* Returns an error describing a problem at the current position */
+std::invalid_argument Evaluator::error(std::string const &message) const {
+	return std::invalid_argument("column " + std::to_string(m_pos + 1) + ": " + message);
+}
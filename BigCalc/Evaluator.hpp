@@ -0,0 +1,118 @@
+/* Evaluator
+ * Compiles and runs bc style BigInt expressions, one line at a time
+ *
+ * A line is either an expression, whose value is the result, or an
+ * assignment "name = expression". Operators from lowest to highest precedence:
+ *   + -        left associative
+ *   * / %      left associative, truncating toward zero as BigInt does
+ *   ^          right associative, the exponent must be a non-negative integer
+ *   - (unary)  so -2^2 is 4, as in bc
+ * Variables which were never assigned are 0, as in bc. Blank lines and
+ * anything after a # are ignored.
+ *
+ * Each line is compiled into a plan: a list of instructions in evaluation
+ * order, each writing one register. Instructions are hash-consed as they are
+ * emitted, so a subexpression that appears more than once is evaluated once.
+ * Constants which fit a long long become immediate operands and run through
+ * BigInt's native integer overloads. Plan, registers and tables are kept
+ * between lines, so a long run settles into reusing their storage */
+
+#pragma once
+#include <string>
+#include <stdexcept> /* std::invalid_argument */
+#include <vector> /* std::vector */
+#include <unordered_map> /* std::unordered_map */
+#include "../BigInt/BigInt.hpp"
+
+class Evaluator {
+public:
+/* Constructors */
+	Evaluator();
+
+/* Function members */
+	// Compiles and runs one line
+	// Returns the result of an expression, or nullptr for an assignment or a blank line.
+	// The result stays valid until the next call
+	// Throws std::invalid_argument on syntax errors, division by zero or a bad exponent
+	BigInt const *execute(std::string const &line);
+
+	// Instructions run over every line so far
+	unsigned long long instructionCount() const;
+	// Instructions skipped because an identical one was already in the plan
+	unsigned long long reusedCount() const;
+
+private:
+	enum class Op { Constant, Negate, Add, Subtract, Multiply, Divide, Modulo, Power };
+
+	// Where an instruction reads a value from
+	struct Operand {
+		enum class Kind { Register, Variable, Immediate } kind;
+		size_t index; // register or variable slot
+		long long immediate;
+
+		bool operator==(Operand const &other) const;
+	};
+
+	struct Instruction {
+		Op op;
+		Operand lhs;
+		Operand rhs; // unused by Constant and Negate
+
+		bool operator==(Instruction const &other) const;
+	};
+
+	struct InstructionHash {
+		size_t operator()(Instruction const &instruction) const;
+	};
+
+	// Plan of the current line, and the register each instruction writes
+	std::vector<Instruction> m_plan;
+	std::vector<BigInt> m_registers;
+	// Hash-consing tables, cleared for each line
+	std::unordered_map<Instruction, size_t, InstructionHash> m_emitted;
+	std::unordered_map<std::string, size_t> m_constants;
+
+	std::unordered_map<std::string, size_t> m_slots;
+	std::vector<BigInt> m_variables;
+	// Holds the result when it is an immediate
+	BigInt m_immediateResult;
+
+	// Parser state
+	std::string const *m_line;
+	size_t m_pos;
+
+	unsigned long long m_instructionCount;
+	unsigned long long m_reusedCount;
+
+	// Recursive descent, one function per precedence level
+	Operand parseExpression();
+	Operand parseTerm();
+	Operand parseFactor();
+	Operand parseUnary();
+	Operand parsePrimary();
+
+	// Skips whitespace and returns the next character, or 0 at the end of the statement
+	char peek();
+	// Reads an identifier starting at the current position
+	std::string readName();
+	// Returns the slot of a variable, creating it as 0 if new
+	size_t slotOf(std::string const &name);
+
+	// Appends an instruction unless an identical one is already in the plan
+	Operand emit(Op op, Operand lhs, Operand rhs);
+	// Returns a register operand holding value
+	Operand constant(std::string const &digits, BigInt const &value);
+	// Moves an immediate into a register so it can be used where a BigInt is needed
+	Operand materialize(Operand operand);
+
+	// Runs the plan
+	void run();
+	// Returns the BigInt an operand refers to. Not for immediates
+	BigInt const &valueOf(Operand const &operand) const;
+	// Applies a binary operator, picking BigInt's native overloads for long long operands
+	template<class L, class R>
+	static BigInt apply(Op op, L const &lhs, R const &rhs);
+
+	// Returns an error describing a problem at the current position
+	std::invalid_argument error(std::string const &message) const;
+};
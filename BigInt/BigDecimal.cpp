@@ -0,0 +1,418 @@
+#include "BigDecimal.hpp"
+#include <stdexcept> /* std::invalid_argument */
+#include <algorithm> /* std::max */
+#include <climits> /* INT_MAX, INT_MIN */
+
+// -------------- Helpers
+namespace {
+	/* Decides whether a quotient truncated toward zero moves one unit away from zero
+	 * half compares the discarded part to one half of a unit (-1, 0, 1) */
+	bool roundsAway(RoundingMode mode, bool negative, bool odd, short half, bool inexact) {
+		if (!inexact) {
+			return false;
+		}
+
+		switch (mode) {
+		case RoundingMode::Up: return true;
+		case RoundingMode::Down: return false;
+		case RoundingMode::Ceiling: return !negative;
+		case RoundingMode::Floor: return negative;
+		case RoundingMode::HalfUp: return half >= 0;
+		case RoundingMode::HalfDown: return half > 0;
+		case RoundingMode::HalfEven: return half > 0 || (half == 0 && odd);
+		case RoundingMode::Unnecessary: break;
+		}
+
+		throw std::invalid_argument("Rounding necessary");
+	}
+
+	/* Checks a scale computed in wider arithmetic still fits an int */
+	int checkedScale(long long scale) {
+		if (scale > INT_MAX || scale < INT_MIN) {
+			throw std::invalid_argument("Scale out of range");
+		}
+
+		return static_cast<int>(scale);
+	}
+}
+
+// -------------- Public
+const int BigDecimal::DIVISION_SCALE;
+
+/* Default constructor
+ * Sets value to 0 with a scale of 0 */
+BigDecimal::BigDecimal() : m_scale(0) {}
+
+/* Constructor with unscaled value and scale */
+BigDecimal::BigDecimal(BigInt const &unscaled, int scale) : m_unscaled(unscaled), m_scale(scale) {}
+
+/* Constructor with long long param */
+BigDecimal::BigDecimal(long long value) : m_unscaled(value), m_scale(0) {}
+
+/* Constructor with string param such as "-12.345" or "1.5e-3"
+ * Throws std::invalid_argument if string invalid value */
+BigDecimal::BigDecimal(std::string const &s) {
+	size_t idx = 0;
+	size_t len = s.size();
+	std::string digits;
+
+	if (idx < len && (s[idx] == '-' || s[idx] == '+')) {
+		if (s[idx] == '-') {
+			digits.push_back('-');
+		}
+		++idx;
+	}
+
+	// Integer part, then fraction part
+	size_t integerDigits = 0;
+	for (; idx < len && s[idx] >= '0' && s[idx] <= '9'; ++idx, ++integerDigits) {
+		digits.push_back(s[idx]);
+	}
+
+	long long fractionDigits = 0;
+	if (idx < len && s[idx] == '.') {
+		for (++idx; idx < len && s[idx] >= '0' && s[idx] <= '9'; ++idx, ++fractionDigits) {
+			digits.push_back(s[idx]);
+		}
+	}
+
+	if (!integerDigits && !fractionDigits) {
+		throw std::invalid_argument(std::string("Value must be decimal: ") + s);
+	}
+
+	// Optional exponent
+	long long exponent = 0;
+	if (idx < len && (s[idx] == 'e' || s[idx] == 'E')) {
+		bool negative = false;
+		if (++idx < len && (s[idx] == '-' || s[idx] == '+')) {
+			negative = s[idx++] == '-';
+		}
+
+		if (idx == len) {
+			throw std::invalid_argument(std::string("Value must be decimal: ") + s);
+		}
+
+		for (; idx < len && s[idx] >= '0' && s[idx] <= '9'; ++idx) {
+			exponent = exponent * 10 + (s[idx] - '0');
+			if (exponent > INT_MAX) {
+				throw std::invalid_argument(std::string("Exponent out of range: ") + s);
+			}
+		}
+
+		if (negative) {
+			exponent = -exponent;
+		}
+	}
+
+	if (idx != len) {
+		throw std::invalid_argument(std::string("Value must be decimal: ") + s);
+	}
+
+	m_unscaled = BigInt(digits);
+	m_scale = checkedScale(fractionDigits - exponent);
+}
+
+/* Checks if two values are equal */
+bool BigDecimal::operator==(BigDecimal const &other) const {
+	return compare(other) == 0;
+}
+
+/* Checks if two values are not equal */
+bool BigDecimal::operator!=(BigDecimal const &other) const {
+	return compare(other) != 0;
+}
+
+/* Checks if one value is less than the other */
+bool BigDecimal::operator<(BigDecimal const &other) const {
+	return compare(other) == -1;
+}
+
+/* Checks if one value is greater than the other */
+bool BigDecimal::operator>(BigDecimal const &other) const {
+	return compare(other) == 1;
+}
+
+/* Checks if one value is less than or equal to the other */
+bool BigDecimal::operator<=(BigDecimal const &other) const {
+	return compare(other) != 1;
+}
+
+/* Checks if one value is greater than or equal to the other */
+bool BigDecimal::operator>=(BigDecimal const &other) const {
+	return compare(other) != -1;
+}
+
+/* Adds two values, aligned to the larger scale */
+BigDecimal BigDecimal::operator+(BigDecimal const &other) const {
+	if (m_scale == other.m_scale) {
+		return BigDecimal(m_unscaled + other.m_unscaled, m_scale);
+	}
+
+	int scale = std::max(m_scale, other.m_scale);
+	return BigDecimal(alignedTo(scale) + other.alignedTo(scale), scale);
+}
+
+/* Negates the value
+ * Zero is left as it is, so it never prints as -0 */
+BigDecimal BigDecimal::operator-() const {
+	if (!m_unscaled.sign()) {
+		return *this;
+	}
+
+	return BigDecimal(-m_unscaled, m_scale);
+}
+
+/* Subtracts other from this */
+BigDecimal BigDecimal::operator-(BigDecimal const &other) const {
+	return *this + -other;
+}
+
+/* Multiplies two values, the scales add */
+BigDecimal BigDecimal::operator*(BigDecimal const &other) const {
+	return BigDecimal(m_unscaled * other.m_unscaled, checkedScale(static_cast<long long>(m_scale) + other.m_scale));
+}
+
+/* Divides this by other
+ * The quotient takes the larger of both scales and DIVISION_SCALE, rounding HalfEven */
+BigDecimal BigDecimal::operator/(BigDecimal const &other) const {
+	return divide(other, std::max(std::max(m_scale, other.m_scale), DIVISION_SCALE));
+}
+
+/* Addition assignment */
+BigDecimal &BigDecimal::operator+=(BigDecimal const &other) {
+	return *this = *this + other;
+}
+
+/* Subtraction assignment */
+BigDecimal &BigDecimal::operator-=(BigDecimal const &other) {
+	return *this = *this - other;
+}
+
+/* Multiplication assignment */
+BigDecimal &BigDecimal::operator*=(BigDecimal const &other) {
+	return *this = *this * other;
+}
+
+/* Division assignment */
+BigDecimal &BigDecimal::operator/=(BigDecimal const &other) {
+	return *this = *this / other;
+}
+
+/* Divides by other, rounding the result to the given scale
+ * a / 10^sa divided by b / 10^sb at scale s is a * 10^(s + sb - sa) / b
+ * Throws std::invalid_argument on division by zero */
+BigDecimal BigDecimal::divide(BigDecimal const &other, int scale, RoundingMode mode) const {
+	if (!other.m_unscaled.sign()) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	BigInt numerator(m_unscaled);
+	BigInt denominator(other.m_unscaled);
+	long long shift = static_cast<long long>(scale) + other.m_scale - m_scale;
+
+	if (shift >= 0) {
+		numerator.shiftDigits(shift);
+	}
+	else {
+		denominator.shiftDigits(-shift);
+	}
+
+	BigInt quotient, remainder;
+	BigInt::divMod(numerator, denominator, quotient, remainder);
+
+	// Compare twice the remainder against the divisor to place it around one half
+	BigInt twice = remainder + remainder;
+	if (twice.sign() < 0) {
+		twice = -twice;
+	}
+	if (denominator.sign() < 0) {
+		denominator = -denominator;
+	}
+
+	bool negative = numerator.sign() != other.m_unscaled.sign();
+	if (roundsAway(mode, negative, quotient.digitAt(0) & 1, twice.compare(denominator), remainder.sign() != 0)) {
+		quotient += BigInt(negative ? -1 : 1);
+	}
+
+	return BigDecimal(quotient, scale);
+}
+
+/* Returns this value with the given scale, rounding if digits are discarded
+ * Discarded digits are inspected directly rather than through a division */
+BigDecimal BigDecimal::setScale(int scale, RoundingMode mode) const {
+	if (scale >= m_scale) {
+		return BigDecimal(alignedTo(scale), scale);
+	}
+
+	size_t drop = static_cast<size_t>(static_cast<long long>(m_scale) - scale);
+	BigInt quotient(m_unscaled);
+	quotient.shiftDigits(-static_cast<long long>(drop));
+
+	// The first discarded digit decides the half, the rest only whether it is exact
+	short first = m_unscaled.digitAt(drop - 1);
+	bool sticky = false;
+	size_t end = std::min(drop - 1, m_unscaled.digitCount());
+	for (size_t i = 0; i < end && !sticky; ++i) {
+		sticky = m_unscaled.digitAt(i) != 0;
+	}
+
+	short half = first > 5 ? 1 : first < 5 ? -1 : sticky ? 1 : 0;
+	bool negative = m_unscaled.sign() < 0;
+	if (roundsAway(mode, negative, quotient.digitAt(0) & 1, half, first || sticky)) {
+		quotient += BigInt(negative ? -1 : 1);
+	}
+
+	return BigDecimal(quotient, scale);
+}
+
+/* Returns this value rounded to the given number of significant digits
+ * A precision of 0 leaves the value unchanged */
+BigDecimal BigDecimal::round(size_t precision, RoundingMode mode) const {
+	size_t digits = m_unscaled.digitCount();
+	if (!precision || digits <= precision) {
+		return *this;
+	}
+
+	BigDecimal result = setScale(checkedScale(static_cast<long long>(m_scale) - (digits - precision)), mode);
+
+	// Rounding up may carry into a new digit (999 to 1000), which is always a trailing zero
+	if (result.precision() > precision) {
+		result.m_unscaled.shiftDigits(-1);
+		result.m_scale = checkedScale(static_cast<long long>(result.m_scale) - 1);
+	}
+
+	return result;
+}
+
+/* Returns this value with trailing zeros removed from the unscaled value */
+BigDecimal BigDecimal::stripTrailingZeros() const {
+	if (!m_unscaled.sign()) {
+		return BigDecimal();
+	}
+
+	size_t zeros = 0;
+	while (!m_unscaled.digitAt(zeros)) {
+		++zeros;
+	}
+
+	BigInt unscaled(m_unscaled);
+	unscaled.shiftDigits(-static_cast<long long>(zeros));
+
+	return BigDecimal(unscaled, checkedScale(static_cast<long long>(m_scale) - zeros));
+}
+
+/* Returns the unscaled value */
+BigInt const &BigDecimal::unscaledValue() const {
+	return m_unscaled;
+}
+
+/* Returns the scale */
+int BigDecimal::scale() const {
+	return m_scale;
+}
+
+/* Returns the number of significant digits in the unscaled value */
+size_t BigDecimal::precision() const {
+	return m_unscaled.digitCount();
+}
+
+/* Returns -1 if negative, 0 if zero and 1 if positive */
+short BigDecimal::sign() const {
+	return m_unscaled.sign();
+}
+
+/* Returns the value in plain notation, such as "-0.00120" */
+std::string BigDecimal::toString() const {
+	std::string digits = m_unscaled.toString();
+	std::string sign;
+	if (digits[0] == '-') {
+		sign = "-";
+		digits.erase(0, 1);
+	}
+
+	if (m_scale <= 0) {
+		if (m_unscaled.sign()) {
+			digits.append(static_cast<size_t>(-static_cast<long long>(m_scale)), '0');
+		}
+		return sign + digits;
+	}
+
+	size_t scale = static_cast<size_t>(m_scale);
+	if (digits.size() > scale) {
+		digits.insert(digits.size() - scale, 1, '.');
+		return sign + digits;
+	}
+
+	return sign + "0." + std::string(scale - digits.size(), '0') + digits;
+}
+
+/* Compares value to other value
+ * The position of the most significant digit settles most comparisons
+ * before any scale alignment is needed
+ *
+ * @return       -1 if this is less than other
+ *                0 if this is equal to other
+ *                1 if this is greater than other */
+short BigDecimal::compare(BigDecimal const &other) const {
+	short sign = m_unscaled.sign();
+	short otherSign = other.m_unscaled.sign();
+
+	if (sign != otherSign) {
+		return sign < otherSign ? -1 : 1;
+	}
+
+	if (!sign) {
+		return 0;
+	}
+
+	if (m_scale == other.m_scale) {
+		return m_unscaled.compare(other.m_unscaled);
+	}
+
+	// Compare the place of the leading digit (digits - scale)
+	long long magnitude = static_cast<long long>(m_unscaled.digitCount()) - m_scale;
+	long long otherMagnitude = static_cast<long long>(other.m_unscaled.digitCount()) - other.m_scale;
+	if (magnitude != otherMagnitude) {
+		return magnitude > otherMagnitude ? sign : -sign;
+	}
+
+	int scale = std::max(m_scale, other.m_scale);
+	return alignedTo(scale).compare(other.alignedTo(scale));
+}
+
+// -------------- Friend
+/* Insertion operator
+ * Outputs value in plain notation */
+std::ostream &operator<<(std::ostream &out, BigDecimal const &d) {
+	out << d.toString();
+
+	return out;
+}
+
+/* Extraction operator
+ * If invalid input, istream set to fail and value set to 0
+ * else sets value to input */
+std::istream &operator>>(std::istream &in, BigDecimal &d) {
+	std::string s;
+	in >> s;
+
+	try {
+		d = BigDecimal(s);
+	}
+	catch (std::invalid_argument &) {
+		d = BigDecimal();
+		in.setstate(std::ios_base::badbit);
+	}
+
+	return in;
+}
+
+// -------------- Private
+/* Returns the unscaled value brought up to a larger scale
+ * Scaling by a power of ten is a digit shift in BigInt's decimal storage */
+BigInt BigDecimal::alignedTo(int scale) const {
+	BigInt aligned(m_unscaled);
+	aligned.shiftDigits(static_cast<long long>(scale) - m_scale);
+
+	return aligned;
+}
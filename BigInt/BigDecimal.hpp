@@ -0,0 +1,104 @@
+/* BigDecimal
+ * An exact decimal value made of a BigInt unscaled value and a scale
+ * The value is unscaled * 10^-scale, so 12.345 is 12345 with a scale of 3 */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include "BigInt.hpp"
+
+// How a result is rounded when digits must be discarded
+enum class RoundingMode {
+	Up, // Away from zero
+	Down, // Toward zero
+	Ceiling, // Toward positive infinity
+	Floor, // Toward negative infinity
+	HalfUp, // To nearest, ties away from zero
+	HalfDown, // To nearest, ties toward zero
+	HalfEven, // To nearest, ties to the even neighbour
+	Unnecessary // Throws std::invalid_argument if rounding would be needed
+};
+
+class BigDecimal {
+public:
+/* Constructors */
+	// Default constructor
+	// Sets value to 0 with a scale of 0
+	BigDecimal();
+	// Constructor with unscaled value and scale
+	BigDecimal(BigInt const &unscaled, int scale = 0);
+	// Constructor with long long param
+	BigDecimal(long long);
+	// Constructor with string param such as "-12.345" or "1.5e-3"
+	// Throws std::invalid_argument if string invalid value
+	BigDecimal(std::string const &);
+
+/* Comparative operators */
+	// Compares values, so 1.0 equals 1.00
+	bool operator==(BigDecimal const &) const;
+	bool operator!=(BigDecimal const &) const;
+	bool operator<(BigDecimal const &) const;
+	bool operator>(BigDecimal const &) const;
+	bool operator<=(BigDecimal const &) const;
+	bool operator>=(BigDecimal const &) const;
+
+/* Arithmatic operators */
+	// Sums take the larger scale of the operands
+	BigDecimal operator+(BigDecimal const &) const;
+	BigDecimal operator-() const;
+	BigDecimal operator-(BigDecimal const &) const;
+	// Products take the sum of the scales of the operands
+	BigDecimal operator*(BigDecimal const &) const;
+	// Quotients take the larger of both scales and DIVISION_SCALE, rounding HalfEven
+	// Throws std::invalid_argument on division by zero
+	BigDecimal operator/(BigDecimal const &) const;
+
+/* Assignment operators */
+	BigDecimal &operator+=(BigDecimal const &);
+	BigDecimal &operator-=(BigDecimal const &);
+	BigDecimal &operator*=(BigDecimal const &);
+	BigDecimal &operator/=(BigDecimal const &);
+
+/* ios operators */
+	friend std::ostream &operator<<(std::ostream &os, BigDecimal const &d);
+	friend std::istream &operator>>(std::istream &is, BigDecimal &d);
+
+/* Function members */
+	// Divides by other, rounding the result to the given scale
+	// Throws std::invalid_argument on division by zero
+	BigDecimal divide(BigDecimal const &other, int scale, RoundingMode mode = RoundingMode::HalfEven) const;
+
+	// Returns this value with the given scale, rounding if digits are discarded
+	BigDecimal setScale(int scale, RoundingMode mode = RoundingMode::HalfEven) const;
+	// Returns this value rounded to the given number of significant digits
+	BigDecimal round(size_t precision, RoundingMode mode = RoundingMode::HalfEven) const;
+	// Returns this value with trailing zeros removed from the unscaled value
+	BigDecimal stripTrailingZeros() const;
+
+	BigInt const &unscaledValue() const;
+	int scale() const;
+	// Returns the number of significant digits in the unscaled value
+	size_t precision() const;
+	// Returns -1 if negative, 0 if zero and 1 if positive
+	short sign() const;
+
+	// Returns the value in plain notation, such as "-0.00120"
+	std::string toString() const;
+
+	// Compares value to other value
+	//
+	// -1 if this is less than other
+	//  0 if this is equal to other
+	//  1 if this is greater than other
+	short compare(BigDecimal const &) const;
+
+	// Minimum scale of quotients from operator/
+	static const int DIVISION_SCALE = 32;
+
+private:
+	BigInt m_unscaled;
+	int m_scale;
+
+	// Returns the unscaled value brought up to a larger scale
+	BigInt alignedTo(int scale) const;
+};
@@ -1,6 +1,55 @@
 #include "BigInt.hpp"
-#include <stdexcept> /* std::invalid_argument */
-#include <sstream> /* stringstream */
+#include <stdexcept> /* std::invalid_argument, std::out_of_range, std::length_error */
+#include <cmath> /* std::frexp, std::ldexp, std::trunc, HUGE_VAL */
+#include <climits> /* SIZE_MAX, LLONG_MAX */
+#include <cfloat> /* DBL_MAX_EXP */
+#include "BigIntStats.hpp" /* BIGINT_RECORD, BIGINT_SCOPE, BigIntAllocator */
+#include <vector> /* std::vector */
+
+// Scratch buffer, counted when BIGINT_STATS is defined
+template <class T>
+using Buffer = std::vector<T, BigIntAllocator<T>>;
+
+// Operand length (in digits) at which multiplication switches from
+// schoolbook to Karatsuba
+static const size_t KARATSUBA_THRESHOLD = 48;
+
+// Longest operand (in digits) the Karatsuba column sums are safe for.
+// Halves are added without carrying, so at depth d every digit can reach
+// 9 * 2^d and a column about 7 * n^2 for n digit operands; long long holds
+// that up to roughly 10^9 digits, and this keeps a wide margin below it
+static const size_t KARATSUBA_MAX_DIGITS = 500000000;
+
+// Limb count at which limb multiplication switches from schoolbook to Karatsuba
+static const size_t LIMB_KARATSUBA_THRESHOLD = 32;
+
+// Limb count at or below which conversion between bases runs Horner's rule
+// instead of splitting the value in halves
+static const size_t CONVERSION_THRESHOLD = 64;
+
+// Bases of the limbs that decimal and binary conversions go through
+static const unsigned long long DECIMAL_LIMB = 1000000000;
+static const unsigned long long BINARY_LIMB = 1ULL << 32;
+
+/* Returns the bits per digit of a power of two radix
+ * Throws std::invalid_argument if radix is neither that nor 10 */
+static unsigned bitsPerDigit(unsigned radix) {
+	switch (radix) {
+	case 2: return 1;
+	case 4: return 2;
+	case 8: return 3;
+	case 16: return 4;
+	case 32: return 5;
+	}
+
+	throw std::invalid_argument(std::string("Unsupported radix: ") + std::to_string(radix));
+}
+
+/* Returns the magnitude of a native value
+ * Negates as unsigned so the minimum value doesn't overflow */
+static unsigned long long magnitudeOf(long long value) {
+	return value < 0 ? 0ULL - static_cast<unsigned long long>(value) : value;
+}
 
 // -------------- Public
 /* Default constructor
@@ -20,29 +69,257 @@ BigInt::BigInt(std::string const &s) {
  * Range of -9,223,372,036,854,775,807
  * to 9,223,372,036,854,775,807 */
 BigInt::BigInt(long long value) {
-	// Use string stream to convert value to string
-	// No need to mess with looping arithmatic
-	std::stringstream ss;
-	ss << value;
+	m_isNegative = value < 0;
 
-	setValue(ss.str(), true);
+	setMagnitude(magnitudeOf(value));
 }
 
-/* Returns the BigInt value as a string */
-std::string BigInt::toString() const {
-	std::stringstream s;
-	if (m_isNegative) {
-		s << '-';
+/* Constructs a BigInt from an unsigned long long */
+BigInt BigInt::fromULongLong(unsigned long long value) {
+	BigInt buffer;
+	buffer.setMagnitude(value);
+
+	return buffer;
+}
+
+#ifdef __SIZEOF_INT128__
+/* Constructs a BigInt from a 128 bit integer */
+BigInt BigInt::fromInt128(__int128 value) {
+	BigInt buffer;
+	buffer.m_value.clear();
+	buffer.m_isNegative = value < 0;
+
+	unsigned __int128 magnitude = buffer.m_isNegative ? 0 - static_cast<unsigned __int128>(value) : value;
+	do {
+		buffer.m_value.push(static_cast<char>(magnitude % 10));
+		magnitude /= 10;
+	} while (magnitude);
+
+	return buffer;
+}
+#endif
+
+/* Constructs a BigInt from a double, truncating toward zero
+ * Throws std::invalid_argument if value is NaN or infinite */
+BigInt BigInt::fromDouble(double value) {
+	if (!std::isfinite(value)) {
+		throw std::invalid_argument("Value must be finite");
+	}
+
+	value = std::trunc(value);
+	if (std::fabs(value) < 9223372036854775808.0) { // 2^63
+		return BigInt(static_cast<long long>(value));
+	}
+
+	// Split into a 53 bit integer mantissa and a binary exponent (at least 11 here)
+	// then place the mantissa bits directly into binary limbs
+	int exponent;
+	double fraction = std::frexp(std::fabs(value), &exponent);
+	unsigned long long mantissa = static_cast<unsigned long long>(std::ldexp(fraction, 53));
+	unsigned shift = exponent - 53;
+
+	Limbs limbs(shift / 32 + 3, 0);
+	unsigned offset = shift % 32;
+	size_t idx = shift / 32;
+	limbs[idx] = static_cast<uint32_t>(mantissa << offset);
+	limbs[idx + 1] = static_cast<uint32_t>(mantissa >> (32 - offset));
+	limbs[idx + 2] = offset ? static_cast<uint32_t>(mantissa >> (64 - offset)) : 0;
+
+	BigInt buffer;
+	buffer.setFromBinaryLimbs(std::move(limbs), value < 0);
+
+	return buffer;
+}
+
+/* Parses a string in the given radix (10, or a power of two up to 32)
+ * Throws std::invalid_argument if radix or string is invalid */
+BigInt BigInt::fromString(std::string const &s, unsigned radix) {
+	size_t start = s.size() && s[0] == '-' ? 1 : 0;
+	if (start == s.size()) {
+		throw std::invalid_argument(std::string("Value must not be empty: ") + s);
+	}
+
+	if (radix == 10) {
+		return BigInt(s);
+	}
+
+	unsigned bits = bitsPerDigit(radix);
+	Limbs limbs((s.size() * bits) / 32 + 1, 0);
+
+	// Loop backwards so each digit's bits land at increasing positions
+	size_t bit = 0;
+	for (size_t idx = s.size(); idx-- > start; bit += bits) {
+		char c = s[idx];
+		unsigned digit;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		}
+		else if (c >= 'a' && c <= 'z') {
+			digit = c - 'a' + 10;
+		}
+		else if (c >= 'A' && c <= 'Z') {
+			digit = c - 'A' + 10;
+		}
+		else {
+			digit = radix;
+		}
+
+		if (digit >= radix) {
+			throw std::invalid_argument(std::string("Value must be in radix ") + std::to_string(radix) + ": " + s);
+		}
+
+		limbs[bit / 32] |= static_cast<uint32_t>(digit) << (bit % 32);
+		if (bit % 32 + bits > 32) {
+			limbs[bit / 32 + 1] |= digit >> (32 - bit % 32);
+		}
+	}
+
+	BigInt buffer;
+	buffer.setFromBinaryLimbs(std::move(limbs), start == 1);
+
+	return buffer;
+}
+
+/* Converts to unsigned long long
+ * Throws std::out_of_range if the value does not fit */
+unsigned long long BigInt::toULongLong() const {
+	if (!fitsIn<unsigned long long>()) {
+		throw std::out_of_range(std::string("Value does not fit unsigned long long: ") + toString());
+	}
+
+	return nativeMagnitude();
+}
+
+#ifdef __SIZEOF_INT128__
+/* Converts to a 128 bit integer
+ * Throws std::out_of_range if the value does not fit */
+__int128 BigInt::toInt128() const {
+	if (!fitsIn<__int128>()) {
+		throw std::out_of_range(std::string("Value does not fit __int128: ") + toString());
+	}
+
+	unsigned __int128 magnitude = 0;
+	for (size_t idx = m_value.size(); idx-- > 0;) {
+		magnitude = magnitude * 10 + m_value[idx];
+	}
+
+	return static_cast<__int128>(m_isNegative ? 0 - magnitude : magnitude);
+}
+#endif
+
+/* Converts to double, rounding to nearest with ties to even */
+double BigInt::toDouble() const {
+	size_t thisSize = m_value.size();
+	double value;
+
+	// Up to 19 digits fits an unsigned long long, whose conversion already rounds correctly
+	if (thisSize <= 19) {
+		unsigned long long magnitude = 0;
+		for (size_t idx = thisSize; idx-- > 0;) {
+			magnitude = magnitude * 10 + m_value[idx];
+		}
+		value = static_cast<double>(magnitude);
+	}
+	// DBL_MAX is below 10^309, so anything longer can only round to infinity
+	else if (thisSize > 309) {
+		value = HUGE_VAL;
+	}
+	else {
+		Limbs limbs;
+		toBinaryLimbs(limbs);
+
+		// Take the top 64 bits and fold every lower bit into the last one (sticky bit),
+		// so the native conversion rounds exactly as the full value would
+		size_t top = limbs.size() - 1;
+		unsigned lead = 0;
+		for (uint32_t l = limbs[top]; l; l >>= 1) {
+			++lead;
+		}
+
+		// Past DBL_MAX_EXP bits the value overflows; also keeps the exponent below in int range
+		if (top * 32 + lead > DBL_MAX_EXP) {
+			return m_isNegative ? -HUGE_VAL : HUGE_VAL;
+		}
+
+		unsigned long long window = 0;
+		bool sticky = false;
+		for (size_t i = 0; i <= top; ++i) {
+			unsigned long long limb = limbs[i];
+			size_t limbBit = i * 32; // position of limb's bit 0 counted from the bottom
+			size_t windowBit = top * 32 + lead - 64; // position of window's bit 0
+			if (limbBit + 32 <= windowBit) {
+				sticky = sticky || limb;
+			}
+			else if (limbBit < windowBit) {
+				unsigned cut = static_cast<unsigned>(windowBit - limbBit);
+				sticky = sticky || (limb & ((1ULL << cut) - 1));
+				window |= limb >> cut;
+			}
+			else {
+				window |= limb << (limbBit - windowBit);
+			}
+		}
+
+		value = std::ldexp(static_cast<double>(window | sticky), static_cast<int>(top * 32 + lead - 64));
 	}
 
-	// Loop backwards and add to string stream. 'i' is used due to using unsigned
+	return m_isNegative ? -value : value;
+}
+
+/* Returns the BigInt value as a string in the given radix
+ * Throws std::invalid_argument if radix is invalid */
+std::string BigInt::toString(unsigned radix) const {
+	BIGINT_SCOPE(BigIntOp::ToString);
+	static char const digits[] = "0123456789abcdefghijklmnopqrstuv";
 	size_t thisSize = m_value.size();
-	for (size_t i = 0, idx = thisSize - 1; i < thisSize; ++i, --idx) {
-		s << (short)m_value[idx];
+
+	if (radix == 10) {
+		std::string s;
+		s.reserve(thisSize + m_isNegative);
+		if (m_isNegative) {
+			s.push_back('-');
+		}
+
+		// Loop backwards, most significant digit first
+		for (size_t idx = thisSize; idx-- > 0;) {
+			s.push_back(digits[static_cast<int>(m_value[idx])]);
+		}
+
+		BIGINT_RECORD(BigIntOp::ToString, thisSize, thisSize);
+		return s;
+	}
+
+	unsigned bits = bitsPerDigit(radix);
+	Limbs limbs;
+	toBinaryLimbs(limbs);
+
+	// Emit digits least significant first, then reverse
+	Buffer<char> reversed;
+	size_t totalBits = limbs.size() * 32;
+	reversed.reserve(totalBits / bits + 2);
+	for (size_t bit = 0; bit < totalBits; bit += bits) {
+		size_t idx = bit / 32;
+		unsigned long long window = limbs[idx];
+		if (idx + 1 < limbs.size()) {
+			window |= static_cast<unsigned long long>(limbs[idx + 1]) << 32;
+		}
+		reversed.push_back(digits[(window >> (bit % 32)) & (radix - 1)]);
+	}
+
+	while (reversed.size() > 1 && reversed.back() == '0') {
+		reversed.pop_back();
+	}
+
+	if (reversed.empty()) {
+		reversed.push_back('0');
+	}
+
+	if (m_isNegative) {
+		reversed.push_back('-');
 	}
 
-	// Pass by ref for efficiency
-	return std::move(s.str());
+	BIGINT_RECORD(BigIntOp::ToString, thisSize, thisSize + reversed.size());
+	return std::string(reversed.rbegin(), reversed.rend());
 }
 
 /* Checks if two BigInt values are equal */
@@ -75,8 +352,39 @@ bool BigInt::operator>=(BigInt const &other) const {
 	return compare(other) != -1;
 }
 
+/* Checks if the BigInt value equals a native value */
+bool BigInt::operator==(long long value) const {
+	return compare(value) == 0;
+}
+
+/* Checks if the BigInt value does not equal a native value */
+bool BigInt::operator!=(long long value) const {
+	return compare(value) != 0;
+}
+
+/* Checks if the BigInt value is less than a native value */
+bool BigInt::operator<(long long value) const {
+	return compare(value) == -1;
+}
+
+/* Checks if the BigInt value is greater than a native value */
+bool BigInt::operator>(long long value) const {
+	return compare(value) == 1;
+}
+
+/* Checks if the BigInt value is less than or equal to a native value */
+bool BigInt::operator<=(long long value) const {
+	return compare(value) != 1;
+}
+
+/* Checks if the BigInt value is greater than or equal to a native value */
+bool BigInt::operator>=(long long value) const {
+	return compare(value) != -1;
+}
+
 /* Adds one BigInt to the other and returns the result as another BigInt */
 BigInt BigInt::operator+(BigInt const &other) const {
+	BIGINT_SCOPE(BigIntOp::Add);
 	BigInt buffer; buffer.m_value.clear();
 	size_t thisSize = m_value.size();
 	size_t otherSize = other.m_value.size();
@@ -195,13 +503,15 @@ BigInt BigInt::operator+(BigInt const &other) const {
 		buffer.trimLeadingZeros();
 	}
 
+	BIGINT_RECORD(BigIntOp::Add, thisSize > otherSize ? thisSize : otherSize, buffer.m_value.size());
+
 	return buffer;
 }
 
 /* Negates the value of the BigInt value */
 BigInt BigInt::operator-() const {
 	BigInt buffer(*this);
-	buffer.m_isNegative = !buffer.m_isNegative;
+	buffer.m_isNegative = !buffer.m_isNegative && !buffer.isZero();
 
 	return buffer;
 }
@@ -212,28 +522,166 @@ BigInt BigInt::operator-(BigInt const &other) const {
 	return *this + -other;
 }
 
+/* Multiplies this by other and returns the result as another BigInt */
+BigInt BigInt::operator*(BigInt const &other) const {
+	BIGINT_SCOPE(BigIntOp::Multiply);
+	if (&other == this) {
+		return square();
+	}
+
+	BigInt buffer;
+	if (isZero() || other.isZero()) {
+		return buffer;
+	}
+
+	size_t thisSize = m_value.size();
+	size_t otherSize = other.m_value.size();
+
+	// Widen digits so columns can be summed without carrying
+	Buffer<long long> a(m_value.begin(), m_value.end());
+	Buffer<long long> b(other.m_value.begin(), other.m_value.end());
+	Buffer<long long> columns(thisSize + otherSize - 1, 0);
+
+	multiplyDigits(a.data(), thisSize, b.data(), otherSize, columns.data());
+
+	// Single carry pass over the column sums
+	buffer.m_value = Digits(thisSize + otherSize);
+	long long carry = 0;
+	for (size_t i = 0; i < columns.size(); ++i) {
+		carry += columns[i];
+		buffer.m_value.push(carry % 10);
+		carry /= 10;
+	}
+
+	while (carry) {
+		buffer.m_value.push(carry % 10);
+		carry /= 10;
+	}
+
+	buffer.m_isNegative = m_isNegative != other.m_isNegative;
+	buffer.trimLeadingZeros();
+
+	BIGINT_RECORD(BigIntOp::Multiply, thisSize > otherSize ? thisSize : otherSize, thisSize * otherSize);
+
+	return buffer;
+}
+
+/* Returns the value squared
+ * Each cross product a[i] * a[j] is computed once and doubled */
+BigInt BigInt::square() const {
+	BIGINT_SCOPE(BigIntOp::Multiply);
+	BigInt buffer;
+	if (isZero()) {
+		return buffer;
+	}
+
+	size_t thisSize = m_value.size();
+	Buffer<long long> a(m_value.begin(), m_value.end());
+	Buffer<long long> columns(2 * thisSize - 1, 0);
+
+	squareDigits(a.data(), thisSize, columns.data());
+
+	buffer.m_value = Digits(2 * thisSize);
+	long long carry = 0;
+	for (size_t i = 0; i < columns.size(); ++i) {
+		carry += columns[i];
+		buffer.m_value.push(carry % 10);
+		carry /= 10;
+	}
+
+	while (carry) {
+		buffer.m_value.push(carry % 10);
+		carry /= 10;
+	}
+
+	buffer.trimLeadingZeros();
+
+	BIGINT_RECORD(BigIntOp::Multiply, thisSize, thisSize * (thisSize + 1) / 2);
+
+	return buffer;
+}
+
+/* Divides this by other, truncating toward zero */
+BigInt BigInt::operator/(BigInt const &other) const {
+	BigInt quotient, remainder;
+	divMod(*this, other, quotient, remainder);
+
+	return quotient;
+}
+
+/* Returns the remainder of dividing this by other */
+BigInt BigInt::operator%(BigInt const &other) const {
+	BigInt quotient, remainder;
+	divMod(*this, other, quotient, remainder);
+
+	return remainder;
+}
+
+/* Adds a native value and returns the result as another BigInt */
+BigInt BigInt::operator+(long long value) const {
+	BigInt buffer(*this);
+
+	return buffer += value;
+}
+
+/* Subtracts a native value and returns the result as another BigInt */
+BigInt BigInt::operator-(long long value) const {
+	BigInt buffer(*this);
+
+	return buffer -= value;
+}
+
+/* Multiplies by a native value and returns the result as another BigInt */
+BigInt BigInt::operator*(long long value) const {
+	BigInt buffer(*this);
+
+	return buffer *= value;
+}
+
+/* Divides by a native value, truncating toward zero
+ * Throws std::invalid_argument on division by zero */
+BigInt BigInt::operator/(long long value) const {
+	BigInt buffer(*this);
+
+	return buffer /= value;
+}
+
+/* Returns the remainder of dividing by a native value
+ * Only the remainder is built, the quotient digits are never stored */
+BigInt BigInt::operator%(long long value) const {
+	if (!value) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	BigInt buffer;
+	buffer.setMagnitude(remainderMagnitude(magnitudeOf(value)));
+	buffer.m_isNegative = m_isNegative && !buffer.isZero();
+
+	return buffer;
+}
+
 /* Pre-increment */
 BigInt &BigInt::operator++() {
-	return *this = *this + 1;
+	return *this += 1;
 }
 
 /* Post-increment */
 BigInt BigInt::operator++(int) {
 	BigInt buffer(*this);
-	*this = *this + 1;
+	*this += 1;
 
 	return buffer;
 }
 
 /* Pre-decrement */
 BigInt &BigInt::operator--() {
-	return *this = *this - 1;
+	return *this -= 1;
 }
 
 /* Post-decrement */
 BigInt BigInt::operator--(int) {
 	BigInt buffer(*this);
-	*this = *this - 1;
+	*this -= 1;
 
 	return buffer;
 }
@@ -248,53 +696,297 @@ BigInt &BigInt::operator-=(BigInt const &other) {
 	return *this = *this + -other;
 }
 
+/* Multiplication assignment */
+BigInt &BigInt::operator*=(BigInt const &other) {
+	return *this = *this * other;
+}
+
+/* Division assignment */
+BigInt &BigInt::operator/=(BigInt const &other) {
+	return *this = *this / other;
+}
+
+/* Modulus assignment */
+BigInt &BigInt::operator%=(BigInt const &other) {
+	return *this = *this % other;
+}
+
+/* Addition assignment with a native value */
+BigInt &BigInt::operator+=(long long value) {
+	addNative(value < 0, magnitudeOf(value));
+
+	return *this;
+}
+
+/* Subtraction assignment with a native value */
+BigInt &BigInt::operator-=(long long value) {
+	addNative(value > 0, magnitudeOf(value));
+
+	return *this;
+}
+
+/* Multiplication assignment with a native value */
+BigInt &BigInt::operator*=(long long value) {
+	bool negative = m_isNegative != (value < 0);
+	multiplyMagnitude(magnitudeOf(value));
+	m_isNegative = negative && !isZero();
+
+	return *this;
+}
+
+/* Division assignment with a native value
+ * Throws std::invalid_argument on division by zero */
+BigInt &BigInt::operator/=(long long value) {
+	if (!value) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	bool negative = m_isNegative != (value < 0);
+	divideMagnitude(magnitudeOf(value));
+	m_isNegative = negative && !isZero();
+
+	return *this;
+}
+
+/* Modulus assignment with a native value
+ * Throws std::invalid_argument on division by zero */
+BigInt &BigInt::operator%=(long long value) {
+	if (!value) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	setMagnitude(remainderMagnitude(magnitudeOf(value)));
+	m_isNegative = m_isNegative && !isZero();
+
+	return *this;
+}
+
 /* Compares BigInt value to value of other BitInt
  *
  * @return       -1 if this is less than other
  *                0 if this is equal to other
  *                1 if this is greater than other */
 short BigInt::compare(BigInt const &other) const {
-	if (m_isNegative) { // if this is negative ...
-		if (!other.m_isNegative) { // and other is positive ...
-			return -1; // this is less than other ...
+	size_t thisSize = m_value.size();
+	size_t otherSize = other.m_value.size();
+	size_t idx = thisSize;
+	short result = 0;
+
+	if (m_isNegative != other.m_isNegative) { // if signs differ ...
+		result = m_isNegative ? -1 : 1; // the negative one is less
+	}
+	else if (thisSize != otherSize) { // if value lengths differ ...
+		result = thisSize > otherSize ? 1 : -1; // the longer one has the greater magnitude
+	}
+	else {
+		// Iterate backwards through values until they differ
+		while (idx > 0 && m_value[idx - 1] == other.m_value[idx - 1]) {
+			--idx;
 		}
+
+		if (idx > 0) { // if this[idx] is less than other[idx], magnitude is less
+			result = m_value[idx - 1] < other.m_value[idx - 1] ? -1 : 1;
+		}
+	}
+
+	BIGINT_RECORD(BigIntOp::Compare, thisSize, thisSize - idx);
+
+	// A greater magnitude is less when both are negative
+	if (m_isNegative && other.m_isNegative) {
+		return -result;
+	}
+
+	return result; // 0 if this equals other
+}
+
+/* Compares BigInt value to a native value
+ *
+ * @return       -1 if this is less than value
+ *                0 if this is equal to value
+ *                1 if this is greater than value */
+short BigInt::compare(long long value) const {
+	bool negative = value < 0;
+	if (m_isNegative != negative) {
+		return m_isNegative ? -1 : 1;
+	}
+
+	short result = compareMagnitude(magnitudeOf(value));
+
+	return negative ? -result : result;
+}
+
+/* Returns -1 if negative, 0 if zero and 1 if positive */
+short BigInt::sign() const {
+	if (isZero()) {
+		return 0;
 	}
-	else if (other.m_isNegative) { // else if this is positive and other is negative ...
-		return 1; // this is greater than other
+
+	return m_isNegative ? -1 : 1;
+}
+
+/* Returns the number of decimal digits in the value */
+size_t BigInt::digitCount() const {
+	return m_value.size();
+}
+
+/* Returns the decimal digit at the given place value (0 is the ones place) */
+short BigInt::digitAt(size_t place) const {
+	return place < m_value.size() ? m_value[place] : 0;
+}
+
+/* Multiplies by 10^places, or divides by 10^-places truncating toward zero
+ * Digits are shifted directly, no multiplication takes place */
+BigInt &BigInt::shiftDigits(long long places) {
+	if (!places || isZero()) {
+		return *this;
 	}
 
 	size_t thisSize = m_value.size();
-	size_t otherSize = other.m_value.size();
 
-	if (thisSize > otherSize) { // if this value len is greater than other value len
-		if (m_isNegative) { // if this is negative
-			return -1; // this is less than other
+	if (places < 0) {
+		size_t drop = static_cast<size_t>(-places);
+		if (drop >= thisSize) {
+			m_value.clear();
+			trimLeadingZeros();
+			return *this;
 		}
-		return 1; // else this is greater than other
+
+		m_value.erase(0, drop);
+		return *this;
 	}
 
-	if (thisSize < otherSize) { // same as above, but opposite
-		if (m_isNegative) {
-			return 1;
+	size_t count = static_cast<size_t>(places);
+	Digits shifted(thisSize + count);
+	for (size_t i = 0; i < count; ++i) {
+		shifted.push(0);
+	}
+	for (size_t i = 0; i < thisSize; ++i) {
+		shifted.push(m_value[i]);
+	}
+	m_value = std::move(shifted);
+
+	return *this;
+}
+
+/* Divides dividend by divisor using schoolbook long division
+ * The quotient truncates toward zero and the remainder takes the sign of the dividend
+ * Throws std::invalid_argument on division by zero */
+void BigInt::divMod(BigInt const &dividend, BigInt const &divisor, BigInt &quotient, BigInt &remainder) {
+	BIGINT_SCOPE(BigIntOp::Divide);
+	if (divisor.isZero()) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	size_t n = dividend.m_value.size();
+	size_t m = divisor.m_value.size();
+	bool negative = dividend.m_isNegative != divisor.m_isNegative;
+	bool remainderNegative = dividend.m_isNegative;
+
+	// Compare magnitudes to catch a quotient of zero early
+	short magnitude = n < m ? -1 : n > m ? 1 : 0;
+	for (size_t idx = n; !magnitude && idx-- > 0;) {
+		if (dividend.m_value[idx] != divisor.m_value[idx]) {
+			magnitude = dividend.m_value[idx] < divisor.m_value[idx] ? -1 : 1;
 		}
-		return -1;
 	}
 
-	// Iterate backwards through values and compare
-	for (size_t i = 0, idx = thisSize - 1; i < thisSize; ++i, --idx) {
-		if (m_value[idx] == other.m_value[idx]) {
-			continue;
+	if (magnitude < 0) {
+		remainder = dividend;
+		quotient = BigInt();
+		BIGINT_RECORD(BigIntOp::Divide, n, n);
+		return;
+	}
+
+	// Working copy of the dividend with one spare digit on top
+	Buffer<int> rem(dividend.m_value.begin(), dividend.m_value.end());
+	rem.push_back(0);
+	Buffer<int> v(divisor.m_value.begin(), divisor.m_value.end());
+	Buffer<char> digits(n - m + 1, 0);
+
+	// Leading digits of the divisor used to estimate each quotient digit
+	size_t k = m < 17 ? m : 17;
+	long long lead = 0;
+	for (size_t i = 0; i < k; ++i) {
+		lead = lead * 10 + v[m - 1 - i];
+	}
+
+	// Each step divides the window rem[j .. j + m] by v
+	for (size_t j = n - m + 1; j-- > 0;) {
+		long long window = 0;
+		for (size_t i = 0; i <= k; ++i) {
+			window = window * 10 + rem[j + m - i];
 		}
 
-		// If this[idx] is less than other[idx]
-		if (m_value[idx] < other.m_value[idx]) {
-			return m_isNegative ? 1 : -1;
+		long long q = window / lead;
+		if (q > 9) {
+			q = 9;
 		}
 
-		// else if this[idx] is greater than other[idx]
-		return m_isNegative ? -1 : 1;
+		// Subtract q * v from the window
+		if (q) {
+			int borrow = 0;
+			for (size_t i = 0; i < m; ++i) {
+				int d = rem[j + i] - static_cast<int>(q) * v[i] - borrow;
+				borrow = d < 0 ? (9 - d) / 10 : 0;
+				rem[j + i] = d + borrow * 10;
+			}
+			rem[j + m] -= borrow;
+		}
+
+		// The estimate can be one too large; add v back while negative
+		while (rem[j + m] < 0) {
+			int carry = 0;
+			for (size_t i = 0; i < m; ++i) {
+				int d = rem[j + i] + v[i] + carry;
+				carry = d > 9;
+				rem[j + i] = d - carry * 10;
+			}
+			rem[j + m] += carry;
+			--q;
+		}
+
+		// Or too small when the divisor was truncated; subtract v while the window is not less
+		auto windowLess = [&]() {
+			if (rem[j + m]) {
+				return false;
+			}
+			for (size_t i = m; i-- > 0;) {
+				if (rem[j + i] != v[i]) {
+					return rem[j + i] < v[i];
+				}
+			}
+			return false;
+		};
+
+		while (!windowLess()) {
+			int borrow = 0;
+			for (size_t i = 0; i < m; ++i) {
+				int d = rem[j + i] - v[i] - borrow;
+				borrow = d < 0;
+				rem[j + i] = d + borrow * 10;
+			}
+			rem[j + m] -= borrow;
+			++q;
+		}
+
+		digits[j] = static_cast<char>(q);
+	}
+
+	quotient.m_value = Digits(digits.size());
+	for (char d : digits) {
+		quotient.m_value.push(d);
 	}
-	return 0; // This equals other
+	quotient.m_isNegative = negative;
+	quotient.trimLeadingZeros();
+
+	remainder.m_value = Digits(m);
+	for (size_t i = 0; i < m; ++i) {
+		remainder.m_value.push(static_cast<char>(rem[i]));
+	}
+	remainder.m_isNegative = remainderNegative;
+	remainder.trimLeadingZeros();
+
+	BIGINT_RECORD(BigIntOp::Divide, n, (n - m + 1) * m);
 }
 
 /* Checks if a string input is a valid BigInt value */
@@ -351,11 +1043,243 @@ std::istream &operator>>(std::istream &in, BigInt &b) {
 	return in;
 }
 
-// -------------- Private
+/* Adds a BigInt to a native value */
+BigInt operator+(long long lhs, BigInt const &rhs) {
+	return rhs + lhs;
+}
 
-/* Sets the BigInt value
- * If validated is true, this method will not attempt to validated the string input */
-void BigInt::setValue(std::string const &s, bool validated) {
+/* Subtracts a BigInt from a native value, as -(rhs - lhs) */
+BigInt operator-(long long lhs, BigInt const &rhs) {
+	BigInt buffer(rhs);
+	buffer -= lhs;
+	buffer.m_isNegative = !buffer.m_isNegative && !buffer.isZero();
+
+	return buffer;
+}
+
+/* Multiplies a native value by a BigInt */
+BigInt operator*(long long lhs, BigInt const &rhs) {
+	return rhs * lhs;
+}
+
+/* Divides a native value by a BigInt, truncating toward zero
+ * A divisor larger in magnitude than lhs gives 0. Any other fits an unsigned
+ * long long, so the magnitudes are divided natively, which also covers LLONG_MIN */
+BigInt operator/(long long lhs, BigInt const &rhs) {
+	if (rhs.isZero()) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	unsigned long long magnitude = magnitudeOf(lhs);
+	BigInt buffer;
+	if (rhs.compareMagnitude(magnitude) <= 0) {
+		buffer.setMagnitude(magnitude / rhs.nativeMagnitude());
+		buffer.m_isNegative = (lhs < 0) != rhs.m_isNegative && !buffer.isZero();
+	}
+
+	return buffer;
+}
+
+/* Returns the remainder of dividing a native value by a BigInt
+ * The remainder takes the sign of lhs, and is lhs itself when rhs is larger in magnitude */
+BigInt operator%(long long lhs, BigInt const &rhs) {
+	if (rhs.isZero()) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	unsigned long long magnitude = magnitudeOf(lhs);
+	if (rhs.compareMagnitude(magnitude) <= 0) {
+		magnitude %= rhs.nativeMagnitude();
+	}
+
+	BigInt buffer;
+	buffer.setMagnitude(magnitude);
+	buffer.m_isNegative = lhs < 0 && magnitude;
+
+	return buffer;
+}
+
+/* Checks if a native value equals a BigInt value */
+bool operator==(long long lhs, BigInt const &rhs) {
+	return rhs.compare(lhs) == 0;
+}
+
+/* Checks if a native value does not equal a BigInt value */
+bool operator!=(long long lhs, BigInt const &rhs) {
+	return rhs.compare(lhs) != 0;
+}
+
+/* Checks if a native value is less than a BigInt value */
+bool operator<(long long lhs, BigInt const &rhs) {
+	return rhs.compare(lhs) == 1;
+}
+
+/* Checks if a native value is greater than a BigInt value */
+bool operator>(long long lhs, BigInt const &rhs) {
+	return rhs.compare(lhs) == -1;
+}
+
+/* Checks if a native value is less than or equal to a BigInt value */
+bool operator<=(long long lhs, BigInt const &rhs) {
+	return rhs.compare(lhs) != -1;
+}
+
+/* Checks if a native value is greater than or equal to a BigInt value */
+bool operator>=(long long lhs, BigInt const &rhs) {
+	return rhs.compare(lhs) != 1;
+}
+
+/* Carries column sums into digits, replacing the digits
+ * digits is only cleared, so a buffer reserved for the final result never reallocates */
+static void carryColumns(Buffer<long long> const &columns, Buffer<long long> &digits) {
+	digits.clear();
+
+	long long carry = 0;
+	for (long long column : columns) {
+		carry += column;
+		digits.push_back(carry % 10);
+		carry /= 10;
+	}
+
+	while (carry) {
+		digits.push_back(carry % 10);
+		carry /= 10;
+	}
+
+	while (digits.size() > 1 && !digits.back()) {
+		digits.pop_back();
+	}
+}
+
+/* Raises base to exponent by left-to-right sliding window exponentiation
+ * Odd powers of the base up to the window width are precomputed, then each
+ * window of exponent bits costs its squarings plus a single multiplication.
+ * The result has at most digits(base) * exponent digits, so the working
+ * buffers are reserved once at that size */
+BigInt pow(BigInt const &base, unsigned long long exponent) {
+	// Its tables and products are multiplication's allocations
+	BIGINT_SCOPE(BigIntOp::Multiply);
+	if (!exponent) {
+		return BigInt(1);
+	}
+
+	if (exponent == 1 || base.isZero()) {
+		return base;
+	}
+
+	bool negative = base.m_isNegative && (exponent & 1);
+	size_t baseSize = base.m_value.size();
+
+	// Checked before any shortcut, so no digit count below can overflow
+	if (exponent > SIZE_MAX / baseSize) {
+		throw std::length_error("Result of pow is too large");
+	}
+
+	// A power of ten (1 included) is a 1 followed by zeros, so its powers are digit shifts
+	size_t zeros = 0;
+	while (zeros + 1 < baseSize && !base.m_value[zeros]) {
+		++zeros;
+	}
+
+	if (zeros + 1 == baseSize && base.m_value[zeros] == 1) {
+		if (zeros && exponent > static_cast<unsigned long long>(LLONG_MAX) / zeros) {
+			throw std::length_error("Result of pow is too large");
+		}
+
+		BigInt result(1);
+		result.shiftDigits(static_cast<long long>(zeros * exponent));
+		result.m_isNegative = negative;
+
+		return result;
+	}
+
+	size_t limit = baseSize * static_cast<size_t>(exponent);
+
+	int bits = 0;
+	for (unsigned long long e = exponent; e; e >>= 1) {
+		++bits;
+	}
+
+	// Wider windows save multiplications but cost a larger table.
+	// A power of two exponent is one window and then only squarings, so it needs no table
+	int width = bits <= 6 ? 1 : bits <= 16 ? 2 : bits <= 40 ? 3 : 4;
+	if (!(exponent & (exponent - 1))) {
+		width = 1;
+	}
+
+	// Odd powers base^1, base^3, ... base^(2^width - 1), as digits
+	Buffer<Buffer<long long>> table(static_cast<size_t>(1) << (width - 1));
+	table[0].assign(base.m_value.begin(), base.m_value.end());
+	if (width > 1) {
+		BigInt squared = base.square();
+		BigInt current = base;
+		for (size_t k = 1; k < table.size(); ++k) {
+			current = current * squared;
+			table[k].assign(current.m_value.begin(), current.m_value.end());
+		}
+	}
+
+	Buffer<long long> result;
+	Buffer<long long> columns;
+	result.reserve(limit + 1);
+	columns.reserve(limit + 1);
+
+	auto square = [&]() {
+		columns.assign(2 * result.size() - 1, 0);
+		BigInt::squareDigits(result.data(), result.size(), columns.data());
+		carryColumns(columns, result);
+	};
+
+	auto multiply = [&](Buffer<long long> const &factor) {
+		columns.assign(result.size() + factor.size() - 1, 0);
+		BigInt::multiplyDigits(result.data(), result.size(), factor.data(), factor.size(), columns.data());
+		carryColumns(columns, result);
+	};
+
+	for (int i = bits - 1; i >= 0;) {
+		if (!((exponent >> i) & 1)) {
+			square();
+			--i;
+			continue;
+		}
+
+		// Longest window from bit i down to a set bit, at most width bits long
+		int j = i - width + 1 > 0 ? i - width + 1 : 0;
+		while (!((exponent >> j) & 1)) {
+			++j;
+		}
+		unsigned long long window = (exponent >> j) & ((1ULL << (i - j + 1)) - 1);
+
+		if (result.empty()) { // the leading window just copies from the table
+			result = table[window >> 1];
+		}
+		else {
+			for (int k = j; k <= i; ++k) {
+				square();
+			}
+			multiply(table[window >> 1]);
+		}
+
+		i = j - 1;
+	}
+
+	BigInt buffer;
+	buffer.m_value = BigInt::Digits(result.size());
+	for (long long digit : result) {
+		buffer.m_value.push(static_cast<char>(digit));
+	}
+	buffer.m_isNegative = negative;
+	buffer.trimLeadingZeros();
+
+	return buffer;
+}
+
+// -------------- Private
+
+/* Sets the BigInt value
+ * If validated is true, this method will not attempt to validated the string input */
+void BigInt::setValue(std::string const &s, bool validated) {
+	BIGINT_SCOPE(BigIntOp::SetValue);
 	m_value.clear();
 
 	if (s.empty()) {
@@ -395,17 +1319,595 @@ void BigInt::setValue(std::string const &s, bool validated) {
 		}
 	}
 	trimLeadingZeros();
+
+	BIGINT_RECORD(BigIntOp::SetValue, thisSize, thisSize);
 }
 
 // Removes leading 0's from the BigInt value
 void BigInt::trimLeadingZeros() {
 	size_t count = m_value.size();
-	for (size_t i = 0, j = count - 1; i < count && !m_value[j]; ++i, --j) {
-		m_value.erase(j);
+	size_t kept = count;
+	while (kept && !m_value[kept - 1]) {
+		--kept;
 	}
+	m_value.erase(kept, count);
+
+	BIGINT_RECORD(BigIntOp::TrimLeadingZeros, count, count - m_value.size());
 
 	if (m_value.size() == 0) {
 		m_value.push(0);
 		m_isNegative = false;
 	}
-}
\ No newline at end of file
+}
+
+/* Checks if the BigInt value is 0 */
+bool BigInt::isZero() const {
+	return m_value.size() == 1 && m_value[0] == 0;
+}
+
+/* Removes most significant zero limbs */
+static void trimLimbs(Buffer<uint32_t> &limbs) {
+	while (!limbs.empty() && !limbs.back()) {
+		limbs.pop_back();
+	}
+}
+
+/* Adds bSize limbs from b into a, starting offset limbs up, growing a as needed */
+template <unsigned long long Base>
+static void addLimbs(Buffer<uint32_t> &a, uint32_t const *b, size_t bSize, size_t offset) {
+	if (a.size() < offset + bSize) {
+		a.resize(offset + bSize, 0);
+	}
+
+	unsigned long long carry = 0;
+	size_t idx = offset;
+	for (size_t i = 0; i < bSize; ++i, ++idx) {
+		carry += static_cast<unsigned long long>(a[idx]) + b[i];
+		a[idx] = static_cast<uint32_t>(carry % Base);
+		carry /= Base;
+	}
+
+	for (; carry; ++idx) {
+		if (idx == a.size()) {
+			a.push_back(0);
+		}
+		carry += a[idx];
+		a[idx] = static_cast<uint32_t>(carry % Base);
+		carry /= Base;
+	}
+}
+
+/* Subtracts b from a in place. a must be at least b, and b trimmed */
+template <unsigned long long Base>
+static void subtractLimbs(Buffer<uint32_t> &a, Buffer<uint32_t> const &b) {
+	unsigned long long borrow = 0;
+	for (size_t i = 0; i < a.size() && (i < b.size() || borrow); ++i) {
+		unsigned long long taken = (i < b.size() ? b[i] : 0) + borrow;
+		borrow = a[i] < taken;
+		a[i] = static_cast<uint32_t>(a[i] + borrow * Base - taken);
+	}
+}
+
+/* Multiplies two limb arrays, least significant first, returning the trimmed product
+ * Limbs are full words of Base, so unlike multiplyDigits every step carries.
+ * Unbalanced operands are cut into pieces the size of the shorter one,
+ * balanced ones are split in halves Karatsuba style */
+template <unsigned long long Base>
+static Buffer<uint32_t> multiplyLimbs(uint32_t const *a, size_t aSize, uint32_t const *b, size_t bSize) {
+	if (aSize < bSize) {
+		std::swap(a, b);
+		std::swap(aSize, bSize);
+	}
+
+	Buffer<uint32_t> out;
+	if (bSize < LIMB_KARATSUBA_THRESHOLD) {
+		out.assign(aSize + bSize, 0);
+		for (size_t j = 0; j < bSize; ++j) {
+			unsigned long long carry = 0;
+			for (size_t i = 0; i < aSize; ++i) {
+				carry += static_cast<unsigned long long>(a[i]) * b[j] + out[i + j];
+				out[i + j] = static_cast<uint32_t>(carry % Base);
+				carry /= Base;
+			}
+			out[j + aSize] = static_cast<uint32_t>(carry);
+		}
+	}
+	else if (bSize <= aSize / 2) {
+		for (size_t offset = 0; offset < aSize; offset += bSize) {
+			size_t piece = aSize - offset < bSize ? aSize - offset : bSize;
+			Buffer<uint32_t> partial = multiplyLimbs<Base>(a + offset, piece, b, bSize);
+			addLimbs<Base>(out, partial.data(), partial.size(), offset);
+		}
+	}
+	else {
+		// a = a1 * Base^lo + a0, and b likewise; b1 is never empty here
+		size_t lo = aSize / 2;
+		Buffer<uint32_t> low = multiplyLimbs<Base>(a, lo, b, lo);
+		Buffer<uint32_t> high = multiplyLimbs<Base>(a + lo, aSize - lo, b + lo, bSize - lo);
+
+		Buffer<uint32_t> sumA(a + lo, a + aSize);
+		Buffer<uint32_t> sumB(b + lo, b + bSize);
+		addLimbs<Base>(sumA, a, lo, 0);
+		addLimbs<Base>(sumB, b, lo, 0);
+
+		// mid = (a0 + a1)(b0 + b1) - a0b0 - a1b1
+		Buffer<uint32_t> mid = multiplyLimbs<Base>(sumA.data(), sumA.size(), sumB.data(), sumB.size());
+		subtractLimbs<Base>(mid, low);
+		subtractLimbs<Base>(mid, high);
+		trimLimbs(mid);
+
+		out = low;
+		addLimbs<Base>(out, high.data(), high.size(), 2 * lo);
+		addLimbs<Base>(out, mid.data(), mid.size(), lo);
+	}
+
+	trimLimbs(out);
+	return out;
+}
+
+/* Converts count limbs of base From to trimmed limbs of base To, least significant first
+ * Short inputs run Horner's rule, multiplying by From and adding one limb at a
+ * time. Longer ones are split at 2^level limbs, the high half converted,
+ * multiplied by From^(2^level) and added to the low half, so the conversion
+ * is only a log factor slower than multiplyLimbs. powers[level] caches each
+ * From^(2^level) in base To between calls */
+template <unsigned long long From, unsigned long long To>
+static Buffer<uint32_t> convertLimbs(uint32_t const *limbs, size_t count, Buffer<Buffer<uint32_t>> &powers) {
+	while (count > 0 && !limbs[count - 1]) {
+		--count;
+	}
+
+	Buffer<uint32_t> out;
+	if (count <= CONVERSION_THRESHOLD) {
+		out.reserve(count * 2);
+		for (size_t idx = count; idx-- > 0;) {
+			// out = out * From + limbs[idx]
+			unsigned long long carry = limbs[idx];
+			for (uint32_t &limb : out) {
+				carry += limb * From;
+				limb = static_cast<uint32_t>(carry % To);
+				carry /= To;
+			}
+
+			for (; carry; carry /= To) {
+				out.push_back(static_cast<uint32_t>(carry % To));
+			}
+		}
+		return out;
+	}
+
+	// Largest 2^level below count, so each power is the previous one squared
+	size_t level = 0;
+	while ((static_cast<size_t>(1) << (level + 1)) < count) {
+		++level;
+	}
+	size_t split = static_cast<size_t>(1) << level;
+
+	if (powers.empty()) {
+		Buffer<uint32_t> from;
+		for (unsigned long long value = From; value; value /= To) {
+			from.push_back(static_cast<uint32_t>(value % To));
+		}
+		powers.push_back(from);
+	}
+	while (powers.size() <= level) {
+		Buffer<uint32_t> const &last = powers.back();
+		powers.push_back(multiplyLimbs<To>(last.data(), last.size(), last.data(), last.size()));
+	}
+
+	Buffer<uint32_t> high = convertLimbs<From, To>(limbs + split, count - split, powers);
+	Buffer<uint32_t> const &power = powers[level];
+	out = multiplyLimbs<To>(high.data(), high.size(), power.data(), power.size());
+
+	Buffer<uint32_t> low = convertLimbs<From, To>(limbs, split, powers);
+	addLimbs<To>(out, low.data(), low.size(), 0);
+	return out;
+}
+
+/* Karatsuba step for two arrays of equal length
+ * Adds the column sums of a * b into out (2 * size - 1 columns) */
+static void karatsuba(long long const *a, long long const *b, size_t size, long long *out) {
+	if (size < KARATSUBA_THRESHOLD) {
+		for (size_t i = 0; i < size; ++i) {
+			if (!a[i]) {
+				continue;
+			}
+			for (size_t j = 0; j < size; ++j) {
+				out[i + j] += a[i] * b[j];
+			}
+		}
+		return;
+	}
+
+	// Split into low half (lo digits) and high half (hi digits), hi >= lo
+	size_t lo = size / 2;
+	size_t hi = size - lo;
+
+	Buffer<long long> sumA(a + lo, a + size);
+	Buffer<long long> sumB(b + lo, b + size);
+	for (size_t i = 0; i < lo; ++i) {
+		sumA[i] += a[i];
+		sumB[i] += b[i];
+	}
+
+	Buffer<long long> low(2 * lo - 1, 0);
+	Buffer<long long> high(2 * hi - 1, 0);
+	Buffer<long long> mid(2 * hi - 1, 0);
+
+	karatsuba(a, b, lo, low.data());
+	karatsuba(a + lo, b + lo, hi, high.data());
+	karatsuba(sumA.data(), sumB.data(), hi, mid.data());
+
+	// mid = (a0 + a1)(b0 + b1) - a0b0 - a1b1
+	for (size_t i = 0; i < low.size(); ++i) {
+		mid[i] -= low[i];
+		out[i] += low[i];
+	}
+	for (size_t i = 0; i < high.size(); ++i) {
+		mid[i] -= high[i];
+		out[i + 2 * lo] += high[i];
+	}
+	for (size_t i = 0; i < mid.size(); ++i) {
+		out[i + lo] += mid[i];
+	}
+}
+
+/* Multiplies two digit arrays, adding each column into out without carrying
+ * Unbalanced operands are cut into pieces the size of the shorter one
+ * Throws std::length_error if that is past KARATSUBA_MAX_DIGITS */
+void BigInt::multiplyDigits(long long const *a, size_t aSize, long long const *b, size_t bSize, long long *out) {
+	if (aSize < bSize) {
+		std::swap(a, b);
+		std::swap(aSize, bSize);
+	}
+
+	if (bSize > KARATSUBA_MAX_DIGITS) {
+		throw std::length_error("Operands are too long to multiply");
+	}
+
+	if (bSize < KARATSUBA_THRESHOLD) {
+		for (size_t j = 0; j < bSize; ++j) {
+			if (!b[j]) {
+				continue;
+			}
+			for (size_t i = 0; i < aSize; ++i) {
+				out[i + j] += a[i] * b[j];
+			}
+		}
+		return;
+	}
+
+	size_t offset = 0;
+	for (; offset + bSize <= aSize; offset += bSize) {
+		karatsuba(a + offset, b, bSize, out + offset);
+	}
+
+	if (offset < aSize) {
+		multiplyDigits(a + offset, aSize - offset, b, bSize, out + offset);
+	}
+}
+
+/* Sets digits to the given magnitude, leaving the sign untouched */
+void BigInt::setMagnitude(unsigned long long value) {
+	m_value.clear();
+
+	do {
+		m_value.push(static_cast<char>(value % 10));
+		value /= 10;
+	} while (value);
+}
+
+/* Adds a native value, given as sign and magnitude, in place
+ * Digits are only touched while the magnitude or a carry remains,
+ * so adding to a long value costs a handful of digits */
+void BigInt::addNative(bool isNegative, unsigned long long magnitude) {
+	BIGINT_SCOPE(BigIntOp::Add);
+	if (!magnitude) {
+		return;
+	}
+
+	size_t thisSize = m_value.size();
+
+	if (isZero()) {
+		m_isNegative = isNegative;
+		setMagnitude(magnitude);
+	}
+	else if (m_isNegative == isNegative) { // same sign, magnitudes add
+		size_t i = 0;
+		for (; magnitude && i < thisSize; ++i) {
+			unsigned long long value = m_value[i] + magnitude % 10;
+			magnitude = magnitude / 10 + value / 10;
+			m_value[i] = static_cast<char>(value % 10);
+		}
+
+		while (magnitude) {
+			m_value.push(static_cast<char>(magnitude % 10));
+			magnitude /= 10;
+		}
+	}
+	else if (compareMagnitude(magnitude) >= 0) { // signs differ, this has the larger magnitude
+		bool borrow = false;
+		for (size_t i = 0; (magnitude || borrow) && i < thisSize; ++i) {
+			short value = m_value[i] - static_cast<short>(magnitude % 10) - borrow;
+			magnitude /= 10;
+			borrow = value < 0;
+			m_value[i] = static_cast<char>(borrow ? value + 10 : value);
+		}
+
+		trimLeadingZeros();
+	}
+	else { // signs differ, the native value is larger so this fits a native value too
+		unsigned long long value = 0;
+		for (size_t idx = thisSize; idx-- > 0;) {
+			value = value * 10 + m_value[idx];
+		}
+
+		m_isNegative = isNegative;
+		setMagnitude(magnitude - value);
+	}
+
+	BIGINT_RECORD(BigIntOp::Add, thisSize, m_value.size());
+}
+
+/* Multiplies the magnitude by a native value in place
+ * Each digit times the value plus the carry stays below 10 * value,
+ * so values up to ULLONG_MAX / 10 run in a single pass */
+void BigInt::multiplyMagnitude(unsigned long long value) {
+	BIGINT_SCOPE(BigIntOp::Multiply);
+	if (value > ULLONG_MAX / 10) {
+		bool negative = m_isNegative;
+		*this = *this * fromULongLong(value);
+		m_isNegative = negative;
+		return;
+	}
+
+	size_t thisSize = m_value.size();
+	if (!value) {
+		setMagnitude(0);
+		return;
+	}
+
+	unsigned long long carry = 0;
+	for (size_t i = 0; i < thisSize; ++i) {
+		carry += m_value[i] * value;
+		m_value[i] = static_cast<char>(carry % 10);
+		carry /= 10;
+	}
+
+	while (carry) {
+		m_value.push(static_cast<char>(carry % 10));
+		carry /= 10;
+	}
+
+	BIGINT_RECORD(BigIntOp::Multiply, thisSize, thisSize);
+}
+
+/* Divides the magnitude by a native value in place, returning the remainder
+ * Short division from the most significant digit. The running remainder
+ * stays below value, so values up to ULLONG_MAX / 10 can't overflow it */
+unsigned long long BigInt::divideMagnitude(unsigned long long value) {
+	BIGINT_SCOPE(BigIntOp::Divide);
+	size_t thisSize = m_value.size();
+
+	if (value > ULLONG_MAX / 10) {
+		BigInt magnitude(*this), quotient, remainder;
+		magnitude.m_isNegative = false;
+		divMod(magnitude, fromULongLong(value), quotient, remainder);
+		m_value = std::move(quotient.m_value);
+
+		return remainder.toULongLong();
+	}
+
+	unsigned long long remainder = 0;
+	for (size_t idx = thisSize; idx-- > 0;) {
+		remainder = remainder * 10 + m_value[idx];
+		m_value[idx] = static_cast<char>(remainder / value);
+		remainder %= value;
+	}
+
+	trimLeadingZeros();
+
+	BIGINT_RECORD(BigIntOp::Divide, thisSize, thisSize);
+
+	return remainder;
+}
+
+/* Returns the remainder of dividing the magnitude by a native value */
+unsigned long long BigInt::remainderMagnitude(unsigned long long value) const {
+	if (value > ULLONG_MAX / 10) {
+		BigInt magnitude(*this), quotient, remainder;
+		magnitude.m_isNegative = false;
+		divMod(magnitude, fromULongLong(value), quotient, remainder);
+
+		return remainder.toULongLong();
+	}
+
+	unsigned long long remainder = 0;
+	for (size_t idx = m_value.size(); idx-- > 0;) {
+		remainder = (remainder * 10 + m_value[idx]) % value;
+	}
+
+	BIGINT_RECORD(BigIntOp::Divide, m_value.size(), m_value.size());
+
+	return remainder;
+}
+
+/* Returns the magnitude as a native value
+ * The caller must know it fits, for instance from compareMagnitude */
+unsigned long long BigInt::nativeMagnitude() const {
+	unsigned long long value = 0;
+	for (size_t idx = m_value.size(); idx-- > 0;) {
+		value = value * 10 + m_value[idx];
+	}
+
+	return value;
+}
+
+/* Compares the magnitude to a native value
+ * The value is split into digits, so no magnitude is converted and none can overflow */
+short BigInt::compareMagnitude(unsigned long long value) const {
+	char digits[20];
+	size_t count = 0;
+	do {
+		digits[count++] = static_cast<char>(value % 10);
+		value /= 10;
+	} while (value);
+
+	size_t thisSize = m_value.size();
+	size_t idx = thisSize;
+	short result = 0;
+
+	if (thisSize != count) {
+		result = thisSize > count ? 1 : -1;
+	}
+	else {
+		while (idx > 0 && m_value[idx - 1] == digits[idx - 1]) {
+			--idx;
+		}
+
+		if (idx > 0) {
+			result = m_value[idx - 1] < digits[idx - 1] ? -1 : 1;
+		}
+	}
+
+	BIGINT_RECORD(BigIntOp::Compare, thisSize, thisSize - idx);
+
+	return result;
+}
+
+/* Converts the magnitude to base 2^32 limbs, least significant first
+ * Zero produces no limbs. Digits are packed nine to a base 10^9 limb first */
+void BigInt::toBinaryLimbs(Limbs &limbs) const {
+	limbs.clear();
+	if (isZero()) {
+		return;
+	}
+
+	size_t thisSize = m_value.size();
+	Buffer<uint32_t> words((thisSize + 8) / 9, 0);
+	for (size_t idx = thisSize; idx-- > 0;) {
+		words[idx / 9] = words[idx / 9] * 10 + m_value[idx];
+	}
+
+	Buffer<Buffer<uint32_t>> powers;
+	limbs = convertLimbs<DECIMAL_LIMB, BINARY_LIMB>(words.data(), words.size(), powers);
+}
+
+/* Sets value from base 2^32 limbs, least significant first
+ * They become base 10^9 limbs first, each giving nine digits */
+void BigInt::setFromBinaryLimbs(Limbs limbs, bool negative) {
+	Buffer<Buffer<uint32_t>> powers;
+	Buffer<uint32_t> words = convertLimbs<BINARY_LIMB, DECIMAL_LIMB>(limbs.data(), limbs.size(), powers);
+
+	m_value.clear();
+	m_isNegative = negative;
+	m_value.reserve(words.size() * 9);
+	for (uint32_t word : words) {
+		for (int i = 0; i < 9; ++i) {
+			m_value.push(static_cast<char>(word % 10));
+			word /= 10;
+		}
+	}
+
+	trimLeadingZeros();
+}
+
+/* Checks if the value fits a native integer of the given width
+ * Values longer than 39 digits exceed 128 bits and are rejected outright */
+bool BigInt::fitsBits(bool isSigned, unsigned bits) const {
+	if (isZero()) {
+		return true;
+	}
+
+	if (m_isNegative && !isSigned) {
+		return false;
+	}
+
+	if (m_value.size() > 39) {
+		return false;
+	}
+
+	Limbs limbs;
+	toBinaryLimbs(limbs);
+
+	// Count significant bits of the magnitude
+	unsigned length = static_cast<unsigned>(limbs.size() - 1) * 32;
+	for (uint32_t l = limbs.back(); l; l >>= 1) {
+		++length;
+	}
+
+	if (!isSigned) {
+		return length <= bits;
+	}
+
+	if (length < bits) {
+		return true;
+	}
+
+	// The only value needing every bit is the minimum, -2^(bits - 1)
+	if (!m_isNegative || length > bits) {
+		return false;
+	}
+
+	for (size_t i = 0; i + 1 < limbs.size(); ++i) {
+		if (limbs[i]) {
+			return false;
+		}
+	}
+
+	return limbs.back() == (1U << ((length - 1) % 32));
+}
+
+/* Squares a digit array, adding each column into out without carrying
+ * Below the threshold each cross product is computed once and doubled,
+ * above it the Karatsuba split needs three squarings instead of three products
+ * Throws std::length_error if size is past KARATSUBA_MAX_DIGITS */
+void BigInt::squareDigits(long long const *a, size_t size, long long *out) {
+	if (size > KARATSUBA_MAX_DIGITS) {
+		throw std::length_error("Operand is too long to square");
+	}
+
+	if (size < KARATSUBA_THRESHOLD) {
+		for (size_t i = 0; i < size; ++i) {
+			if (!a[i]) {
+				continue;
+			}
+
+			out[2 * i] += a[i] * a[i];
+			long long twice = 2 * a[i];
+			for (size_t j = i + 1; j < size; ++j) {
+				out[i + j] += twice * a[j];
+			}
+		}
+		return;
+	}
+
+	size_t lo = size / 2;
+	size_t hi = size - lo;
+
+	Buffer<long long> sum(a + lo, a + size);
+	for (size_t i = 0; i < lo; ++i) {
+		sum[i] += a[i];
+	}
+
+	Buffer<long long> low(2 * lo - 1, 0);
+	Buffer<long long> high(2 * hi - 1, 0);
+	Buffer<long long> mid(2 * hi - 1, 0);
+
+	squareDigits(a, lo, low.data());
+	squareDigits(a + lo, hi, high.data());
+	squareDigits(sum.data(), hi, mid.data());
+
+	// mid = (a0 + a1)^2 - a0^2 - a1^2
+	for (size_t i = 0; i < low.size(); ++i) {
+		mid[i] -= low[i];
+		out[i] += low[i];
+	}
+	for (size_t i = 0; i < high.size(); ++i) {
+		mid[i] -= high[i];
+		out[i + 2 * lo] += high[i];
+	}
+	for (size_t i = 0; i < mid.size(); ++i) {
+		out[i + lo] += mid[i];
+	}
+}
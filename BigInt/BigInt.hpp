@@ -4,7 +4,15 @@
 #pragma once
 #include <string>
 #include <iostream>
-#include "Collection.hpp"
+#include <vector> /* std::vector */
+#include <cstdint> /* uint32_t */
+#include <climits> /* CHAR_BIT */
+#include <cmath> /* std::isfinite */
+#include <type_traits> /* std::is_floating_point */
+#include <random> /* std::uniform_int_distribution */
+#include <stdexcept> /* std::invalid_argument */
+#include "../Collection/Collection.hpp"
+#include "BigIntStats.hpp" /* BigIntAllocator */
 
 class BigInt {
 public:
@@ -27,6 +35,13 @@ public:
 	bool operator>(BigInt const &) const;
 	bool operator<=(BigInt const &) const;
 	bool operator>=(BigInt const &) const;
+	// Native integer overloads compare digits directly, no BigInt is built
+	bool operator==(long long) const;
+	bool operator!=(long long) const;
+	bool operator<(long long) const;
+	bool operator>(long long) const;
+	bool operator<=(long long) const;
+	bool operator>=(long long) const;
 
 /* Arithmatic operators */
 	BigInt operator+(BigInt const &) const;
@@ -36,32 +51,138 @@ public:
 	BigInt operator++(int); // Post
 	BigInt &operator--(); // Pre
 	BigInt operator--(int); // Post
+	BigInt operator*(BigInt const &) const;
+	// Division truncates toward zero, remainder takes the sign of the dividend
+	// Throws std::invalid_argument on division by zero
+	BigInt operator/(BigInt const &) const;
+	BigInt operator%(BigInt const &) const;
+	// Native integer overloads run single word kernels over the digits
+	BigInt operator+(long long) const;
+	BigInt operator-(long long) const;
+	BigInt operator*(long long) const;
+	BigInt operator/(long long) const;
+	BigInt operator%(long long) const;
 
 /* Assignment operators */
 	BigInt &operator+=(BigInt const &);
 	BigInt &operator-=(BigInt const &);
+	BigInt &operator*=(BigInt const &);
+	BigInt &operator/=(BigInt const &);
+	BigInt &operator%=(BigInt const &);
+	// Native integer overloads work in place, only allocating if the value outgrows its capacity
+	BigInt &operator+=(long long);
+	BigInt &operator-=(long long);
+	BigInt &operator*=(long long);
+	BigInt &operator/=(long long);
+	BigInt &operator%=(long long);
+
+/* Native integer left operands */
+	friend BigInt operator+(long long, BigInt const &);
+	friend BigInt operator-(long long, BigInt const &);
+	friend BigInt operator*(long long, BigInt const &);
+	friend BigInt operator/(long long, BigInt const &);
+	friend BigInt operator%(long long, BigInt const &);
+	friend bool operator==(long long, BigInt const &);
+	friend bool operator!=(long long, BigInt const &);
+	friend bool operator<(long long, BigInt const &);
+	friend bool operator>(long long, BigInt const &);
+	friend bool operator<=(long long, BigInt const &);
+	friend bool operator>=(long long, BigInt const &);
 
 /* ios operators */
 	friend std::ostream &operator<<(std::ostream &os, const BigInt &b);
 	friend std::istream &operator>>(std::istream &os, BigInt &b);
 
+/* Math functions */
+	// Raises base to exponent by left-to-right sliding window exponentiation
+	// 0^0 is 1
+	friend BigInt pow(BigInt const &base, unsigned long long exponent);
+
+/* Conversions */
+	// Constructs a BigInt from native values without going through strings
+	static BigInt fromULongLong(unsigned long long);
+#ifdef __SIZEOF_INT128__
+	static BigInt fromInt128(__int128);
+#endif
+	// Truncates toward zero. Throws std::invalid_argument if NaN or infinite
+	static BigInt fromDouble(double);
+
+	// Parses a string in the given radix (10, or a power of two up to 32)
+	// Throws std::invalid_argument if radix or string is invalid
+	static BigInt fromString(std::string const &s, unsigned radix = 10);
+
+	// Converts to native values
+	// Throws std::out_of_range if the value does not fit
+	unsigned long long toULongLong() const;
+#ifdef __SIZEOF_INT128__
+	__int128 toInt128() const;
+#endif
+	// Rounds to nearest, ties to even
+	double toDouble() const;
+
+	// Checks if the value is representable by native type T
+	template<class T>
+	bool fitsIn() const;
+
+/* Random values */
+	// rng is any uniform random bit generator, such as std::mt19937_64
+
+	// Returns a uniformly random value in [0, 2^bits)
+	template<class URBG>
+	static BigInt randomBits(unsigned long long bits, URBG &rng);
+	// Returns a uniformly random value in [0, bound)
+	// Throws std::invalid_argument if bound is not positive
+	template<class URBG>
+	static BigInt randomBelow(BigInt const &bound, URBG &rng);
+
 /* Function members */
-	// Returns the BigInt value as a string
-	std::string toString() const;
+	// Returns the BigInt value as a string in the given radix
+	// (10, or a power of two up to 32)
+	// Throws std::invalid_argument if radix is invalid
+	std::string toString(unsigned radix = 10) const;
 	// Compares BigInt value to other BigInt value
 	//
 	// -1 if this is less than other
 	//  0 if this is equal to other
 	//  1 if this is greater than other
 	short compare(BigInt const &) const;
+	short compare(long long) const;
+
+	// Returns the value squared
+	// Uses about half the digit products of a general multiplication
+	BigInt square() const;
+
+	// Returns -1 if negative, 0 if zero and 1 if positive
+	short sign() const;
+	// Returns the number of decimal digits in the value
+	size_t digitCount() const;
+	// Returns the decimal digit at the given place value (0 is the ones place)
+	// Places beyond the most significant digit are 0
+	short digitAt(size_t place) const;
+
+	// Multiplies by 10^places, or divides by 10^-places truncating toward zero
+	// Digits are shifted directly, no multiplication takes place
+	BigInt &shiftDigits(long long places);
+
+	// Divides dividend by divisor, setting both quotient and remainder
+	// Throws std::invalid_argument on division by zero
+	static void divMod(BigInt const &dividend, BigInt const &divisor, BigInt &quotient, BigInt &remainder);
 
 	// Checks if a string input is a valid BigInt value
 	static bool isValidValue(std::string const &s);
 
 private:
+	// Reads and builds digits directly
+	friend class BigIntAccumulator;
+	friend class BigIntRNS;
+
+	// Digit and base 2^32 limb storage, counted when BIGINT_STATS is defined
+	using Digits = mylib::Collection<char, BigIntAllocator<char>>;
+	using Limbs = std::vector<uint32_t, BigIntAllocator<uint32_t>>;
+
 	// Store unsigned single byte
 	// Index 0 is first place value, Index 1 is second, etc.
-	mylib::Collection<char> m_value;
+	Digits m_value;
 	// Is this BigInt value negative?
 	bool m_isNegative;
 	
@@ -71,4 +192,134 @@ private:
 
 	// Removes leading 0's from the BigInt value
 	void trimLeadingZeros();
+
+	// Checks if the BigInt value is 0
+	bool isZero() const;
+
+	// Sets digits to the given magnitude, leaving the sign untouched
+	void setMagnitude(unsigned long long);
+
+	// Adds a native value, given as sign and magnitude, in place
+	void addNative(bool isNegative, unsigned long long magnitude);
+	// Multiplies the magnitude by a native value in place
+	void multiplyMagnitude(unsigned long long);
+	// Divides the magnitude by a native value in place, returning the remainder
+	unsigned long long divideMagnitude(unsigned long long);
+	// Returns the remainder of dividing the magnitude by a native value
+	unsigned long long remainderMagnitude(unsigned long long) const;
+	// Compares the magnitude to a native value
+	short compareMagnitude(unsigned long long) const;
+	// Returns the magnitude as a native value, which the caller knows fits
+	unsigned long long nativeMagnitude() const;
+
+	// Converts the magnitude to base 2^32 limbs, least significant first
+	void toBinaryLimbs(Limbs &limbs) const;
+	// Sets value from base 2^32 limbs, least significant first
+	void setFromBinaryLimbs(Limbs limbs, bool negative);
+
+	// Checks if the value fits a native integer of the given width
+	bool fitsBits(bool isSigned, unsigned bits) const;
+
+	// Multiplies two digit arrays, adding each column into out without carrying.
+	// out must hold aSize + bSize - 1 zeroed columns. Throws std::length_error
+	// if the shorter operand is past KARATSUBA_MAX_DIGITS
+	static void multiplyDigits(long long const *a, size_t aSize, long long const *b, size_t bSize, long long *out);
+	// Squares a digit array, adding each column into out without carrying.
+	// out must hold 2 * size - 1 zeroed columns. Throws std::length_error
+	// if size is past KARATSUBA_MAX_DIGITS
+	static void squareDigits(long long const *a, size_t size, long long *out);
 };
+
+// Raises base to exponent by left-to-right sliding window exponentiation
+BigInt pow(BigInt const &base, unsigned long long exponent);
+
+/* Checks if the value is representable by native type T */
+template<class T>
+inline bool BigInt::fitsIn() const {
+	if constexpr (std::is_floating_point<T>::value) {
+		return std::isfinite(static_cast<T>(toDouble()));
+	}
+	else {
+		return fitsBits(T(-1) < T(0), sizeof(T) * CHAR_BIT);
+	}
+}
+
+/* Returns a uniformly random value in [0, 2^bits)
+ * Fills base 2^32 limbs straight from rng, masking the top one to the bit count */
+template<class URBG>
+inline BigInt BigInt::randomBits(unsigned long long bits, URBG &rng) {
+	std::uniform_int_distribution<uint32_t> word(0, UINT32_MAX);
+
+	Limbs limbs(static_cast<size_t>((bits + 31) / 32));
+	for (uint32_t &limb : limbs) {
+		limb = word(rng);
+	}
+
+	if (bits % 32) {
+		limbs.back() &= (static_cast<uint32_t>(1) << (bits % 32)) - 1;
+	}
+
+	BigInt buffer;
+	buffer.setFromBinaryLimbs(std::move(limbs), false);
+
+	return buffer;
+}
+
+/* Returns a uniformly random value in [0, bound)
+ * Digits below the leading 18 are drawn 18 at a time, then the leading
+ * chunk is drawn from [0, leading chunk of bound]. Only a draw whose leading
+ * chunk equals bound's and whose lower digits are too large is rejected,
+ * which happens with a chance below 1 / (leading chunk of bound + 1)
+ * Throws std::invalid_argument if bound is not positive */
+template<class URBG>
+inline BigInt BigInt::randomBelow(BigInt const &bound, URBG &rng) {
+	if (bound.sign() <= 0) {
+		throw std::invalid_argument("Bound must be positive: " + bound.toString());
+	}
+
+	size_t size = bound.m_value.size();
+	size_t topDigits = size < 18 ? size : 18;
+	size_t lowDigits = size - topDigits;
+
+	unsigned long long top = 0;
+	for (size_t idx = size; idx-- > lowDigits;) {
+		top = top * 10 + bound.m_value[idx];
+	}
+
+	std::uniform_int_distribution<unsigned long long> chunk(0, 999999999999999999ULL);
+	std::uniform_int_distribution<unsigned long long> leading(0, top);
+
+	BigInt buffer;
+	buffer.m_value = Digits(size);
+	for (;;) {
+		buffer.m_value.clear();
+		for (size_t i = 0; i < lowDigits; i += 18) {
+			unsigned long long value = chunk(rng);
+			for (size_t d = i; d < i + 18 && d < lowDigits; ++d) {
+				buffer.m_value.push(static_cast<char>(value % 10));
+				value /= 10;
+			}
+		}
+
+		unsigned long long value = leading(rng);
+		bool below = value < top;
+		for (size_t d = 0; d < topDigits; ++d) {
+			buffer.m_value.push(static_cast<char>(value % 10));
+			value /= 10;
+		}
+
+		// Equal leading chunks: the lower digits decide
+		size_t idx = lowDigits;
+		while (!below && idx > 0 && buffer.m_value[idx - 1] == bound.m_value[idx - 1]) {
+			--idx;
+		}
+
+		if (below || (idx > 0 && buffer.m_value[idx - 1] < bound.m_value[idx - 1])) {
+			break;
+		}
+	}
+
+	buffer.trimLeadingZeros();
+
+	return buffer;
+}
@@ -0,0 +1,148 @@
+#include "BigIntAccumulator.hpp"
+
+// -------------- Helpers
+namespace {
+	/* Propagates carries through columns in the given base */
+	void carry(std::vector<unsigned long long> &columns, unsigned long long base) {
+		unsigned long long carry = 0;
+		for (unsigned long long &column : columns) {
+			column += carry;
+			carry = column / base;
+			column %= base;
+		}
+
+		while (carry) {
+			columns.push_back(carry % base);
+			carry /= base;
+		}
+
+		while (!columns.empty() && !columns.back()) {
+			columns.pop_back();
+		}
+	}
+
+	/* Compares two normalized column sums */
+	short compareColumns(std::vector<unsigned long long> const &a, std::vector<unsigned long long> const &b) {
+		if (a.size() != b.size()) {
+			return a.size() < b.size() ? -1 : 1;
+		}
+
+		for (size_t i = a.size(); i-- > 0;) {
+			if (a[i] != b[i]) {
+				return a[i] < b[i] ? -1 : 1;
+			}
+		}
+
+		return 0;
+	}
+}
+
+// -------------- Public
+const unsigned long long BigIntAccumulator::LIMB_BASE;
+const unsigned long long BigIntAccumulator::MAX_PENDING;
+
+/* Default constructor
+ * Sets total to 0 */
+BigIntAccumulator::BigIntAccumulator() : m_pending(0) {}
+
+/* Adds value to the total */
+void BigIntAccumulator::add(BigInt const &value) {
+	addColumns(value.m_isNegative ? m_negative : m_positive, value);
+}
+
+/* Subtracts value from the total */
+void BigIntAccumulator::subtract(BigInt const &value) {
+	addColumns(value.m_isNegative ? m_positive : m_negative, value);
+}
+
+/* Addition assignment */
+BigIntAccumulator &BigIntAccumulator::operator+=(BigInt const &value) {
+	add(value);
+
+	return *this;
+}
+
+/* Subtraction assignment */
+BigIntAccumulator &BigIntAccumulator::operator-=(BigInt const &value) {
+	subtract(value);
+
+	return *this;
+}
+
+/* Returns the normalized total
+ * Only here do the two sums meet: the smaller is subtracted from the larger
+ * limb by limb, then the limbs are expanded into digits */
+BigInt BigIntAccumulator::sum() const {
+	normalize();
+
+	short order = compareColumns(m_positive, m_negative);
+	std::vector<unsigned long long> const &larger = order < 0 ? m_negative : m_positive;
+	std::vector<unsigned long long> const &smaller = order < 0 ? m_positive : m_negative;
+
+	BigInt result;
+	if (!order) {
+		return result;
+	}
+
+	result.m_value = BigInt::Digits(larger.size() * 9);
+	unsigned long long borrow = 0;
+	for (size_t i = 0; i < larger.size(); ++i) {
+		unsigned long long subtrahend = borrow + (i < smaller.size() ? smaller[i] : 0);
+		unsigned long long limb = larger[i];
+
+		borrow = limb < subtrahend;
+		limb = limb + borrow * LIMB_BASE - subtrahend;
+
+		for (int d = 0; d < 9; ++d) {
+			result.m_value.push(static_cast<char>(limb % 10));
+			limb /= 10;
+		}
+	}
+
+	result.m_isNegative = order < 0;
+	result.trimLeadingZeros();
+
+	return result;
+}
+
+/* Resets the total to 0, keeping allocated columns */
+void BigIntAccumulator::clear() {
+	m_positive.clear();
+	m_negative.clear();
+	m_pending = 0;
+}
+
+// -------------- Private
+/* Adds the limbs of value's magnitude into columns
+ * Columns only grow; nothing carries here */
+void BigIntAccumulator::addColumns(std::vector<unsigned long long> &columns, BigInt const &value) {
+	if (++m_pending >= MAX_PENDING) {
+		normalize();
+		m_pending = 1;
+	}
+
+	BigInt::Digits const &digits = value.m_value;
+	size_t size = digits.size();
+	size_t limbs = (size + 8) / 9;
+	if (columns.size() < limbs) {
+		columns.resize(limbs, 0);
+	}
+
+	// Gather each limb from its nine digits, most significant first
+	char const *d = digits.begin();
+	for (size_t limb = 0, start = 0; limb < limbs; ++limb, start += 9) {
+		size_t end = start + 9 < size ? start + 9 : size;
+		unsigned long long v = 0;
+		for (size_t idx = end; idx-- > start;) {
+			v = v * 10 + d[idx];
+		}
+		columns[limb] += v;
+	}
+}
+
+/* Propagates carries so every column is below LIMB_BASE */
+void BigIntAccumulator::normalize() const {
+	carry(m_positive, LIMB_BASE);
+	carry(m_negative, LIMB_BASE);
+	m_pending = 0;
+}
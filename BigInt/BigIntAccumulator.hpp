@@ -0,0 +1,52 @@
+/* BigIntAccumulator
+ * Sums long sequences of BigInt values without carrying on every add
+ *
+ * Addends are split into nine digit limbs which are added column by column
+ * into 64 bit slots. Positive and negative addends are kept in separate sums,
+ * so no add ever borrows either. Carries are only propagated when the total
+ * is read, or after so many adds that a slot could overflow */
+
+#pragma once
+#include <vector> /* std::vector */
+#include "BigInt.hpp"
+
+class BigIntAccumulator {
+public:
+/* Constructors */
+	// Default constructor
+	// Sets total to 0
+	BigIntAccumulator();
+
+/* Function members */
+	// Adds value to the total
+	void add(BigInt const &value);
+	// Subtracts value from the total
+	void subtract(BigInt const &value);
+
+	BigIntAccumulator &operator+=(BigInt const &value);
+	BigIntAccumulator &operator-=(BigInt const &value);
+
+	// Returns the normalized total
+	BigInt sum() const;
+
+	// Resets the total to 0, keeping allocated columns
+	void clear();
+
+private:
+	// Each limb holds nine decimal digits, least significant first
+	static const unsigned long long LIMB_BASE = 1000000000;
+	// Adds before a slot could exceed 2^64 (2^34 * 10^9 < 2^64)
+	static const unsigned long long MAX_PENDING = 1ULL << 34;
+
+	// Unnormalized column sums of positive and negative addends
+	mutable std::vector<unsigned long long> m_positive;
+	mutable std::vector<unsigned long long> m_negative;
+	// Adds since the columns were last normalized
+	mutable unsigned long long m_pending;
+
+	// Adds the limbs of value's magnitude into columns
+	void addColumns(std::vector<unsigned long long> &columns, BigInt const &value);
+
+	// Propagates carries so every column is below LIMB_BASE
+	void normalize() const;
+};
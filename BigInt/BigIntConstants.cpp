@@ -0,0 +1,392 @@
+#include "BigIntConstants.hpp"
+#include "BigIntMath.hpp" /* isqrt */
+#include <cmath> /* std::log10 */
+#include <cstdio> /* std::rename, std::remove */
+#include <fstream> /* std::ifstream, std::ofstream */
+#include <iomanip> /* std::setw */
+#include <chrono> /* std::chrono::steady_clock */
+#include <climits> /* INT_MAX */
+#include <stdexcept> /* std::runtime_error, std::length_error */
+
+// -------------- Helpers
+namespace {
+	// Extra decimal places carried through a computation and dropped at the end
+	const size_t GUARD_DIGITS = 10;
+	// Quotients up to this many digits are cheap enough for long division
+	const size_t SHORT_QUOTIENT = 64;
+
+	// 640320^3 / 24, from Chudnovsky's series
+	const long long CHUDNOVSKY_C3_OVER_24 = 10939058860032000LL;
+
+	/* Returns a requested digit count as the result's scale
+	 * Throws std::length_error if BigDecimal's int scale can't hold it */
+	int checkedDigits(size_t digits) {
+		if (digits > static_cast<size_t>(INT_MAX) - GUARD_DIGITS) {
+			throw std::length_error("Too many digits requested");
+		}
+
+		return static_cast<int>(digits);
+	}
+
+	/* Returns seconds on a steady clock */
+	double now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/* Returns 10^places */
+	BigInt powerOfTen(size_t places) {
+		BigInt value(1);
+
+		return value.shiftDigits(static_cast<long long>(places));
+	}
+
+	/* Returns 10^p / d to within a few units, for p >= digits(d)
+	 * Newton's iteration x' = x + x (10^p - d x) / 10^p doubles the number of
+	 * correct digits, so x is first found to half the digits, and only the last
+	 * step runs at full size. Digits of d beyond those the result can see are
+	 * dropped before starting */
+	BigInt reciprocal(BigInt const &d, size_t p) {
+		size_t m = d.digitCount();
+		size_t q = p - m + 1; // digits in the result
+
+		if (m > q + GUARD_DIGITS) {
+			size_t cut = m - q - GUARD_DIGITS;
+			BigInt top(d);
+			top.shiftDigits(-static_cast<long long>(cut));
+
+			return reciprocal(top, p - cut);
+		}
+
+		if (q <= SHORT_QUOTIENT) {
+			return powerOfTen(p) / d;
+		}
+
+		size_t half = q / 2 + GUARD_DIGITS / 2;
+		BigInt x = reciprocal(d, p - (q - half));
+		x.shiftDigits(static_cast<long long>(q - half));
+
+		BigInt error = powerOfTen(p) - d * x;
+		BigInt correction = x * error;
+		correction.shiftDigits(-static_cast<long long>(p));
+
+		return x + correction;
+	}
+
+	/* Returns n / d rounded down, for non-negative n and positive d
+	 * Multiplies by the reciprocal of d, then corrects the last few units
+	 * using the remainder */
+	BigInt divide(BigInt const &n, BigInt const &d) {
+		size_t nDigits = n.digitCount();
+		if (nDigits < d.digitCount() + SHORT_QUOTIENT) {
+			return n / d;
+		}
+
+		BigInt quotient = n * reciprocal(d, nDigits);
+		quotient.shiftDigits(-static_cast<long long>(nDigits));
+
+		BigInt remainder = n - quotient * d;
+		while (remainder.sign() < 0) {
+			--quotient;
+			remainder += d;
+		}
+		while (remainder >= d) {
+			++quotient;
+			remainder -= d;
+		}
+
+		return quotient;
+	}
+
+	/* Returns sqrt(c) * 10^places rounded down
+	 * Newton's iteration y' = (y + c 10^(2 places) / y) / 2 doubles the correct
+	 * digits, so y is first found to half the places */
+	BigInt scaledSqrt(long long c, size_t places) {
+		BigInt n(c);
+		n.shiftDigits(static_cast<long long>(2 * places));
+
+		if (places <= SHORT_QUOTIENT) {
+			return isqrt(n);
+		}
+
+		size_t half = places / 2 + GUARD_DIGITS / 2;
+		BigInt y = scaledSqrt(c, half);
+		y.shiftDigits(static_cast<long long>(places - half));
+
+		y = (y + divide(n, y)) / 2;
+
+		while (y.square() > n) {
+			--y;
+		}
+		while ((y + 1).square() <= n) {
+			++y;
+		}
+
+		return y;
+	}
+}
+
+// -------------- Public
+const size_t ConstantsEngine::BLOCKS;
+
+/* Constructor
+ * No checkpoints are read or written when checkpointDirectory is empty */
+ConstantsEngine::ConstantsEngine(std::string const &checkpointDirectory) : m_checkpointDirectory(checkpointDirectory) {}
+
+/* Returns pi truncated to the given number of decimal places
+ * pi = 426880 sqrt(10005) Q / T, where T / Q sums Chudnovsky's series.
+ * Each term adds about 14.18 digits */
+BigDecimal ConstantsEngine::pi(size_t digits) {
+	int scale = checkedDigits(digits);
+	m_phases.clear();
+	size_t places = digits + GUARD_DIGITS;
+
+	Split s = sum(Series::Pi, static_cast<size_t>(places / 14.181647462725477) + 2);
+
+	double start = now();
+	BigInt root = scaledSqrt(10005, places);
+	record("square root", start);
+
+	start = now();
+	BigInt value = divide(s.q * 426880 * root, s.t);
+	value.shiftDigits(-static_cast<long long>(GUARD_DIGITS));
+	record("division", start);
+
+	return BigDecimal(value, scale);
+}
+
+/* Returns e truncated to the given number of decimal places
+ * e sums 1/k!, so terms are added until k! exceeds 10^places */
+BigDecimal ConstantsEngine::e(size_t digits) {
+	int scale = checkedDigits(digits);
+	m_phases.clear();
+	size_t places = digits + GUARD_DIGITS;
+
+	size_t terms = 2;
+	for (double magnitude = 0; magnitude <= places; ++terms) {
+		magnitude += std::log10(static_cast<double>(terms));
+	}
+
+	Split s = sum(Series::E, terms);
+
+	double start = now();
+	BigInt value = divide(s.t.shiftDigits(static_cast<long long>(places)), s.q);
+	value.shiftDigits(-static_cast<long long>(GUARD_DIGITS));
+	record("division", start);
+
+	return BigDecimal(value, scale);
+}
+
+/* Returns sqrt(2) truncated to the given number of decimal places
+ * sqrt(2) = 7/5 sqrt(50/49) = 7/5 (1 - 1/50)^(-1/2), whose binomial series
+ * has term ratios (2k - 1) / 100k, below 1/50, so each term adds about 1.7 digits */
+BigDecimal ConstantsEngine::sqrt2(size_t digits) {
+	int scale = checkedDigits(digits);
+	m_phases.clear();
+	size_t places = digits + GUARD_DIGITS;
+
+	Split s = sum(Series::Sqrt2, static_cast<size_t>(places / 1.6989700043360187) + 2);
+
+	double start = now();
+	BigInt value = divide((s.t * 7).shiftDigits(static_cast<long long>(places)), s.q * 5);
+	value.shiftDigits(-static_cast<long long>(GUARD_DIGITS));
+	record("division", start);
+
+	return BigDecimal(value, scale);
+}
+
+/* Returns the phases of the last computation, in the order they ran */
+std::vector<ConstantsEngine::Phase> const &ConstantsEngine::phases() const {
+	return m_phases;
+}
+
+// -------------- Friend
+/* Prints the phases of an engine's last computation, one per line, and their total */
+std::ostream &operator<<(std::ostream &out, ConstantsEngine const &engine) {
+	double total = 0;
+	for (ConstantsEngine::Phase const &phase : engine.phases()) {
+		out << std::setw(18) << std::left << phase.name << std::right << ' ' << phase.seconds << " s\n";
+		total += phase.seconds;
+	}
+
+	return out << std::setw(18) << std::left << "total" << std::right << ' ' << total << " s\n";
+}
+
+// -------------- Private
+/* Sums terms [0, terms) of a series
+ * The terms are cut into BLOCKS blocks, each split on its own and checkpointed,
+ * and the blocks are then merged pairwise so the final products stay balanced */
+ConstantsEngine::Split ConstantsEngine::sum(Series series, size_t terms) {
+	double splitting = 0;
+	double checkpointing = 0;
+
+	std::vector<Split> blocks;
+	blocks.reserve(BLOCKS);
+	for (size_t block = 0; block < BLOCKS; ++block) {
+		size_t a = terms * block / BLOCKS;
+		size_t b = terms * (block + 1) / BLOCKS;
+		if (a == b) {
+			continue;
+		}
+
+		std::string path = checkpointPath(series, terms, block);
+		Split s;
+
+		double start = now();
+		bool loaded = !path.empty() && load(path, s);
+		checkpointing += now() - start;
+
+		if (!loaded) {
+			start = now();
+			s = split(series, a, b);
+			splitting += now() - start;
+
+			start = now();
+			if (!path.empty()) {
+				save(path, s);
+			}
+			checkpointing += now() - start;
+		}
+
+		blocks.push_back(std::move(s));
+	}
+
+	m_phases.push_back(Phase{"binary splitting", splitting});
+	if (!m_checkpointDirectory.empty()) {
+		m_phases.push_back(Phase{"checkpoints", checkpointing});
+	}
+
+	double start = now();
+	while (blocks.size() > 1) {
+		std::vector<Split> merged;
+		merged.reserve((blocks.size() + 1) / 2);
+		for (size_t i = 0; i + 1 < blocks.size(); i += 2) {
+			merged.push_back(merge(blocks[i], blocks[i + 1]));
+		}
+		if (blocks.size() % 2) {
+			merged.push_back(std::move(blocks.back()));
+		}
+		blocks = std::move(merged);
+	}
+	record("merging blocks", start);
+
+	return blocks.front();
+}
+
+/* Binary splitting over terms [a, b)
+ * Halves the range until single terms remain, so the operands of every
+ * multiplication are of similar length */
+ConstantsEngine::Split ConstantsEngine::split(Series series, size_t a, size_t b) {
+	if (b - a == 1) {
+		return leaf(series, a);
+	}
+
+	size_t middle = a + (b - a) / 2;
+
+	return merge(split(series, a, middle), split(series, middle, b));
+}
+
+/* The single term a
+ * Term a is the term before it times p(a) / q(a); T carries the term itself.
+ * Products are built in BigInt, as k^3 outgrows a long long near k = 2.1e6 */
+ConstantsEngine::Split ConstantsEngine::leaf(Series series, size_t a) {
+	long long k = static_cast<long long>(a);
+	Split s;
+
+	switch (series) {
+	case Series::Pi:
+		if (!k) {
+			s.p = 1;
+			s.q = 1;
+		}
+		else {
+			s.p = BigInt(6 * k - 5) * (2 * k - 1) * (6 * k - 1);
+			s.q = BigInt(k) * k * k * CHUDNOVSKY_C3_OVER_24;
+		}
+		s.t = s.p * (BigInt(545140134) * k + 13591409);
+		if (k % 2) {
+			s.t = 0 - s.t;
+		}
+		break;
+	case Series::E:
+		s.p = 1;
+		s.q = k ? k : 1;
+		s.t = 1;
+		break;
+	case Series::Sqrt2:
+		s.p = k ? 2 * k - 1 : 1;
+		s.q = k ? 100 * k : 1;
+		s.t = s.p;
+		break;
+	}
+
+	return s;
+}
+
+/* Combines adjacent ranges, left then right
+ * T = T1 Q2 + P1 T2 puts both partial sums over the common denominator Q1 Q2 */
+ConstantsEngine::Split ConstantsEngine::merge(Split const &left, Split const &right) {
+	Split s;
+	s.p = left.p * right.p;
+	s.q = left.q * right.q;
+	s.t = left.t * right.q + left.p * right.t;
+
+	return s;
+}
+
+/* Checkpoint file of one block, or an empty string when checkpoints are off
+ * The name holds the series, the term count and the block, so checkpoints of
+ * different runs never mix */
+std::string ConstantsEngine::checkpointPath(Series series, size_t terms, size_t block) const {
+	if (m_checkpointDirectory.empty()) {
+		return std::string();
+	}
+
+	static char const *const names[] = { "pi", "e", "sqrt2" };
+
+	return m_checkpointDirectory + "/" + names[static_cast<int>(series)] + "-" + std::to_string(terms)
+		+ "-" + std::to_string(block) + "of" + std::to_string(BLOCKS) + ".chk";
+}
+
+/* Loads a checkpoint of P, Q and T, one per line
+ * Returns false if it is missing or unreadable */
+bool ConstantsEngine::load(std::string const &path, Split &split) {
+	std::ifstream in(path);
+	std::string p, q, t;
+	if (!(in >> p >> q >> t)) {
+		return false;
+	}
+
+	if (!BigInt::isValidValue(p) || !BigInt::isValidValue(q) || !BigInt::isValidValue(t)) {
+		return false;
+	}
+
+	split.p = BigInt(p);
+	split.q = BigInt(q);
+	split.t = BigInt(t);
+
+	return true;
+}
+
+/* Saves a checkpoint of P, Q and T, one per line
+ * Writes a temporary file first and renames it, so a crash can't leave half of one
+ * Throws std::runtime_error if the file can't be written */
+void ConstantsEngine::save(std::string const &path, Split const &split) {
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream out(temporary);
+		out << split.p << '\n' << split.q << '\n' << split.t << '\n';
+		if (!out) {
+			throw std::runtime_error("Cannot write checkpoint " + temporary);
+		}
+	}
+
+	std::remove(path.c_str());
+	if (std::rename(temporary.c_str(), path.c_str())) {
+		throw std::runtime_error("Cannot write checkpoint " + path);
+	}
+}
+
+/* Records a phase which started at start */
+void ConstantsEngine::record(std::string const &name, double start) {
+	m_phases.push_back(Phase{name, now() - start});
+}
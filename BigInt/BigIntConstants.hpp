@@ -0,0 +1,83 @@
+/* BigIntConstants
+ * Computes pi, e and sqrt(2) to any number of decimal places
+ *
+ * Each constant is the sum of a hypergeometric series (Chudnovsky's for pi,
+ * 1/k! for e, and the binomial series of sqrt(50/49) for sqrt(2)), summed
+ * exactly as one fraction T / Q by binary splitting. The terms are split into
+ * blocks whose partial sums can be checkpointed to disk, so an interrupted run
+ * picks up where it left off. The final division, and the square root pi needs,
+ * use Newton's iteration on multiplications rather than long division.
+ *
+ * Every phase is timed, which makes a run a benchmark of BigInt multiplication
+ * at growing sizes */
+
+#pragma once
+#include <string>
+#include <vector> /* std::vector */
+#include <iostream>
+#include "BigInt.hpp"
+#include "BigDecimal.hpp"
+
+class ConstantsEngine {
+public:
+	// Time taken by one phase of a computation
+	struct Phase {
+		std::string name;
+		double seconds;
+	};
+
+/* Constructors */
+	// Checkpoints are kept in checkpointDirectory, which must exist
+	// No checkpoints are read or written when it is empty
+	explicit ConstantsEngine(std::string const &checkpointDirectory = "");
+
+/* Function members */
+	// Each returns the constant truncated to the given number of decimal places
+	// Throws std::length_error past INT_MAX - 10 places, the most a BigDecimal scale holds
+	BigDecimal pi(size_t digits);
+	BigDecimal e(size_t digits);
+	BigDecimal sqrt2(size_t digits);
+
+	// Returns the phases of the last computation, in the order they ran
+	std::vector<Phase> const &phases() const;
+
+	// Number of blocks the terms are split into, and so of checkpoints per run
+	static const size_t BLOCKS = 16;
+
+private:
+	enum class Series { Pi, E, Sqrt2 };
+
+	// Binary splitting state for a range of terms: the terms sum to T / Q,
+	// and P is the product of the numerators of their ratios
+	struct Split {
+		BigInt p;
+		BigInt q;
+		BigInt t;
+	};
+
+	std::string m_checkpointDirectory;
+	std::vector<Phase> m_phases;
+
+	// Sums terms [0, terms) of a series, block by block
+	Split sum(Series series, size_t terms);
+
+	// Binary splitting over terms [a, b)
+	static Split split(Series series, size_t a, size_t b);
+	// The single term a
+	static Split leaf(Series series, size_t a);
+	// Combines adjacent ranges, left then right
+	static Split merge(Split const &left, Split const &right);
+
+	// Checkpoint file of one block, or an empty string when checkpoints are off
+	std::string checkpointPath(Series series, size_t terms, size_t block) const;
+	// Loads a checkpoint, returning false if it is missing or unreadable
+	static bool load(std::string const &path, Split &split);
+	// Saves a checkpoint, writing a temporary file first so a crash can't leave half of one
+	static void save(std::string const &path, Split const &split);
+
+	// Records a phase which started at start
+	void record(std::string const &name, double start);
+};
+
+// Prints the phases of an engine's last computation, one per line, and their total
+std::ostream &operator<<(std::ostream &out, ConstantsEngine const &engine);
@@ -0,0 +1,227 @@
+#include "BigIntMath.hpp"
+#include <vector> /* std::vector */
+#include <climits> /* ULLONG_MAX */
+#include <stdexcept> /* std::invalid_argument */
+
+// -------------- Helpers
+namespace {
+	/* Returns all primes less than or equal to n using the sieve of Eratosthenes */
+	std::vector<unsigned long long> primesUpTo(unsigned long long n) {
+		std::vector<unsigned long long> primes;
+		if (n < 2) {
+			return primes;
+		}
+
+		std::vector<bool> composite(n + 1, false);
+		for (unsigned long long i = 2; i <= n; ++i) {
+			if (composite[i]) {
+				continue;
+			}
+
+			primes.push_back(i);
+			if (i <= n / i) {
+				for (unsigned long long j = i * i; j <= n; j += i) {
+					composite[j] = true;
+				}
+			}
+		}
+
+		return primes;
+	}
+
+	/* Multiplies factors[lo, hi) as a balanced tree so that both operands
+	 * of every multiplication are of similar length */
+	BigInt productTree(std::vector<unsigned long long> const &factors, size_t lo, size_t hi) {
+		if (hi == lo) {
+			return BigInt(1);
+		}
+
+		if (hi - lo == 1) {
+			return BigInt::fromULongLong(factors[lo]);
+		}
+
+		size_t mid = lo + (hi - lo) / 2;
+		return productTree(factors, lo, mid) * productTree(factors, mid, hi);
+	}
+
+	/* Multiplies all factors together
+	 * Neighbouring factors are packed natively while their product fits,
+	 * which keeps the leaves of the product tree as full as possible */
+	BigInt product(std::vector<unsigned long long> const &factors) {
+		std::vector<unsigned long long> packed;
+		unsigned long long current = 1;
+
+		for (unsigned long long factor : factors) {
+			if (current > ULLONG_MAX / factor) {
+				packed.push_back(current);
+				current = factor;
+			}
+			else {
+				current *= factor;
+			}
+		}
+		packed.push_back(current);
+
+		return productTree(packed, 0, packed.size());
+	}
+
+	/* Returns the swinging factorial n! / ((n / 2)!)^2
+	 * The exponent of each prime p is the count of odd values of n / p^i */
+	BigInt swing(unsigned long long n, std::vector<unsigned long long> const &primes) {
+		std::vector<unsigned long long> factors;
+
+		for (unsigned long long p : primes) {
+			if (p > n) {
+				break;
+			}
+
+			for (unsigned long long q = n / p; q; q /= p) {
+				if (q & 1) {
+					factors.push_back(p);
+				}
+			}
+		}
+
+		return product(factors);
+	}
+
+	/* Recursive step of the prime swing factorial: n! = ((n / 2)!)^2 * swing(n) */
+	BigInt primeSwingFactorial(unsigned long long n, std::vector<unsigned long long> const &primes) {
+		if (n < 2) {
+			return BigInt(1);
+		}
+
+		BigInt half = primeSwingFactorial(n / 2, primes);
+		return half * half * swing(n, primes);
+	}
+}
+
+// -------------- Public
+/* Returns n! using the prime swing algorithm */
+BigInt factorial(unsigned long long n) {
+	return primeSwingFactorial(n, primesUpTo(n));
+}
+
+/* Returns n choose k from its prime factorization
+ * Each prime up to k is divided out of the numerator terms n - k + 1 ... n
+ * and its exponent in k! is subtracted, leaving cofactors with no prime
+ * factor below k. Only O(k) memory is needed however large n is */
+BigInt binomial(unsigned long long n, unsigned long long k) {
+	if (k > n) {
+		return BigInt();
+	}
+
+	if (k > n - k) {
+		k = n - k;
+	}
+
+	if (k == 0) {
+		return BigInt(1);
+	}
+
+	unsigned long long first = n - k + 1;
+	std::vector<unsigned long long> terms(k);
+	for (unsigned long long i = 0; i < k; ++i) {
+		terms[i] = first + i;
+	}
+
+	std::vector<unsigned long long> factors;
+	for (unsigned long long p : primesUpTo(k)) {
+		unsigned long long exponent = 0;
+
+		// Divide p out of every term it divides
+		for (unsigned long long i = (p - first % p) % p; i < k; i += p) {
+			do {
+				terms[i] /= p;
+				++exponent;
+			} while (terms[i] % p == 0);
+		}
+
+		// Remove the exponent of p in k! (Legendre's formula)
+		for (unsigned long long q = k / p; q; q /= p) {
+			exponent -= q;
+		}
+
+		while (exponent--) {
+			factors.push_back(p);
+		}
+	}
+
+	for (unsigned long long term : terms) {
+		if (term > 1) {
+			factors.push_back(term);
+		}
+	}
+
+	return product(factors);
+}
+
+/* Returns the nth Fibonacci number using fast doubling
+ * F(2k) = F(k) * (2F(k + 1) - F(k))
+ * F(2k + 1) = F(k)^2 + F(k + 1)^2 */
+BigInt fibonacci(unsigned long long n) {
+	BigInt a; // F(k)
+	BigInt b(1); // F(k + 1)
+
+	// Walk the bits of n from most significant to least
+	unsigned long long bit = 1ULL << 63;
+	while (bit && !(n & bit)) {
+		bit >>= 1;
+	}
+
+	for (; bit; bit >>= 1) {
+		BigInt even = a * (b + b - a);
+		BigInt odd = a * a + b * b;
+
+		if (n & bit) {
+			a = odd;
+			b = even + odd;
+		}
+		else {
+			a = even;
+			b = odd;
+		}
+	}
+
+	return a;
+}
+
+/* Returns the product of all primes less than or equal to n */
+BigInt primorial(unsigned long long n) {
+	return product(primesUpTo(n));
+}
+
+/* Returns the non-negative greatest common divisor of a and b using Euclid's algorithm */
+BigInt gcd(BigInt a, BigInt b) {
+	while (b.sign()) {
+		BigInt r = a % b;
+		a = std::move(b);
+		b = std::move(r);
+	}
+
+	return a.sign() < 0 ? -a : a;
+}
+
+/* Returns the largest integer whose square does not exceed n using Newton's method
+ * Starts from a power of ten above the root so the iterates fall monotonically
+ * Throws std::invalid_argument if n is negative */
+BigInt isqrt(BigInt const &n) {
+	if (n.sign() < 0) {
+		throw std::invalid_argument("Square root of a negative value");
+	}
+
+	if (!n.sign()) {
+		return BigInt();
+	}
+
+	BigInt x(1);
+	x.shiftDigits((n.digitCount() + 1) / 2);
+
+	for (;;) {
+		BigInt y = (x + n / x) / BigInt(2);
+		if (y >= x) {
+			return x;
+		}
+		x = std::move(y);
+	}
+}
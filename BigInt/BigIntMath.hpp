@@ -0,0 +1,25 @@
+/* BigIntMath
+ * Combinatorial functions built on top of BigInt multiplication */
+
+#pragma once
+#include "BigInt.hpp"
+
+// Returns n! using the prime swing algorithm
+BigInt factorial(unsigned long long n);
+
+// Returns n choose k from its prime factorization
+// Returns 0 if k is greater than n
+BigInt binomial(unsigned long long n, unsigned long long k);
+
+// Returns the nth Fibonacci number using fast doubling
+BigInt fibonacci(unsigned long long n);
+
+// Returns the product of all primes less than or equal to n
+BigInt primorial(unsigned long long n);
+
+// Returns the non-negative greatest common divisor of a and b
+BigInt gcd(BigInt a, BigInt b);
+
+// Returns the largest integer whose square does not exceed n
+// Throws std::invalid_argument if n is negative
+BigInt isqrt(BigInt const &n);
@@ -0,0 +1,396 @@
+#include "BigIntPrime.hpp"
+#include "BigIntMath.hpp" /* gcd, isqrt */
+#include <vector> /* std::vector */
+#include <algorithm> /* std::upper_bound, std::binary_search */
+#include <random> /* std::mt19937_64, std::random_device */
+
+// -------------- Helpers
+namespace {
+	// Primes below this are kept in a table
+	const unsigned SIEVE_LIMIT = 65536;
+	// Primes below this are multiplied together for trial division by gcd
+	const unsigned TRIAL_LIMIT = 1000;
+	// Odd candidates sieved at once by nextPrime
+	const size_t WINDOW = 4096;
+
+	/* Returns the primes below SIEVE_LIMIT, sieved once on first use */
+	std::vector<unsigned> const &smallPrimes() {
+		static std::vector<unsigned> const primes = [] {
+			std::vector<unsigned> found;
+			std::vector<bool> composite(SIEVE_LIMIT, false);
+			for (unsigned i = 2; i < SIEVE_LIMIT; ++i) {
+				if (composite[i]) {
+					continue;
+				}
+
+				found.push_back(i);
+				for (unsigned j = i * i; j < SIEVE_LIMIT; j += i) {
+					composite[j] = true;
+				}
+			}
+			return found;
+		}();
+
+		return primes;
+	}
+
+	/* Returns the product of all primes below TRIAL_LIMIT */
+	BigInt const &trialProduct() {
+		static BigInt const product = [] {
+			BigInt result(1);
+			for (unsigned p : smallPrimes()) {
+				if (p >= TRIAL_LIMIT) {
+					break;
+				}
+				result *= BigInt(p);
+			}
+			return result;
+		}();
+
+		return product;
+	}
+
+	/* Returns |n| mod m for m below 2^32, consuming nine digits at a time */
+	unsigned long long residue(BigInt const &n, unsigned long long m) {
+		unsigned long long r = 0;
+		unsigned long long chunk = 0;
+		unsigned long long scale = 1;
+
+		for (size_t idx = n.digitCount(); idx-- > 0;) {
+			chunk = chunk * 10 + n.digitAt(idx);
+			scale *= 10;
+
+			if (scale == 1000000000 || idx == 0) {
+				r = (r * scale + chunk) % m;
+				chunk = 0;
+				scale = 1;
+			}
+		}
+
+		return r;
+	}
+
+	/* Jacobi symbol (a / n) for odd n */
+	int jacobi(unsigned long long a, unsigned long long n) {
+		int result = 1;
+		a %= n;
+
+		while (a) {
+			while (a % 2 == 0) {
+				a /= 2;
+				if (n % 8 == 3 || n % 8 == 5) {
+					result = -result;
+				}
+			}
+
+			std::swap(a, n);
+			if (a % 4 == 3 && n % 4 == 3) {
+				result = -result;
+			}
+			a %= n;
+		}
+
+		return n == 1 ? result : 0;
+	}
+
+	/* Jacobi symbol (a / n) for small a and odd BigInt n
+	 * Reciprocity swaps the arguments so only n mod |a| is needed */
+	int jacobi(long long a, BigInt const &n) {
+		int result = 1;
+		unsigned long long n8 = residue(n, 8);
+
+		if (a < 0) {
+			a = -a;
+			if (n8 % 4 == 3) {
+				result = -result;
+			}
+		}
+
+		while (a && a % 2 == 0) {
+			a /= 2;
+			if (n8 == 3 || n8 == 5) {
+				result = -result;
+			}
+		}
+
+		if (a == 1) {
+			return result;
+		}
+
+		if (a % 4 == 3 && n8 % 4 == 3) {
+			result = -result;
+		}
+
+		return result * jacobi(residue(n, a), static_cast<unsigned long long>(a));
+	}
+
+	/* Modular arithmetic with Barrett reduction
+	 * mu = 10^2k / m is computed once. Since digits are decimal, the divisions by
+	 * powers of ten in each reduction are digit shifts, leaving two multiplications */
+	class BarrettReducer {
+	public:
+		BarrettReducer(BigInt const &modulus) : m_modulus(modulus), m_digits(modulus.digitCount()) {
+			BigInt power(1);
+			power.shiftDigits(2 * m_digits);
+			m_mu = power / modulus;
+		}
+
+		// Reduces 0 <= x < modulus^2
+		BigInt reduce(BigInt const &x) const {
+			BigInt q(x);
+			q.shiftDigits(-static_cast<long long>(m_digits - 1));
+			q *= m_mu;
+			q.shiftDigits(-static_cast<long long>(m_digits + 1));
+
+			// The estimate is at most two short
+			BigInt r = x - q * m_modulus;
+			while (r >= m_modulus) {
+				r -= m_modulus;
+			}
+
+			return r;
+		}
+
+		// Returns a * b mod modulus for reduced a and b
+		BigInt multiply(BigInt const &a, BigInt const &b) const {
+			return reduce(a * b);
+		}
+
+		// Returns base^exponent mod modulus, exponent given as binary digits
+		BigInt power(BigInt const &base, std::string const &bits) const {
+			BigInt result(1);
+			for (char bit : bits) {
+				result = multiply(result, result);
+				if (bit == '1') {
+					result = multiply(result, base);
+				}
+			}
+
+			return result;
+		}
+
+		// Returns a - b mod modulus for reduced a and 0 <= b < 2 * modulus
+		BigInt subtract(BigInt const &a, BigInt const &b) const {
+			BigInt r = a - b;
+			while (r.sign() < 0) {
+				r += m_modulus;
+			}
+
+			return r;
+		}
+
+		// Returns x / 2 mod modulus for 0 <= x < 2 * modulus and odd modulus
+		BigInt half(BigInt x) const {
+			if (x.digitAt(0) & 1) {
+				x += m_modulus;
+			}
+			x /= BigInt(2);
+
+			if (x >= m_modulus) {
+				x -= m_modulus;
+			}
+
+			return x;
+		}
+
+	private:
+		BigInt m_modulus;
+		size_t m_digits;
+		BigInt m_mu;
+	};
+
+	/* Strong probable prime test to the given base
+	 * nMinusOne = d * 2^s with d given as binary digits */
+	bool strongProbablePrime(BarrettReducer const &reducer, BigInt const &base, BigInt const &nMinusOne,
+		std::string const &dBits, size_t s) {
+		BigInt one(1);
+		BigInt x = reducer.power(base, dBits);
+
+		if (x == one || x == nMinusOne) {
+			return true;
+		}
+
+		for (size_t r = 1; r < s; ++r) {
+			x = reducer.multiply(x, x);
+			if (x == nMinusOne) {
+				return true;
+			}
+			if (x == one) {
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	/* Strong Lucas probable prime test with Selfridge's parameters
+	 * D is the first of 5, -7, 9, -11, ... with (D / n) = -1, P = 1 and Q = (1 - D) / 4 */
+	bool strongLucasProbablePrime(BarrettReducer const &reducer, BigInt const &n) {
+		// Perfect squares never give (D / n) = -1
+		BigInt root = isqrt(n);
+		if (root * root == n) {
+			return false;
+		}
+
+		long long d = 5;
+		for (;;) {
+			int symbol = jacobi(d, n);
+			if (symbol == -1) {
+				break;
+			}
+			if (symbol == 0) { // |D| shares a factor with n, which is larger than |D|
+				return false;
+			}
+			d = d > 0 ? -(d + 2) : -d + 2;
+		}
+
+		long long q = (1 - d) / 4;
+		BigInt modD = d < 0 ? n - BigInt(-d) : BigInt(d);
+		BigInt modQ = q < 0 ? n - BigInt(-q) : BigInt(q);
+
+		// n + 1 = d * 2^s
+		std::string bits = (n + BigInt(1)).toString(2);
+		size_t s = bits.size() - 1 - bits.find_last_of('1');
+		bits.resize(bits.size() - s);
+
+		// Walk the bits of d computing U_k, V_k and Q^k, starting from k = 1
+		BigInt u(1);
+		BigInt v(1);
+		BigInt qk(modQ);
+
+		for (size_t i = 1; i < bits.size(); ++i) {
+			// Double: U_2k = U_k V_k, V_2k = V_k^2 - 2Q^k
+			u = reducer.multiply(u, v);
+			v = reducer.subtract(reducer.multiply(v, v), qk + qk);
+			qk = reducer.multiply(qk, qk);
+
+			// Increment: U_k+1 = (P U_k + V_k) / 2, V_k+1 = (D U_k + P V_k) / 2
+			if (bits[i] == '1') {
+				BigInt nextU = reducer.half(u + v);
+				v = reducer.half(reducer.multiply(modD, u) + v);
+				u = std::move(nextU);
+				qk = reducer.multiply(qk, modQ);
+			}
+		}
+
+		if (!u.sign() || !v.sign()) {
+			return true;
+		}
+
+		for (size_t r = 1; r < s; ++r) {
+			v = reducer.subtract(reducer.multiply(v, v), qk + qk);
+			if (!v.sign()) {
+				return true;
+			}
+			qk = reducer.multiply(qk, qk);
+		}
+
+		return false;
+	}
+
+	/* Baillie-PSW test for odd n above SIEVE_LIMIT without small factors,
+	 * followed by extra Miller-Rabin rounds with random bases */
+	bool bailliePSW(BigInt const &n, unsigned extraRounds) {
+		BarrettReducer reducer(n);
+		BigInt nMinusOne = n - BigInt(1);
+
+		// n - 1 = d * 2^s
+		std::string bits = nMinusOne.toString(2);
+		size_t s = bits.size() - 1 - bits.find_last_of('1');
+		bits.resize(bits.size() - s);
+
+		if (!strongProbablePrime(reducer, BigInt(2), nMinusOne, bits, s)) {
+			return false;
+		}
+
+		if (!strongLucasProbablePrime(reducer, n)) {
+			return false;
+		}
+
+		if (extraRounds) {
+			// One generator per thread, so concurrent tests never share its state
+			static thread_local std::mt19937_64 rng(std::random_device{}());
+			BigInt range = n - 3;
+
+			for (unsigned i = 0; i < extraRounds; ++i) {
+				BigInt base = BigInt::randomBelow(range, rng) + 2;
+				if (!strongProbablePrime(reducer, base, nMinusOne, bits, s)) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+// -------------- Public
+/* Checks if n is probably prime
+ * Small values are looked up in the sieve. Larger ones are trial divided with a
+ * single gcd against the product of the primes below TRIAL_LIMIT before the
+ * Baillie-PSW test and any extra Miller-Rabin rounds */
+bool isProbablePrime(BigInt const &n, unsigned extraRounds) {
+	if (n.sign() <= 0) {
+		return false;
+	}
+
+	std::vector<unsigned> const &primes = smallPrimes();
+	if (n < BigInt(SIEVE_LIMIT)) {
+		return std::binary_search(primes.begin(), primes.end(), static_cast<unsigned>(n.toULongLong()));
+	}
+
+	if (!(n.digitAt(0) & 1)) {
+		return false;
+	}
+
+	BigInt const &product = trialProduct();
+	if (gcd(n % product, product) != BigInt(1)) {
+		return false;
+	}
+
+	return bailliePSW(n, extraRounds);
+}
+
+/* Returns the smallest probable prime greater than n
+ * Candidates are sieved a window at a time by the small primes, using one
+ * residue per prime, before any of them is tested */
+BigInt nextPrime(BigInt const &n) {
+	std::vector<unsigned> const &primes = smallPrimes();
+	if (n < BigInt(primes.back())) {
+		if (n.sign() < 0) {
+			return BigInt(2);
+		}
+		return BigInt(*std::upper_bound(primes.begin(), primes.end(), static_cast<unsigned>(n.toULongLong())));
+	}
+
+	BigInt candidate = n + BigInt(1);
+	if (!(candidate.digitAt(0) & 1)) {
+		++candidate;
+	}
+
+	std::vector<bool> composite(WINDOW);
+	for (;;) {
+		// Mark candidate + 2i divisible by p: 2i = -r (mod p), so i = (p - r) * (p + 1) / 2 (mod p)
+		composite.assign(WINDOW, false);
+		for (size_t k = 1; k < primes.size(); ++k) {
+			unsigned long long p = primes[k];
+			unsigned long long r = residue(candidate, p);
+			for (size_t i = (p - r) % p * ((p + 1) / 2) % p; i < WINDOW; i += p) {
+				composite[i] = true;
+			}
+		}
+
+		for (size_t i = 0; i < WINDOW; ++i) {
+			if (composite[i]) {
+				continue;
+			}
+
+			BigInt value = candidate + BigInt(static_cast<long long>(2 * i));
+			if (bailliePSW(value, 0)) {
+				return value;
+			}
+		}
+
+		candidate += BigInt(static_cast<long long>(2 * WINDOW));
+	}
+}
@@ -0,0 +1,14 @@
+/* BigIntPrime
+ * Probable prime testing and prime search for BigInt values */
+
+#pragma once
+#include "BigInt.hpp"
+
+// Checks if n is probably prime
+// Runs trial division, then a Baillie-PSW test (a base 2 strong probable prime
+// test and a strong Lucas test), then extraRounds Miller-Rabin rounds with random bases
+// No composite is known to pass Baillie-PSW alone
+bool isProbablePrime(BigInt const &n, unsigned extraRounds = 0);
+
+// Returns the smallest probable prime greater than n
+BigInt nextPrime(BigInt const &n);
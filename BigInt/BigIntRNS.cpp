@@ -0,0 +1,333 @@
+#include "BigIntRNS.hpp"
+#include <stdexcept> /* std::invalid_argument, std::length_error */
+
+// -------------- Helpers
+namespace {
+	// Each limb holds nine decimal digits
+	const unsigned long long LIMB_BASE = 1000000000;
+
+	/* Returns the primes just below 2^31, largest first
+	 * Sieves [2^31 - 2^18, 2^31) with the primes up to sqrt(2^31), which leaves
+	 * over twelve thousand primes. Built once, on first use */
+	std::vector<uint32_t> const &channelPrimes() {
+		static std::vector<uint32_t> const primes = [] {
+			const unsigned long long top = 1ULL << 31;
+			const unsigned long long width = 1ULL << 18;
+			const unsigned long long bottom = top - width;
+			const unsigned long long root = 46341; // ceil(sqrt(2^31))
+
+			std::vector<bool> smallComposite(root, false);
+			std::vector<bool> composite(width, false);
+			for (unsigned long long p = 2; p < root; ++p) {
+				if (smallComposite[p]) {
+					continue;
+				}
+
+				for (unsigned long long m = p * p; m < root; m += p) {
+					smallComposite[m] = true;
+				}
+				for (unsigned long long m = (bottom + p - 1) / p * p; m < top; m += p) {
+					composite[m - bottom] = true;
+				}
+			}
+
+			std::vector<uint32_t> found;
+			for (unsigned long long i = width; i-- > 0;) {
+				if (!composite[i]) {
+					found.push_back(static_cast<uint32_t>(bottom + i));
+				}
+			}
+
+			return found;
+		}();
+
+		return primes;
+	}
+
+	/* Returns a * b mod p */
+	inline uint32_t mulMod(uint32_t a, uint32_t b, uint32_t p) {
+		return static_cast<uint32_t>(static_cast<unsigned long long>(a) * b % p);
+	}
+
+	/* Returns the inverse of a mod prime p, as a^(p - 2) */
+	uint32_t inverseMod(uint32_t a, uint32_t p) {
+		uint32_t result = 1;
+		for (uint32_t e = p - 2; e; e >>= 1) {
+			if (e & 1) {
+				result = mulMod(result, a, p);
+			}
+			a = mulMod(a, a, p);
+		}
+
+		return result;
+	}
+
+	/* Sets limbs to limbs * factor + addend */
+	void mulAdd(std::vector<unsigned long long> &limbs, unsigned long long factor, unsigned long long addend) {
+		unsigned long long carry = addend;
+		for (unsigned long long &limb : limbs) {
+			carry += limb * factor;
+			limb = carry % LIMB_BASE;
+			carry /= LIMB_BASE;
+		}
+
+		while (carry) {
+			limbs.push_back(carry % LIMB_BASE);
+			carry /= LIMB_BASE;
+		}
+	}
+
+	/* Compares two limb magnitudes without leading zero limbs */
+	short compareLimbs(std::vector<unsigned long long> const &a, std::vector<unsigned long long> const &b) {
+		if (a.size() != b.size()) {
+			return a.size() < b.size() ? -1 : 1;
+		}
+
+		for (size_t i = a.size(); i-- > 0;) {
+			if (a[i] != b[i]) {
+				return a[i] < b[i] ? -1 : 1;
+			}
+		}
+
+		return 0;
+	}
+
+	/* Returns the product of the first channels primes, as limbs */
+	std::vector<unsigned long long> modulusLimbs(size_t channels) {
+		std::vector<uint32_t> const &primes = channelPrimes();
+
+		std::vector<unsigned long long> limbs(1, 1);
+		for (size_t i = 0; i < channels; ++i) {
+			mulAdd(limbs, primes[i], 0);
+		}
+
+		return limbs;
+	}
+}
+
+// -------------- Public
+/* Constructor
+ * Each residue is a Horner pass over the nine digit limbs of value */
+BigIntRNS::BigIntRNS(BigInt const &value, size_t channels) {
+	if (!channels || channels > maxChannels()) {
+		throw std::invalid_argument("Channel count out of range");
+	}
+
+	std::vector<uint32_t> const &primes = channelPrimes();
+	std::vector<unsigned long long> limbs = toLimbs(value);
+
+	m_residues.resize(channels);
+	for (size_t i = 0; i < channels; ++i) {
+		unsigned long long p = primes[i];
+		unsigned long long residue = 0;
+		for (size_t j = limbs.size(); j-- > 0;) {
+			residue = (residue * LIMB_BASE + limbs[j]) % p;
+		}
+
+		if (value.m_isNegative && residue) {
+			residue = p - residue;
+		}
+		m_residues[i] = static_cast<uint32_t>(residue);
+	}
+}
+
+/* Addition assignment */
+BigIntRNS &BigIntRNS::operator+=(BigIntRNS const &other) {
+	checkChannels(other);
+
+	std::vector<uint32_t> const &primes = channelPrimes();
+	for (size_t i = 0; i < m_residues.size(); ++i) {
+		uint32_t sum = m_residues[i] + other.m_residues[i];
+		m_residues[i] = sum >= primes[i] ? sum - primes[i] : sum;
+	}
+
+	return *this;
+}
+
+/* Subtraction assignment */
+BigIntRNS &BigIntRNS::operator-=(BigIntRNS const &other) {
+	checkChannels(other);
+
+	std::vector<uint32_t> const &primes = channelPrimes();
+	for (size_t i = 0; i < m_residues.size(); ++i) {
+		uint32_t a = m_residues[i];
+		uint32_t b = other.m_residues[i];
+		m_residues[i] = a >= b ? a - b : a + (primes[i] - b);
+	}
+
+	return *this;
+}
+
+/* Multiplication assignment */
+BigIntRNS &BigIntRNS::operator*=(BigIntRNS const &other) {
+	checkChannels(other);
+
+	std::vector<uint32_t> const &primes = channelPrimes();
+	for (size_t i = 0; i < m_residues.size(); ++i) {
+		m_residues[i] = mulMod(m_residues[i], other.m_residues[i], primes[i]);
+	}
+
+	return *this;
+}
+
+/* Addition */
+BigIntRNS operator+(BigIntRNS lhs, BigIntRNS const &rhs) {
+	return lhs += rhs;
+}
+
+/* Subtraction */
+BigIntRNS operator-(BigIntRNS lhs, BigIntRNS const &rhs) {
+	return lhs -= rhs;
+}
+
+/* Multiplication */
+BigIntRNS operator*(BigIntRNS lhs, BigIntRNS const &rhs) {
+	return lhs *= rhs;
+}
+
+/* Negation */
+BigIntRNS BigIntRNS::operator-() const {
+	BigIntRNS result(*this);
+
+	std::vector<uint32_t> const &primes = channelPrimes();
+	for (size_t i = 0; i < result.m_residues.size(); ++i) {
+		if (result.m_residues[i]) {
+			result.m_residues[i] = primes[i] - result.m_residues[i];
+		}
+	}
+
+	return result;
+}
+
+/* Equality */
+bool BigIntRNS::operator==(BigIntRNS const &other) const {
+	return m_residues == other.m_residues;
+}
+
+/* Inequality */
+bool BigIntRNS::operator!=(BigIntRNS const &other) const {
+	return !(*this == other);
+}
+
+/* Rebuilds the value from its residues
+ * Garner's algorithm finds the mixed radix digits v[i], so that
+ * value = v[0] + v[1]*p[0] + v[2]*p[0]*p[1] + ..., working only in word size
+ * arithmetic. The digits are then expanded into limbs by Horner's rule.
+ * Values above M / 2 stand for negative values, value - M */
+BigInt BigIntRNS::toBigInt() const {
+	std::vector<uint32_t> const &primes = channelPrimes();
+	size_t channels = m_residues.size();
+
+	std::vector<uint32_t> mixed(channels);
+	for (size_t i = 0; i < channels; ++i) {
+		uint32_t p = primes[i];
+
+		// The value of the digits found so far, and the product of their primes, both mod p
+		uint32_t partial = 0;
+		uint32_t product = 1;
+		for (size_t j = 0; j < i; ++j) {
+			partial = static_cast<uint32_t>((partial + static_cast<unsigned long long>(mixed[j]) * product) % p);
+			product = mulMod(product, primes[j] % p, p);
+		}
+
+		uint32_t difference = m_residues[i] >= partial ? m_residues[i] - partial : m_residues[i] + (p - partial);
+		mixed[i] = mulMod(difference, inverseMod(product, p), p);
+	}
+
+	std::vector<unsigned long long> limbs(1, 0);
+	for (size_t i = channels; i-- > 0;) {
+		mulAdd(limbs, primes[i], mixed[i]);
+	}
+	while (limbs.size() > 1 && !limbs.back()) {
+		limbs.pop_back();
+	}
+
+	std::vector<unsigned long long> modulus = modulusLimbs(channels);
+	std::vector<unsigned long long> doubled(limbs);
+	mulAdd(doubled, 2, 0);
+	if (compareLimbs(doubled, modulus) <= 0) {
+		return fromLimbs(limbs, false);
+	}
+
+	// Negative: the magnitude is M - value
+	unsigned long long borrow = 0;
+	for (size_t i = 0; i < modulus.size(); ++i) {
+		unsigned long long subtrahend = borrow + (i < limbs.size() ? limbs[i] : 0);
+		borrow = modulus[i] < subtrahend;
+		modulus[i] = modulus[i] + borrow * LIMB_BASE - subtrahend;
+	}
+
+	return fromLimbs(modulus, true);
+}
+
+/* Returns the number of channels */
+size_t BigIntRNS::channels() const {
+	return m_residues.size();
+}
+
+/* Returns the channels needed to hold any value of up to digits decimal digits
+ * Every prime exceeds 2^30, and each digit takes under 3.322 bits, plus one
+ * bit for the sign */
+size_t BigIntRNS::channelsFor(size_t digits) {
+	size_t channels = (digits * 3322 / 1000 + 1) / 30 + 1;
+	if (channels > maxChannels()) {
+		throw std::length_error("Too many digits for BigIntRNS");
+	}
+
+	return channels;
+}
+
+/* Returns the largest number of channels available */
+size_t BigIntRNS::maxChannels() {
+	return channelPrimes().size();
+}
+
+/* Returns M, the product of the first channels primes */
+BigInt BigIntRNS::modulus(size_t channels) {
+	if (channels > maxChannels()) {
+		throw std::invalid_argument("Channel count out of range");
+	}
+
+	return fromLimbs(modulusLimbs(channels), false);
+}
+
+// -------------- Private
+/* Throws std::invalid_argument unless both use the same channels */
+void BigIntRNS::checkChannels(BigIntRNS const &other) const {
+	if (m_residues.size() != other.m_residues.size()) {
+		throw std::invalid_argument("BigIntRNS channel counts differ");
+	}
+}
+
+/* Splits a magnitude into nine digit limbs, least significant first */
+std::vector<unsigned long long> BigIntRNS::toLimbs(BigInt const &value) {
+	BigInt::Digits const &digits = value.m_value;
+	size_t size = digits.size();
+
+	std::vector<unsigned long long> limbs((size + 8) / 9, 0);
+	for (size_t limb = 0, start = 0; limb < limbs.size(); ++limb, start += 9) {
+		size_t end = start + 9 < size ? start + 9 : size;
+		for (size_t idx = end; idx-- > start;) {
+			limbs[limb] = limbs[limb] * 10 + digits[idx];
+		}
+	}
+
+	return limbs;
+}
+
+/* Builds a BigInt from nine digit limbs, least significant first */
+BigInt BigIntRNS::fromLimbs(std::vector<unsigned long long> const &limbs, bool isNegative) {
+	BigInt result;
+	result.m_value = BigInt::Digits(limbs.size() * 9);
+	for (unsigned long long limb : limbs) {
+		for (int d = 0; d < 9; ++d) {
+			result.m_value.push(static_cast<char>(limb % 10));
+			limb /= 10;
+		}
+	}
+
+	result.trimLeadingZeros();
+	result.m_isNegative = isNegative && !result.isZero();
+
+	return result;
+}
@@ -0,0 +1,66 @@
+/* BigIntRNS
+ * A BigInt held as its residues modulo a set of word size primes
+ *
+ * Channel i holds the value modulo the ith prime below 2^31. Addition,
+ * subtraction and multiplication act on each channel independently, with no
+ * carries between them, so long chains of them stay cheap. Converting back
+ * uses Garner's algorithm to rebuild the value from its residues.
+ *
+ * Values are exact only while they stay within the range of the channels:
+ * |value| <= (M - 1) / 2, where M is the product of the primes used.
+ * Results outside of that range wrap around silently */
+
+#pragma once
+#include <vector> /* std::vector */
+#include <cstdint> /* uint32_t */
+#include "BigInt.hpp"
+
+class BigIntRNS {
+public:
+/* Constructors */
+	// Converts value using the given number of channels
+	// Throws std::invalid_argument if channels is 0 or more than maxChannels()
+	BigIntRNS(BigInt const &value, size_t channels);
+
+/* Operators */
+	BigIntRNS &operator+=(BigIntRNS const &other);
+	BigIntRNS &operator-=(BigIntRNS const &other);
+	BigIntRNS &operator*=(BigIntRNS const &other);
+
+	friend BigIntRNS operator+(BigIntRNS lhs, BigIntRNS const &rhs);
+	friend BigIntRNS operator-(BigIntRNS lhs, BigIntRNS const &rhs);
+	friend BigIntRNS operator*(BigIntRNS lhs, BigIntRNS const &rhs);
+	BigIntRNS operator-() const;
+
+	// Equal residues are equal values while both are within range
+	bool operator==(BigIntRNS const &other) const;
+	bool operator!=(BigIntRNS const &other) const;
+
+/* Function members */
+	// Rebuilds the value from its residues
+	BigInt toBigInt() const;
+
+	size_t channels() const;
+
+	// Returns the channels needed to hold any value of up to digits decimal digits
+	// Throws std::length_error if that is more than maxChannels()
+	static size_t channelsFor(size_t digits);
+
+	// Returns the largest number of channels available
+	static size_t maxChannels();
+
+	// Returns M, the product of the first channels primes
+	static BigInt modulus(size_t channels);
+
+private:
+	// Residue of the value modulo each prime, in channel order
+	std::vector<uint32_t> m_residues;
+
+	// Throws std::invalid_argument unless both use the same channels
+	void checkChannels(BigIntRNS const &other) const;
+
+	// Splits a magnitude into nine digit limbs, least significant first
+	static std::vector<unsigned long long> toLimbs(BigInt const &value);
+	// Builds a BigInt from nine digit limbs, least significant first
+	static BigInt fromLimbs(std::vector<unsigned long long> const &limbs, bool isNegative);
+};
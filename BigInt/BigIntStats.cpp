@@ -0,0 +1,121 @@
+#include "BigIntStats.hpp"
+#include <atomic> /* std::atomic */
+#include <iomanip> /* std::setw */
+
+// -------------- Helpers
+namespace {
+	// Live counters, updated with relaxed atomics so recording never blocks
+	struct Counters {
+		std::atomic<unsigned long long> calls;
+		std::atomic<unsigned long long> digitOps;
+		std::atomic<unsigned long long> allocations;
+		std::atomic<unsigned long long> bytesAllocated;
+		std::atomic<unsigned long long> sizeHistogram[BigIntOpStats::HISTOGRAM_BUCKETS];
+	};
+
+	Counters counters[static_cast<size_t>(BigIntOp::Count)];
+
+	// Innermost operation running on this thread
+	thread_local BigIntOp current = BigIntOp::Other;
+
+	/* Returns the histogram bucket for an operand size */
+	size_t bucket(size_t digits) {
+		size_t b = 0;
+		for (; digits && b < BigIntOpStats::HISTOGRAM_BUCKETS - 1; digits >>= 1) {
+			++b;
+		}
+
+		return b;
+	}
+}
+
+// -------------- Public
+/* Returns a copy of the current counters
+ * Each counter is read atomically, though not all at the same instant */
+BigIntStatsSnapshot BigIntStats::snapshot() {
+	BigIntStatsSnapshot s;
+
+	for (size_t i = 0; i < static_cast<size_t>(BigIntOp::Count); ++i) {
+		s.ops[i].calls = counters[i].calls.load(std::memory_order_relaxed);
+		s.ops[i].digitOps = counters[i].digitOps.load(std::memory_order_relaxed);
+		s.ops[i].allocations = counters[i].allocations.load(std::memory_order_relaxed);
+		s.ops[i].bytesAllocated = counters[i].bytesAllocated.load(std::memory_order_relaxed);
+		for (size_t b = 0; b < BigIntOpStats::HISTOGRAM_BUCKETS; ++b) {
+			s.ops[i].sizeHistogram[b] = counters[i].sizeHistogram[b].load(std::memory_order_relaxed);
+		}
+	}
+
+	return s;
+}
+
+/* Sets every counter to 0 */
+void BigIntStats::reset() {
+	for (Counters &c : counters) {
+		c.calls.store(0, std::memory_order_relaxed);
+		c.digitOps.store(0, std::memory_order_relaxed);
+		c.allocations.store(0, std::memory_order_relaxed);
+		c.bytesAllocated.store(0, std::memory_order_relaxed);
+		for (auto &b : c.sizeHistogram) {
+			b.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+/* Returns the name of an operation */
+char const *BigIntStats::name(BigIntOp op) {
+	switch (op) {
+	case BigIntOp::Add: return "operator+";
+	case BigIntOp::Multiply: return "operator*";
+	case BigIntOp::Divide: return "divMod";
+	case BigIntOp::Compare: return "compare";
+	case BigIntOp::SetValue: return "setValue";
+	case BigIntOp::ToString: return "toString";
+	case BigIntOp::TrimLeadingZeros: return "trimLeadingZeros";
+	case BigIntOp::Other: return "other";
+	case BigIntOp::Count: break;
+	}
+
+	return "unknown";
+}
+
+/* Adds one call to the counters of op */
+void BigIntStats::record(BigIntOp op, size_t digits, size_t digitOps) {
+	Counters &c = counters[static_cast<size_t>(op)];
+
+	c.calls.fetch_add(1, std::memory_order_relaxed);
+	c.digitOps.fetch_add(digitOps, std::memory_order_relaxed);
+	c.sizeHistogram[bucket(digits)].fetch_add(1, std::memory_order_relaxed);
+}
+
+/* Charges an allocation to the operation running on this thread */
+void BigIntStats::allocated(size_t bytes) {
+	Counters &c = counters[static_cast<size_t>(current)];
+
+	c.allocations.fetch_add(1, std::memory_order_relaxed);
+	c.bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/* Marks op as running on this thread */
+BigIntStats::Scope::Scope(BigIntOp op) : m_previous(current) {
+	current = op;
+}
+
+/* Restores the operation that was running before */
+BigIntStats::Scope::~Scope() {
+	current = m_previous;
+}
+
+// -------------- Friend
+/* Insertion operator
+ * Outputs one line per operation: name, calls, digit ops, allocations, bytes allocated */
+std::ostream &operator<<(std::ostream &out, BigIntStatsSnapshot const &s) {
+	for (size_t i = 0; i < static_cast<size_t>(BigIntOp::Count); ++i) {
+		out << std::setw(18) << std::left << BigIntStats::name(static_cast<BigIntOp>(i)) << std::right
+			<< " calls " << std::setw(12) << s.ops[i].calls
+			<< " digitOps " << std::setw(14) << s.ops[i].digitOps
+			<< " allocs " << std::setw(12) << s.ops[i].allocations
+			<< " bytes " << std::setw(14) << s.ops[i].bytesAllocated << '\n';
+	}
+
+	return out;
+}
@@ -0,0 +1,121 @@
+/* BigIntStats
+ * Optional operation counters and allocation tracing for BigInt
+ *
+ * Counting is compiled in only when BIGINT_STATS is defined. Otherwise the
+ * BIGINT_RECORD and BIGINT_SCOPE probes in BigInt.cpp expand to nothing, their
+ * arguments are never evaluated, BigIntAllocator is std::allocator, and
+ * snapshots stay at zero.
+ *
+ * With it defined, BigInt's digits and scratch buffers are allocated through
+ * BigIntCountingAllocator, and every allocation is charged to the innermost
+ * operation running on the allocating thread, or to Other outside any. The
+ * std::string toString returns is the caller's and isn't counted */
+
+#pragma once
+#include <cstddef> /* size_t */
+#include <memory> /* std::allocator */
+#include <iostream>
+
+#ifdef BIGINT_STATS
+#define BIGINT_RECORD(op, digits, digitOps) BigIntStats::record(op, digits, digitOps)
+#define BIGINT_SCOPE(op) BigIntStats::Scope bigIntStatsScope(op)
+#else
+#define BIGINT_RECORD(op, digits, digitOps) ((void)0)
+#define BIGINT_SCOPE(op) ((void)0)
+#endif
+
+// Instrumented BigInt operations
+enum class BigIntOp {
+	Add, // operator+, and through it subtraction and the assignment forms
+	Multiply, // operator*
+	Divide, // divMod, and through it operator/ and operator%
+	Compare, // compare, and through it the comparative operators
+	SetValue, // setValue
+	ToString, // toString
+	TrimLeadingZeros, // trimLeadingZeros
+	Other, // Allocations made outside every operation above, such as copies
+	Count
+};
+
+// Counters for a single operation
+struct BigIntOpStats {
+	// Operand sizes are bucketed by bit length of the digit count,
+	// so bucket b holds sizes in [2^(b - 1), 2^b)
+	static const size_t HISTOGRAM_BUCKETS = 32;
+
+	unsigned long long calls;
+	unsigned long long digitOps; // Digits read or written
+	unsigned long long allocations; // Allocations made while the operation ran
+	unsigned long long bytesAllocated; // Bytes those allocations asked for
+	unsigned long long sizeHistogram[HISTOGRAM_BUCKETS];
+};
+
+// Counters for every operation at one point in time
+struct BigIntStatsSnapshot {
+	BigIntOpStats ops[static_cast<size_t>(BigIntOp::Count)];
+
+	BigIntOpStats const &operator[](BigIntOp op) const { return ops[static_cast<size_t>(op)]; }
+
+	// Outputs one line per operation: name, calls, digit ops, allocations, bytes allocated
+	friend std::ostream &operator<<(std::ostream &os, BigIntStatsSnapshot const &s);
+};
+
+class BigIntStats {
+public:
+	// Returns a copy of the current counters
+	static BigIntStatsSnapshot snapshot();
+	// Sets every counter to 0
+	static void reset();
+
+	// Returns the name of an operation, such as "operator+"
+	static char const *name(BigIntOp op);
+
+	// Adds one call to the counters of op. Safe to call from any thread
+	static void record(BigIntOp op, size_t digits, size_t digitOps);
+	// Charges an allocation to the operation running on this thread
+	static void allocated(size_t bytes);
+
+	// Marks op as running on this thread until destroyed, so its allocations are charged to it
+	class Scope {
+	public:
+		explicit Scope(BigIntOp op);
+		~Scope();
+		Scope(Scope const &) = delete;
+		Scope &operator=(Scope const &) = delete;
+
+	private:
+		BigIntOp m_previous; // Operation that was running before, restored on exit
+	};
+};
+
+// std::allocator that reports each allocation to BigIntStats
+template <class T>
+class BigIntCountingAllocator {
+public:
+	using value_type = T;
+
+	BigIntCountingAllocator() = default;
+	template <class U>
+	BigIntCountingAllocator(BigIntCountingAllocator<U> const &) {};
+
+	T *allocate(size_t count) {
+		T *p = std::allocator<T>().allocate(count);
+		BigIntStats::allocated(count * sizeof(T));
+		return p;
+	}
+	void deallocate(T *p, size_t count) { std::allocator<T>().deallocate(p, count); }
+
+	template <class U>
+	bool operator==(BigIntCountingAllocator<U> const &) const { return true; }
+	template <class U>
+	bool operator!=(BigIntCountingAllocator<U> const &) const { return false; }
+};
+
+// Allocator for BigInt's digits and scratch buffers
+#ifdef BIGINT_STATS
+template <class T>
+using BigIntAllocator = BigIntCountingAllocator<T>;
+#else
+template <class T>
+using BigIntAllocator = std::allocator<T>;
+#endif
@@ -0,0 +1,280 @@
+#include "BigRational.hpp"
+#include "BigIntMath.hpp" /* gcd */
+#include <stdexcept> /* std::invalid_argument */
+#include <algorithm> /* std::max */
+
+// Operations allowed to pile up before a batched reduction
+static const unsigned REDUCE_INTERVAL = 16;
+// Denominator length (in digits) which forces a reduction regardless
+static const size_t REDUCE_DIGITS = 1024;
+
+// -------------- Public
+/* Default constructor
+ * Sets value to 0/1 */
+BigRational::BigRational() : m_denominator(1), m_reduced(true), m_pending(0) {}
+
+/* Constructor with numerator and optional denominator
+ * Throws std::invalid_argument if denominator is 0 */
+BigRational::BigRational(BigInt const &numerator, BigInt const &denominator)
+	: m_numerator(numerator), m_denominator(denominator), m_reduced(false), m_pending(0) {
+	if (!m_denominator.sign()) {
+		throw std::invalid_argument("Denominator must not be zero");
+	}
+
+	// Keep the sign on the numerator
+	if (m_denominator.sign() < 0) {
+		m_numerator = -m_numerator;
+		m_denominator = -m_denominator;
+	}
+}
+
+/* Constructor with long long param */
+BigRational::BigRational(long long value) : m_numerator(value), m_denominator(1), m_reduced(true), m_pending(0) {}
+
+/* Constructor with string param in the form "n" or "n/d"
+ * Throws std::invalid_argument if string invalid value */
+BigRational::BigRational(std::string const &s) : BigRational() {
+	size_t slash = s.find('/');
+	std::string numerator = s.substr(0, slash);
+	std::string denominator = slash == std::string::npos ? "1" : s.substr(slash + 1);
+
+	if (numerator.empty() || denominator.empty()) {
+		throw std::invalid_argument(std::string("Value must be a fraction: ") + s);
+	}
+
+	*this = BigRational(BigInt(numerator), BigInt(denominator));
+}
+
+/* Checks if two values are equal
+ * Fractions already in lowest terms are compared field by field */
+bool BigRational::operator==(BigRational const &other) const {
+	if (m_reduced && other.m_reduced) {
+		return m_numerator == other.m_numerator && m_denominator == other.m_denominator;
+	}
+
+	return compare(other) == 0;
+}
+
+/* Checks if two values are not equal */
+bool BigRational::operator!=(BigRational const &other) const {
+	return !(*this == other);
+}
+
+/* Checks if one value is less than the other */
+bool BigRational::operator<(BigRational const &other) const {
+	return compare(other) == -1;
+}
+
+/* Checks if one value is greater than the other */
+bool BigRational::operator>(BigRational const &other) const {
+	return compare(other) == 1;
+}
+
+/* Checks if one value is less than or equal to the other */
+bool BigRational::operator<=(BigRational const &other) const {
+	return compare(other) != 1;
+}
+
+/* Checks if one value is greater than or equal to the other */
+bool BigRational::operator>=(BigRational const &other) const {
+	return compare(other) != -1;
+}
+
+/* Adds two fractions
+ * Equal denominators only add numerators, otherwise a/b + c/d = (ad + cb) / bd */
+BigRational BigRational::operator+(BigRational const &other) const {
+	unsigned pending = std::max(m_pending, other.m_pending) + 1;
+
+	if (m_denominator == other.m_denominator) {
+		return BigRational(m_numerator + other.m_numerator, BigInt(m_denominator), pending);
+	}
+
+	return BigRational(m_numerator * other.m_denominator + other.m_numerator * m_denominator,
+		m_denominator * other.m_denominator, pending);
+}
+
+/* Negates the value
+ * Zero is left as it is, BigInt's negation would give it a sign that == sees */
+BigRational BigRational::operator-() const {
+	BigRational buffer(*this);
+	if (m_numerator.sign()) {
+		buffer.m_numerator = -buffer.m_numerator;
+	}
+
+	return buffer;
+}
+
+/* Subtracts other from this */
+BigRational BigRational::operator-(BigRational const &other) const {
+	return *this + -other;
+}
+
+/* Multiplies two fractions */
+BigRational BigRational::operator*(BigRational const &other) const {
+	return BigRational(m_numerator * other.m_numerator, m_denominator * other.m_denominator,
+		std::max(m_pending, other.m_pending) + 1);
+}
+
+/* Divides this by other
+ * Throws std::invalid_argument on division by zero */
+BigRational BigRational::operator/(BigRational const &other) const {
+	short sign = other.m_numerator.sign();
+	if (!sign) {
+		throw std::invalid_argument("Division by zero");
+	}
+
+	// Move the divisor's sign onto the numerator so the denominator stays positive
+	BigInt numerator = m_numerator * other.m_denominator;
+	BigInt denominator = m_denominator * other.m_numerator;
+	if (sign < 0) {
+		numerator = -numerator;
+		denominator = -denominator;
+	}
+
+	return BigRational(std::move(numerator), std::move(denominator), std::max(m_pending, other.m_pending) + 1);
+}
+
+/* Addition assignment */
+BigRational &BigRational::operator+=(BigRational const &other) {
+	return *this = *this + other;
+}
+
+/* Subtraction assignment */
+BigRational &BigRational::operator-=(BigRational const &other) {
+	return *this = *this - other;
+}
+
+/* Multiplication assignment */
+BigRational &BigRational::operator*=(BigRational const &other) {
+	return *this = *this * other;
+}
+
+/* Division assignment */
+BigRational &BigRational::operator/=(BigRational const &other) {
+	return *this = *this / other;
+}
+
+/* Returns the reduced numerator, which carries the sign */
+BigInt const &BigRational::numerator() const {
+	normalize();
+
+	return m_numerator;
+}
+
+/* Returns the reduced denominator, which is always positive */
+BigInt const &BigRational::denominator() const {
+	normalize();
+
+	return m_denominator;
+}
+
+/* Returns the value as "n" or "n/d" in lowest terms */
+std::string BigRational::toString() const {
+	normalize();
+
+	if (m_denominator == BigInt(1)) {
+		return m_numerator.toString();
+	}
+
+	return m_numerator.toString() + '/' + m_denominator.toString();
+}
+
+/* Compares value to other value without reducing either
+ *
+ * @return       -1 if this is less than other
+ *                0 if this is equal to other
+ *                1 if this is greater than other */
+short BigRational::compare(BigRational const &other) const {
+	short sign = m_numerator.sign();
+	short otherSign = other.m_numerator.sign();
+
+	// Signs differ or both are zero
+	if (sign != otherSign) {
+		return sign < otherSign ? -1 : 1;
+	}
+
+	if (!sign) {
+		return 0;
+	}
+
+	if (m_denominator == other.m_denominator) {
+		return m_numerator.compare(other.m_numerator);
+	}
+
+	// a/b vs c/d is ad vs cb. A product of x and y digits has x + y - 1 or x + y digits,
+	// so lengths alone settle the comparison when they are far enough apart
+	size_t left = m_numerator.digitCount() + other.m_denominator.digitCount();
+	size_t right = other.m_numerator.digitCount() + m_denominator.digitCount();
+
+	if (left > right + 1) {
+		return sign;
+	}
+
+	if (right > left + 1) {
+		return -sign;
+	}
+
+	return (m_numerator * other.m_denominator).compare(other.m_numerator * m_denominator);
+}
+
+/* Reduces the fraction to lowest terms now */
+void BigRational::normalize() const {
+	if (m_reduced) {
+		return;
+	}
+
+	BigInt divisor = gcd(m_numerator, m_denominator);
+	if (divisor != BigInt(1)) {
+		m_numerator /= divisor;
+		m_denominator /= divisor;
+	}
+
+	m_reduced = true;
+	m_pending = 0;
+}
+
+// -------------- Friend
+/* Insertion operator
+ * Outputs value as "n" or "n/d" in lowest terms */
+std::ostream &operator<<(std::ostream &out, BigRational const &r) {
+	out << r.toString();
+
+	return out;
+}
+
+/* Extraction operator
+ * If invalid input, istream set to fail and value set to 0
+ * else sets value to input */
+std::istream &operator>>(std::istream &in, BigRational &r) {
+	std::string s;
+	in >> s;
+
+	try {
+		r = BigRational(s);
+	}
+	catch (std::invalid_argument &) {
+		r = BigRational();
+		in.setstate(std::ios_base::badbit);
+	}
+
+	return in;
+}
+
+// -------------- Private
+/* Builds an unreduced result which inherits the pending count of its operands */
+BigRational::BigRational(BigInt &&numerator, BigInt &&denominator, unsigned pending)
+	: m_numerator(std::move(numerator)), m_denominator(std::move(denominator)), m_reduced(false), m_pending(pending) {
+	reduceIfDue();
+}
+
+/* Reduces if enough operations are pending or the denominator is too long
+ * Integers (denominator 1) are always in lowest terms */
+void BigRational::reduceIfDue() {
+	if (m_denominator == BigInt(1)) {
+		m_reduced = true;
+		m_pending = 0;
+	}
+	else if (m_pending >= REDUCE_INTERVAL || m_denominator.digitCount() > REDUCE_DIGITS) {
+		normalize();
+	}
+}
@@ -0,0 +1,87 @@
+/* BigRational
+ * An exact fraction of two BigInt values
+ *
+ * Reduction by gcd is lazy: results are left unreduced and reduced in a batch
+ * once enough operations are pending or the denominator grows too long,
+ * or whenever the value is read (numerator, denominator, output) */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include "BigInt.hpp"
+
+class BigRational {
+public:
+/* Constructors */
+	// Default constructor
+	// Sets value to 0/1
+	BigRational();
+	// Constructor with numerator and optional denominator
+	// Throws std::invalid_argument if denominator is 0
+	BigRational(BigInt const &numerator, BigInt const &denominator = BigInt(1));
+	// Constructor with long long param
+	BigRational(long long);
+	// Constructor with string param in the form "n" or "n/d"
+	// Throws std::invalid_argument if string invalid value
+	BigRational(std::string const &);
+
+/* Comparative operators */
+	bool operator==(BigRational const &) const;
+	bool operator!=(BigRational const &) const;
+	bool operator<(BigRational const &) const;
+	bool operator>(BigRational const &) const;
+	bool operator<=(BigRational const &) const;
+	bool operator>=(BigRational const &) const;
+
+/* Arithmatic operators */
+	BigRational operator+(BigRational const &) const;
+	BigRational operator-() const;
+	BigRational operator-(BigRational const &) const;
+	BigRational operator*(BigRational const &) const;
+	// Throws std::invalid_argument on division by zero
+	BigRational operator/(BigRational const &) const;
+
+/* Assignment operators */
+	BigRational &operator+=(BigRational const &);
+	BigRational &operator-=(BigRational const &);
+	BigRational &operator*=(BigRational const &);
+	BigRational &operator/=(BigRational const &);
+
+/* ios operators */
+	friend std::ostream &operator<<(std::ostream &os, BigRational const &r);
+	friend std::istream &operator>>(std::istream &is, BigRational &r);
+
+/* Function members */
+	// Returns the reduced numerator, which carries the sign
+	BigInt const &numerator() const;
+	// Returns the reduced denominator, which is always positive
+	BigInt const &denominator() const;
+
+	// Returns the value as "n" or "n/d" in lowest terms
+	std::string toString() const;
+
+	// Compares value to other value
+	//
+	// -1 if this is less than other
+	//  0 if this is equal to other
+	//  1 if this is greater than other
+	short compare(BigRational const &) const;
+
+	// Reduces the fraction to lowest terms now
+	void normalize() const;
+
+private:
+	// Reduction is logically const, so the fraction may be rewritten on read
+	mutable BigInt m_numerator;
+	mutable BigInt m_denominator;
+	// Is the fraction known to be in lowest terms?
+	mutable bool m_reduced;
+	// Operations applied since the last reduction
+	mutable unsigned m_pending;
+
+	// Builds an unreduced result which inherits the pending count of its operands
+	BigRational(BigInt &&numerator, BigInt &&denominator, unsigned pending);
+
+	// Reduces if enough operations are pending or the denominator is too long
+	void reduceIfDue();
+};
@@ -0,0 +1,88 @@
+#include "ConcurrentBigIntAccumulator.hpp"
+#include <thread> /* std::thread::hardware_concurrency */
+#include <atomic> /* std::atomic */
+
+// -------------- Public
+/* Constructor
+ * Uses one shard per hardware thread when shardCount is 0 */
+ConcurrentBigIntAccumulator::ConcurrentBigIntAccumulator(size_t shardCount) {
+	if (!shardCount) {
+		shardCount = std::thread::hardware_concurrency();
+	}
+
+	m_shardCount = shardCount ? shardCount : 1;
+	m_shards.reset(new Shard[m_shardCount]);
+}
+
+/* Adds value to the calling thread's shard */
+void ConcurrentBigIntAccumulator::add(BigInt const &value) {
+	Shard &shard = localShard();
+	std::lock_guard<std::mutex> guard(shard.lock);
+
+	shard.partial += value;
+}
+
+/* Addition assignment */
+ConcurrentBigIntAccumulator &ConcurrentBigIntAccumulator::operator+=(BigInt const &value) {
+	add(value);
+
+	return *this;
+}
+
+/* Returns the total of every add completed before the call */
+BigInt ConcurrentBigIntAccumulator::sum() const {
+	auto guards = lockAll();
+
+	BigInt total;
+	for (size_t i = 0; i < m_shardCount; ++i) {
+		total += m_shards[i].partial.sum();
+	}
+
+	return total;
+}
+
+/* Returns the total and resets it to 0 in one step
+ * Adds racing with the call land either in the result or in the next total */
+BigInt ConcurrentBigIntAccumulator::exchange() {
+	auto guards = lockAll();
+
+	BigInt total;
+	for (size_t i = 0; i < m_shardCount; ++i) {
+		total += m_shards[i].partial.sum();
+		m_shards[i].partial.clear();
+	}
+
+	return total;
+}
+
+/* Resets the total to 0 */
+void ConcurrentBigIntAccumulator::reset() {
+	exchange();
+}
+
+/* Returns the number of shards */
+size_t ConcurrentBigIntAccumulator::shardCount() const {
+	return m_shardCount;
+}
+
+// -------------- Private
+/* Returns the shard assigned to the calling thread
+ * Threads are numbered in the order they first add, then spread over the shards */
+ConcurrentBigIntAccumulator::Shard &ConcurrentBigIntAccumulator::localShard() {
+	static std::atomic<size_t> nextThread(0);
+	thread_local size_t const thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+
+	return m_shards[thread % m_shardCount];
+}
+
+/* Locks every shard
+ * Locks are always taken in shard order, so concurrent readers can't deadlock */
+std::vector<std::unique_lock<std::mutex>> ConcurrentBigIntAccumulator::lockAll() const {
+	std::vector<std::unique_lock<std::mutex>> guards;
+	guards.reserve(m_shardCount);
+	for (size_t i = 0; i < m_shardCount; ++i) {
+		guards.emplace_back(m_shards[i].lock);
+	}
+
+	return guards;
+}
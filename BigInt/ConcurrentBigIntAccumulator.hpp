@@ -0,0 +1,57 @@
+/* ConcurrentBigIntAccumulator
+ * A running BigInt total which many threads can add to at once
+ *
+ * Each thread is assigned one of several shards, each holding a partial sum
+ * behind its own lock, so threads on different shards never contend.
+ * Partial sums are BigIntAccumulators, so adds don't carry or reallocate.
+ * Reading locks every shard before summing them, so a read sees each
+ * completed add exactly once and never half of one */
+
+#pragma once
+#include <mutex> /* std::mutex */
+#include <memory> /* std::unique_ptr */
+#include <vector> /* std::vector */
+#include "BigInt.hpp"
+#include "BigIntAccumulator.hpp"
+
+class ConcurrentBigIntAccumulator {
+public:
+/* Constructors */
+	// Uses one shard per hardware thread when shardCount is 0
+	explicit ConcurrentBigIntAccumulator(size_t shardCount = 0);
+
+	ConcurrentBigIntAccumulator(ConcurrentBigIntAccumulator const &) = delete;
+	ConcurrentBigIntAccumulator &operator=(ConcurrentBigIntAccumulator const &) = delete;
+
+/* Function members */
+	// Adds value to the calling thread's shard
+	void add(BigInt const &value);
+	ConcurrentBigIntAccumulator &operator+=(BigInt const &value);
+
+	// Returns the total of every add completed before the call
+	BigInt sum() const;
+
+	// Returns the total and resets it to 0 in one step
+	BigInt exchange();
+
+	// Resets the total to 0
+	void reset();
+
+	size_t shardCount() const;
+
+private:
+	// Padded to its own cache line so neighbouring shards don't false share
+	struct alignas(64) Shard {
+		mutable std::mutex lock;
+		BigIntAccumulator partial;
+	};
+
+	std::unique_ptr<Shard[]> m_shards;
+	size_t m_shardCount;
+
+	// Returns the shard assigned to the calling thread
+	Shard &localShard();
+
+	// Locks every shard, in shard order
+	std::vector<std::unique_lock<std::mutex>> lockAll() const;
+};
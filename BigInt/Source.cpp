@@ -1,11 +1,29 @@
 /* BigIntTester
- * A program to test features of the BigInt class */
+ * A program to test features of the BigInt class
+ * Build it with the other BigInt sources and BigCalc/Evaluator.cpp, linking the threads library */
 
 #include <iostream>
 #include <string>
-#include <limits.h> /* INT_MAX */
+#include <limits.h> /* INT_MAX, ULLONG_MAX, LLONG_MIN, LLONG_MAX */
+#include <stdint.h> /* SIZE_MAX */
 #include <exception>
+#include <sstream> /* std::ostringstream */
+#include <random> /* std::mt19937_64 */
+#include <cmath> /* std::ldexp, HUGE_VAL */
+#include <vector>
+#include <thread> /* std::thread */
+#include <stdexcept> /* std::length_error, std::invalid_argument */
 #include "BigInt.hpp"
+#include "BigIntMath.hpp"
+#include "BigIntPrime.hpp"
+#include "BigIntAccumulator.hpp"
+#include "ConcurrentBigIntAccumulator.hpp"
+#include "BigIntRNS.hpp"
+#include "BigRational.hpp"
+#include "BigDecimal.hpp"
+#include "BigIntConstants.hpp"
+#include "BigIntStats.hpp"
+#include "../BigCalc/Evaluator.hpp"
 
 using namespace std;
 
@@ -62,6 +80,504 @@ int main(void) {
 	cout << ++result << endl; // 3 (Pre Inc)
 	cout << endl;
 
+	// Negating zero gives the same zero
+	result = -BigInt(0);
+	cout << (result == BigInt(0) && result.sign() == 0 && result.toString() == "0") << ' ' << result << endl; // 0
+	cout << endl;
+
+	// Test pow
+	result = pow(BigInt(-2), 63);
+	cout << (result == BigInt("-9223372036854775808")) << ' ' << result << endl;
+	result = pow(BigInt(-10), 20);
+	cout << (result == BigInt("100000000000000000000")) << ' ' << result << endl;
+	result = pow(BigInt(12345), 0);
+	cout << (result == BigInt(1)) << ' ' << result << endl;
+
+	// Test pow throwing rather than overflowing the digit count
+	try {
+		pow(BigInt(10), ULLONG_MAX);
+	}
+	catch (length_error &e) {
+		cout << "Purposefully threw exception: " << e.what() << endl;
+	}
+	try {
+		pow(BigInt(100), 1ULL << 62);
+	}
+	catch (length_error &e) {
+		cout << "Purposefully threw exception: " << e.what() << endl;
+	}
+	try {
+		pow(BigInt("123456789"), ULLONG_MAX / 4);
+	}
+	catch (length_error &e) {
+		cout << "Purposefully threw exception: " << e.what() << endl;
+	}
+	cout << endl;
+
+	// Test factorial, binomial, fibonacci and primorial against known values and plain loops
+	result = factorial(25);
+	cout << (result == BigInt("15511210043330985984000000")) << ' ' << result << endl;
+	result = binomial(100, 50);
+	cout << (result == BigInt("100891344545564193334812497256")) << ' ' << result << endl;
+	result = fibonacci(100);
+	cout << (result == BigInt("354224848179261915075")) << ' ' << result << endl;
+	result = primorial(30);
+	cout << (result == BigInt(6469693230LL)) << ' ' << result << endl;
+	{
+		bool matched = factorial(0) == 1 && binomial(5, 6) == 0 && fibonacci(0) == 0;
+		BigInt product(1), previous(0), current(1);
+		for (unsigned long long n = 1; n <= 400 && matched; ++n) {
+			product *= static_cast<long long>(n);
+			BigInt next = previous + current;
+			previous = current;
+			current = next;
+			matched = factorial(n) == product && fibonacci(n) == previous
+				&& binomial(n, n / 3) * factorial(n / 3) * factorial(n - n / 3) == product;
+		}
+		cout << matched << " factorial, fibonacci and binomial match plain loops up to 400" << endl;
+	}
+	result = gcd(pow(BigInt(2), 100) * 243, pow(BigInt(6), 60));
+	cout << (result == BigInt("280159925619463815168")) << ' ' << result << endl;
+	result = isqrt(pow(BigInt(10), 41) + 12345);
+	cout << (result == BigInt("316227766016837933199")) << ' ' << result << endl;
+	cout << endl;
+
+	// Test radix conversion round trips and toDouble rounding
+	{
+		mt19937_64 rng(27);
+		bool roundTrips = true, nativeMatches = true, doublesMatch = true;
+		unsigned radixes[] = { 2, 4, 8, 16, 32 };
+		for (int i = 0; i < 200; ++i) {
+			BigInt value = BigInt::randomBits(rng() % 3000, rng);
+			if (i % 2) {
+				value = -value;
+			}
+			for (unsigned radix : radixes) {
+				roundTrips = roundTrips && BigInt::fromString(value.toString(radix), radix) == value;
+			}
+
+			unsigned long long native = rng() >> (rng() % 64);
+			ostringstream hex;
+			hex << std::hex << native;
+			BigInt fromNative = BigInt::fromULongLong(native);
+			nativeMatches = nativeMatches && fromNative.toString(16) == hex.str() && BigInt::fromString(hex.str(), 16) == fromNative
+				&& fromNative.toULongLong() == native;
+			doublesMatch = doublesMatch && fromNative.toDouble() == static_cast<double>(native);
+		}
+		cout << roundTrips << " toString and fromString round trip in every power of two radix" << endl;
+		cout << nativeMatches << " radix 16 matches std::hex" << endl;
+		cout << doublesMatch << " toDouble rounds 64 bit values as the compiler does" << endl;
+
+		// Halfway cases far above 2^64 round to even
+		BigInt twoTo100 = pow(BigInt(2), 100);
+		double below = (BigInt(9007199254740993LL) * twoTo100).toDouble(); // (2^53 + 1) * 2^100
+		double above = (BigInt(9007199254740995LL) * twoTo100).toDouble(); // (2^53 + 3) * 2^100
+		cout << (below == ldexp(9007199254740992.0, 100) && above == ldexp(9007199254740996.0, 100)) << " toDouble ties to even" << endl;
+		cout << (pow(BigInt(10), 309).toDouble() == HUGE_VAL && (-pow(BigInt(10), 400)).toDouble() == -HUGE_VAL) << " toDouble overflows to infinity" << endl;
+		cout << (BigInt::fromDouble(1e300).toDouble() == 1e300 && BigInt::fromDouble(-2.99) == -2) << " fromDouble truncates exactly" << endl;
+		cout << (BigInt(LLONG_MIN).fitsIn<long long>() && !(BigInt(LLONG_MIN) - 1).fitsIn<long long>() && !BigInt(-1).fitsIn<unsigned>()) << " fitsIn" << endl;
+		try {
+			BigInt::fromString("12", 11);
+		}
+		catch (exception &e) {
+			cout << "Purposefully threw exception: " << e.what() << endl;
+		}
+	}
+	cout << endl;
+
+	// Test isProbablePrime against a sieve, and on composites that fool weaker tests
+	{
+		vector<bool> composite(20000, false);
+		composite[0] = composite[1] = true;
+		bool matched = true;
+		for (long long n = 2; n < 20000; ++n) {
+			for (long long m = n * n; !composite[n] && m < 20000; m += n) {
+				composite[m] = true;
+			}
+			matched = matched && isProbablePrime(BigInt(n)) == !composite[n] && isProbablePrime(BigInt(-n)) == false;
+		}
+		cout << matched << " isProbablePrime matches a sieve below 20000" << endl;
+
+		// Carmichael numbers, base 2 strong pseudoprimes, strong Lucas pseudoprimes, and one that passes Miller-Rabin to bases 2, 3, 5 and 7
+		long long tricky[] = { 561, 1105, 1729, 2465, 2821, 6601, 8911, 41041, 825265, 321197185, 2047, 3277, 4033, 4681, 8321,
+			5459, 5777, 10877, 3215031751LL };
+		bool rejected = true;
+		for (long long n : tricky) {
+			rejected = rejected && !isProbablePrime(BigInt(n), 5);
+		}
+		cout << rejected << " Carmichael numbers and pseudoprimes are rejected" << endl;
+
+		BigInt mersenne127 = pow(BigInt(2), 127) - 1, mersenne521 = pow(BigInt(2), 521) - 1;
+		cout << (isProbablePrime(mersenne127) && isProbablePrime(mersenne521) && !isProbablePrime(pow(BigInt(2), 128) + 1)
+			&& !isProbablePrime(mersenne127 * mersenne521)) << " Mersenne primes and large composites" << endl;
+
+		result = nextPrime(pow(BigInt(10), 20));
+		cout << (result == BigInt("100000000000000000039")) << ' ' << result << endl;
+		cout << (nextPrime(BigInt(-5)) == 2 && nextPrime(BigInt(2)) == 3 && nextPrime(BigInt(7919)) == 7927) << " nextPrime of small values" << endl;
+	}
+	cout << endl;
+
+	// Test BigIntAccumulator against a plain BigInt sum
+	{
+		BigIntAccumulator total;
+		BigInt expected;
+		mt19937_64 rng(33);
+		bool matched = true;
+		for (int i = 0; i < 20000; ++i) {
+			BigInt value = BigInt::randomBits(rng() % 600, rng);
+			switch (rng() % 4) {
+			case 0: total += value; expected += value; break;
+			case 1: total -= value; expected -= value; break;
+			case 2: total.add(-value); expected -= value; break;
+			case 3: total.subtract(-value); expected += value; break;
+			}
+			if (i % 1000 == 0) {
+				matched = matched && total.sum() == expected;
+			}
+		}
+		cout << (matched && total.sum() == expected) << " 20000 signed adds match a BigInt sum" << endl;
+
+		// All nines carry through every limb, and a total that cancels to zero has no sign
+		BigInt nines = pow(BigInt(10), 200) - 1;
+		total.clear();
+		for (int i = 0; i < 1000; ++i) {
+			total += nines;
+		}
+		cout << (total.sum() == nines * 1000) << " carries through all-nines limbs" << endl;
+		for (int i = 0; i < 1000; ++i) {
+			total -= nines;
+		}
+		result = total.sum();
+		cout << (result == 0 && result.toString() == "0") << ' ' << result << endl; // 0
+	}
+	cout << endl;
+
+	// Test ConcurrentBigIntAccumulator with several threads against a plain BigInt sum
+	{
+		ConcurrentBigIntAccumulator shared(3);
+		vector<BigInt> addends;
+		mt19937_64 rng(32);
+		for (int i = 0; i < 4000; ++i) {
+			BigInt addend = BigInt::randomBits(rng() % 400, rng);
+			addends.push_back(i % 3 ? addend : -addend);
+		}
+
+		vector<thread> threads;
+		for (size_t t = 0; t < 4; ++t) {
+			threads.emplace_back([&shared, &addends, t]() {
+				for (size_t i = t; i < addends.size(); i += 4) {
+					shared += addends[i];
+				}
+			});
+		}
+		for (thread &t : threads) {
+			t.join();
+		}
+
+		BigInt expected;
+		for (BigInt const &addend : addends) {
+			expected += addend;
+		}
+		cout << (shared.sum() == expected && shared.shardCount() == 3) << " concurrent adds from 4 threads match a BigInt sum" << endl;
+		cout << (shared.exchange() == expected && shared.sum() == 0) << " exchange returns the total and resets it" << endl;
+	}
+	cout << endl;
+
+	// Test BigIntRNS sums and products against plain BigInt
+	{
+		mt19937_64 rng(35);
+		size_t channels = BigIntRNS::channelsFor(700);
+		BigIntRNS sum(BigInt(0), channels), product(BigInt(1), channels);
+		BigInt expectedSum, expectedProduct(1);
+		bool roundTrips = true;
+		for (int i = 0; i < 200; ++i) {
+			BigInt value = BigInt::randomBits(rng() % 300, rng);
+			if (i % 2) {
+				value = -value;
+			}
+			BigIntRNS residues(value, channels);
+			roundTrips = roundTrips && residues.toBigInt() == value;
+			sum += residues;
+			expectedSum += value;
+			if (i % 2 == 0) {
+				sum -= BigIntRNS(BigInt(i), channels);
+				expectedSum -= i;
+			}
+			if (i < 8) {
+				product *= residues;
+				expectedProduct *= value;
+			}
+		}
+		cout << roundTrips << " values round trip through their residues" << endl;
+		cout << (sum.toBigInt() == expectedSum && product.toBigInt() == expectedProduct) << " RNS sums and products match BigInt" << endl;
+		cout << ((-sum).toBigInt() == -expectedSum && (sum * BigIntRNS(BigInt(-3), channels)).toBigInt() == expectedSum * -3)
+			<< " RNS negation and mixed sign products" << endl;
+
+		// Values past (M - 1) / 2 wrap around
+		BigInt limit = (BigIntRNS::modulus(2) - 1) / 2;
+		cout << (BigIntRNS(limit, 2).toBigInt() == limit && BigIntRNS(limit + 1, 2).toBigInt() == -limit) << " range ends at (M - 1) / 2" << endl;
+		try {
+			BigIntRNS(BigInt(1), 0);
+		}
+		catch (exception &e) {
+			cout << "Purposefully threw exception: " << e.what() << endl;
+		}
+	}
+	cout << endl;
+
+	// Test BigRational
+	BigRational third(1, 3), sixth(BigInt(-2), BigInt(-12));
+	BigRational sum = third + sixth;
+	cout << (sum == BigRational(1, 2)) << ' ' << sum << endl; // 1/2
+	sum = third - sixth * BigRational(4);
+	cout << (sum == BigRational(-1, 3)) << ' ' << sum << endl; // -1/3
+	sum = BigRational("6/-8") / BigRational("9/4");
+	cout << (sum == BigRational(-1, 3) && sum.denominator() == BigInt(3)) << ' ' << sum << endl; // -1/3
+	cout << (BigRational(2, 3) > BigRational(3, 5) && BigRational(-2, 3) < BigRational(-3, 5)) << " 2/3 > 3/5" << endl;
+
+	// Negating or cancelling to zero gives the same zero
+	sum = -BigRational(0);
+	cout << (sum == BigRational(0) && sum.toString() == "0") << ' ' << sum << endl; // 0
+	sum = third - third;
+	cout << (sum == BigRational(0) && sum.toString() == "0") << ' ' << sum << endl; // 0
+	cout << endl;
+
+	// Test BigDecimal
+	BigDecimal price("19.99"), rate("0.0825");
+	BigDecimal money = (price * rate).setScale(2);
+	cout << (money == BigDecimal("1.65") && money.scale() == 2) << ' ' << money << endl; // 1.65
+	money = price + BigDecimal("0.01") - BigDecimal(20);
+	cout << (money == BigDecimal(0) && money == BigDecimal("0.000")) << ' ' << money << endl; // 0.00
+	money = BigDecimal(1).divide(BigDecimal(3), 4);
+	cout << (money.toString() == "0.3333") << ' ' << money << endl; // 0.3333
+	money = BigDecimal(-2).divide(BigDecimal(3), 4, RoundingMode::Up);
+	cout << (money.toString() == "-0.6667") << ' ' << money << endl; // -0.6667
+
+	// Every rounding mode on the values Java's RoundingMode documents
+	{
+		char const *values[] = { "5.5", "2.5", "1.6", "1.1", "1.0", "-1.0", "-1.1", "-1.6", "-2.5", "-5.5" };
+		RoundingMode modes[] = { RoundingMode::Up, RoundingMode::Down, RoundingMode::Ceiling, RoundingMode::Floor,
+			RoundingMode::HalfUp, RoundingMode::HalfDown, RoundingMode::HalfEven };
+		int expected[][10] = {
+			{ 6, 3, 2, 2, 1, -1, -2, -2, -3, -6 }, // Up
+			{ 5, 2, 1, 1, 1, -1, -1, -1, -2, -5 }, // Down
+			{ 6, 3, 2, 2, 1, -1, -1, -1, -2, -5 }, // Ceiling
+			{ 5, 2, 1, 1, 1, -1, -2, -2, -3, -6 }, // Floor
+			{ 6, 3, 2, 1, 1, -1, -1, -2, -3, -6 }, // HalfUp
+			{ 5, 2, 2, 1, 1, -1, -1, -2, -2, -5 }, // HalfDown
+			{ 6, 2, 2, 1, 1, -1, -1, -2, -2, -6 } // HalfEven
+		};
+		bool rounded = true;
+		for (size_t m = 0; m < sizeof modes / sizeof modes[0]; ++m) {
+			for (size_t v = 0; v < 10; ++v) {
+				rounded = rounded && BigDecimal(values[v]).setScale(0, modes[m]) == BigDecimal(expected[m][v]);
+			}
+		}
+		cout << rounded << " setScale in every rounding mode" << endl;
+	}
+	cout << (BigDecimal("1.0").setScale(0, RoundingMode::Unnecessary) == BigDecimal(1)) << " Unnecessary when exact" << endl;
+	try {
+		BigDecimal("5.5").setScale(0, RoundingMode::Unnecessary);
+	}
+	catch (exception &e) {
+		cout << "Purposefully threw exception: " << e.what() << endl;
+	}
+	money = BigDecimal("123.456").round(4);
+	cout << (money.toString() == "123.5") << ' ' << money << endl; // 123.5
+
+	// Negating zero or rounding a small negative to zero never prints -0
+	money = -BigDecimal("0.00");
+	cout << (money.toString() == "0.00") << ' ' << money << endl; // 0.00
+	money = BigDecimal("-0.004").setScale(2);
+	cout << (money.toString() == "0.00") << ' ' << money << endl; // 0.00
+	money = BigDecimal("-0.004").setScale(2, RoundingMode::Floor);
+	cout << (money.toString() == "-0.01") << ' ' << money << endl; // -0.01
+	money = BigDecimal("2.50") - BigDecimal("2.5");
+	cout << (money.toString() == "0.00") << ' ' << money << endl; // 0.00
+	cout << endl;
+
+	// Test ConstantsEngine against known digits
+	{
+		ConstantsEngine engine;
+		string pi = engine.pi(100).toString(), e = engine.e(100).toString(), sqrt2 = engine.sqrt2(100).toString();
+		cout << (pi == "3.1415926535897932384626433832795028841971693993751058209749445923078164062862089986280348253421170679") << ' ' << pi << endl;
+		cout << (e == "2.7182818284590452353602874713526624977572470936999595749669676277240766303535475945713821785251664274") << ' ' << e << endl;
+		cout << (sqrt2 == "1.4142135623730950488016887242096980785696718753769480731766797379907324784621070388503875343276415727") << ' ' << sqrt2 << endl;
+
+		// The last 20 of 1000 places
+		pi = engine.pi(1000).toString().substr(982);
+		e = engine.e(1000).toString().substr(982);
+		sqrt2 = engine.sqrt2(1000).toString().substr(982);
+		cout << (pi == "66111959092164201989" && e == "12671546889570350354" && sqrt2 == "82152128229518488472") << ' ' << pi << ' ' << e << ' ' << sqrt2 << endl;
+
+		try {
+			engine.pi(SIZE_MAX);
+		}
+		catch (length_error &e) {
+			cout << "Purposefully threw exception: " << e.what() << endl;
+		}
+	}
+	cout << endl;
+
+	// Test BigIntStats, which only counts when built with BIGINT_STATS defined
+	{
+		BigIntStats::reset();
+		result = e * f;
+		BigIntOpStats multiply = BigIntStats::snapshot()[BigIntOp::Multiply];
+#ifdef BIGINT_STATS
+		// The product's digits and the column buffer are at least one allocation each
+		cout << (multiply.calls == 1 && multiply.allocations >= 2 && multiply.bytesAllocated >= result.digitCount())
+			<< " multiplication allocated " << multiply.bytesAllocated << " bytes in " << multiply.allocations << " allocations" << endl;
+#else
+		cout << (multiply.calls == 0 && multiply.allocations == 0) << " stats compiled out" << endl;
+#endif
+	}
+	cout << endl;
+
+	// Test native operators against the same operations on BigInt, at the LLONG_MIN edges
+	{
+		long long natives[] = { 0, 1, -1, 7, -7, LLONG_MAX, LLONG_MIN, LLONG_MIN + 1 };
+		BigInt bigs[] = { BigInt(0), BigInt(3), BigInt(-3), BigInt(LLONG_MAX), BigInt(LLONG_MIN), BigInt("9223372036854775808"),
+			BigInt("-9223372036854775809"), BigInt("100000000000000000000000") };
+		bool matched = true;
+		for (long long n : natives) {
+			BigInt nb(n);
+			for (BigInt const &b : bigs) {
+				matched = matched && b + n == b + nb && n + b == nb + b && b - n == b - nb && n - b == nb - b
+					&& b * n == b * nb && n * b == nb * b
+					&& (b == n) == (b == nb) && (n < b) == (nb < b) && (b <= n) == (b <= nb) && b.compare(n) == b.compare(nb);
+				if (n) {
+					matched = matched && b / n == b / nb && b % n == b % nb;
+				}
+				if (b != 0) {
+					matched = matched && n / b == nb / b && n % b == nb % b;
+				}
+			}
+		}
+		cout << matched << " native operators match BigInt operators" << endl;
+
+		result = LLONG_MIN / BigInt(-1);
+		cout << (result == BigInt("9223372036854775808")) << ' ' << result << endl; // 9223372036854775808
+		result = LLONG_MIN % BigInt("9223372036854775808");
+		cout << (result == 0 && result.sign() == 0) << ' ' << result << endl; // 0
+		result = -7 % BigInt("100000000000000000000");
+		cout << (result == -7) << ' ' << result << endl; // -7
+		result = BigInt(LLONG_MIN) - LLONG_MIN;
+		cout << (result == 0 && result.toString() == "0") << ' ' << result << endl; // 0
+		try {
+			result = 5 / BigInt(0);
+		}
+		catch (exception &e) {
+			cout << "Purposefully threw exception: " << e.what() << endl;
+		}
+	}
+	cout << endl;
+
+	// Test randomBelow stays within its bound, and randomBits within its width
+	{
+		mt19937_64 rng(38);
+		BigInt bounds[] = { 1, 2, 3, 10, 17, BigInt("1000000000000000000"), BigInt("999999999999999999"),
+			BigInt("1000000000000000001"), pow(BigInt(10), 40), pow(BigInt(2), 64) - 1, pow(BigInt(2), 64) + 1,
+			pow(BigInt(2), 100) + 1 };
+		bool within = true;
+		for (BigInt const &bound : bounds) {
+			for (int i = 0; i < 2000; ++i) {
+				BigInt value = BigInt::randomBelow(bound, rng);
+				within = within && value.sign() >= 0 && value < bound;
+			}
+		}
+		cout << within << " randomBelow stays in [0, bound)" << endl;
+
+		// Every value of a small bound is drawn, none far from its share
+		int counts[7] = {};
+		for (int i = 0; i < 70000; ++i) {
+			++counts[BigInt::randomBelow(BigInt(7), rng).toULongLong()];
+		}
+		bool even = true;
+		for (int count : counts) {
+			even = even && count > 9000 && count < 11000;
+		}
+		cout << even << " randomBelow(7) draws each value about as often" << endl;
+
+		// A bound just past 10^18 has leading chunk 1, so lower digits decide most draws
+		BigInt justPast("1000000000000000001");
+		bool sawTopHalf = false;
+		for (int i = 0; i < 200 && !sawTopHalf; ++i) {
+			sawTopHalf = BigInt::randomBelow(justPast, rng) >= BigInt("500000000000000000");
+		}
+		cout << sawTopHalf << " randomBelow(10^18 + 1) reaches its upper half" << endl;
+
+		bool bitsWithin = true;
+		for (unsigned long long bits : { 0ULL, 1ULL, 31ULL, 32ULL, 33ULL, 64ULL, 100ULL }) {
+			BigInt limit = pow(BigInt(2), bits);
+			for (int i = 0; i < 500; ++i) {
+				BigInt value = BigInt::randomBits(bits, rng);
+				bitsWithin = bitsWithin && value.sign() >= 0 && value < limit;
+			}
+		}
+		cout << bitsWithin << " randomBits stays below 2^bits" << endl;
+
+		for (BigInt const &bad : { BigInt(0), BigInt(-5) }) {
+			try {
+				BigInt::randomBelow(bad, rng);
+				cout << 0 << " randomBelow(" << bad << ") returned" << endl;
+			}
+			catch (invalid_argument &e) {
+				cout << "Purposefully threw exception: " << e.what() << endl;
+			}
+		}
+	}
+	cout << endl;
+
+	// Test a BigCalc script, each line against the same expression on BigInt
+	{
+		string script[] = {
+			"# running totals, as a BigCalc input would hold",
+			"a = 123456789012345678901234567890",
+			"b = -987654321",
+			"",
+			"a + b * 3 - 17 # trailing comment",
+			"(a - b) % 1000000007",
+			"a / b",
+			"-2^2",
+			"2^3^2",
+			"c = a * a",
+			"c - a * a",
+			"(a + b) * (a + b) - (a + b) * (a + b)",
+			"unset + 5",
+			"a = a + 1",
+			"a",
+		};
+		BigInt a("123456789012345678901234567890"), b(-987654321);
+		BigInt expected[] = { a + b * 3 - 17, (a - b) % 1000000007, a / b, 4, 512, 0, 0, 5, a + 1 };
+
+		Evaluator evaluator;
+		size_t next = 0;
+		bool matched = true;
+		for (string const &line : script) {
+			if (BigInt const *value = evaluator.execute(line)) {
+				matched = matched && next < sizeof(expected) / sizeof(expected[0]) && *value == expected[next];
+				++next;
+			}
+		}
+		cout << (matched && next == sizeof(expected) / sizeof(expected[0])) << " BigCalc script matches BigInt" << endl;
+		cout << (evaluator.reusedCount() > 0) << " repeated subexpressions reused: " << evaluator.reusedCount() << endl;
+
+		string bad[] = { "1 / (a - a)", "2 ^ -1", "(1 + 2", "3 $ 4" };
+		for (string const &line : bad) {
+			try {
+				evaluator.execute(line);
+				cout << 0 << ' ' << line << endl;
+			}
+			catch (exception &e) {
+				cout << "Purposefully threw exception: " << e.what() << endl;
+			}
+		}
+		BigInt const *after = evaluator.execute("a");
+		cout << (after && *after == a + 1) << " variables survive a failed line" << endl;
+	}
+	cout << endl;
+
 	// Test input
 	cout << endl << "Enter a value to test BigInt input: ";
 	while (!(cin >> result)) {
@@ -1,19 +1,119 @@
 #pragma once
 /* Collection
- * Template for a container class that attempts to resemble a vector */
+ * Template for a container class that attempts to resemble a vector
+ *
+ * Storage is raw memory: only the first size() slots hold constructed items,
+ * so spare capacity costs no constructions and T needn't be default
+ * constructible. Items are built in place and destroyed when removed
+ *
+ * Memory comes from Alloc through std::allocator_traits, and the allocator
+ * follows the propagate_on_container_* rules on copy, move and swap like the
+ * standard containers'. mylib::pmr::Collection draws from a memory_resource
+ *
+ * How much the array grows by is up to Growth, see DoubleGrowth below. Items
+ * that are trivially relocatable are moved by memcpy, and when the allocator
+ * has a reallocate member (as MallocAllocator does) the array is resized with
+ * it, which for large arrays usually happens in place
+ *
+ * Storage holds the data pointer and whatever the items use before anything
+ * is allocated, see HeapStorage below. SmallCollection is a Collection whose
+ * storage has room for its first few items inside the object */
 
 #define _MYLIB_BEGIN namespace mylib {
 #define _MYLIB_END }
 
 #include <assert.h> /* assert() */
-#include <utility> /* std::move */
+#include <utility> /* std::move, std::forward, std::move_if_noexcept */
+#include <algorithm> /* std::move, std::rotate */
+#include <iterator> /* std::make_move_iterator */
 #include <initializer_list> /* std::initializer_list */
-#include <cstdlib> /* size_t */
+#include <cstddef> /* std::size_t */
+#include <cstdint> /* SIZE_MAX */
+#include <cstring> /* std::memcpy, std::memmove */
+#include <memory> /* std::allocator, std::allocator_traits */
+#include <memory_resource> /* std::pmr::polymorphic_allocator */
+#include <type_traits> /* std::is_trivially_destructible, std::is_trivially_copyable, std::is_nothrow_move_constructible, std::void_t */
 
 _MYLIB_BEGIN
+// Sizes and indexes are always the platform's full width size_t
+using std::size_t;
+
+/* Relocation
+ * A type is trivially relocatable when moving an item and destroying the
+ * original is the same as copying its bytes. That holds for every trivially
+ * copyable type, and can be declared for others (most types that merely own
+ * a pointer, like std::unique_ptr) by specialising this */
 template <class T>
-class Collection {
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+// Whether an allocator can resize an allocation, via a member
+// pointer reallocate(pointer p, size_t oldCount, size_t newCount)
+template <class Alloc, class = void>
+struct has_reallocate : std::false_type {};
+
+template <class Alloc>
+struct has_reallocate<Alloc, std::void_t<decltype(std::declval<Alloc &>().reallocate(
+	std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t(), size_t()))>> : std::true_type {};
+
+/* Growth policies
+ * Each gives the capacity to grow to when allocated items aren't enough for
+ * required, given the size of an item. The first allocation is at least 8
+ * items, and growth jumps straight to required once it would overflow */
+
+// Doubles the capacity
+struct DoubleGrowth {
+	static size_t capacity(size_t allocated, size_t required, size_t itemSize);
+};
+
+// Grows the capacity by half, which wastes less memory and lets freed blocks be reused
+struct HalfGrowth {
+	static size_t capacity(size_t allocated, size_t required, size_t itemSize);
+};
+
+// Doubles the capacity, then rounds it up to fill whole 4 KiB pages
+struct PageGrowth {
+	static const size_t PAGE_SIZE = 4096;
+	static size_t capacity(size_t allocated, size_t required, size_t itemSize);
+};
+
+/* Storage policies
+ * Each holds a Collection's data pointer and the room its items have before
+ * anything is allocated: INLINE_CAPACITY items at inlineData(). The pointer
+ * is back at inlineData() whenever the Collection has no array of its own,
+ * and only memory elsewhere is ever handed back to the allocator */
+
+// Has no room of its own, so an empty Collection allocates nothing and its pointer is null
+template <class T>
+class HeapStorage {
+protected:
+	static const size_t INLINE_CAPACITY = 0; // Count of items that fit without allocating
+
+	HeapStorage() : m_pData(nullptr) {};
+	HeapStorage(HeapStorage const &) = delete; // The pointer belongs to the Collection, which copies itself
+	HeapStorage &operator=(HeapStorage const &) = delete;
+
+	T *inlineData() { return nullptr; } // Returns where items go before allocating
+	T const *inlineData() const { return nullptr; }
+
+	T *m_pData; // Array of items, constructed up to the Collection's size
+};
+
+template <class T, class Alloc = std::allocator<T>, class Growth = DoubleGrowth, class Storage = HeapStorage<T>>
+class Collection : public Storage {
+	using AllocTraits = std::allocator_traits<Alloc>;
+
+	// Whether growing can hand the array to the allocator's reallocate
+	static const bool REALLOCATES = is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value;
+
+	// Whether taking another collection's items can't throw, which it only can
+	// when they are in its inline storage and have to move one by one
+	static const bool NOTHROW_TAKE = Storage::INLINE_CAPACITY == 0 || std::is_nothrow_move_constructible<T>::value;
+
 public:
+	/* Types */
+	using value_type = T;
+	using allocator_type = Alloc;
+
 	/* Iterators */
 	using iterator = T *;
 	using const_iterator = T const *;
@@ -25,202 +125,520 @@ public:
 	const_iterator end() const { return base() + size(); } // Returns const iterator to end
 
 	/* Constuctors */
-	Collection() : m_pData(nullptr), m_size(0), m_allocated(0) {}; // Default constructor
-	Collection(size_t count); // Preallocation constructor
-	Collection(Collection<T> const &toCopy); // Copy contructor;
-	Collection(Collection<T> &&toMove) noexcept; // Move constructor
-	Collection(const_iterator begin, const_iterator end); // Range constructor
-	Collection(std::initializer_list<T> const &list); // Variadic parameter constructor
-
-	/* Deconstructor - deallocates data pointer */
+	Collection() : Collection(Alloc()) {}; // Default constructor
+	explicit Collection(Alloc const &alloc) : m_size(0), m_allocated(Storage::INLINE_CAPACITY), m_alloc(alloc) {}; // Allocator constructor
+	Collection(size_t count, Alloc const &alloc = Alloc()); // Preallocation constructor
+	Collection(Collection const &toCopy); // Copy contructor;
+	Collection(Collection const &toCopy, Alloc const &alloc); // Copy constructor using another allocator
+	Collection(Collection &&toMove) noexcept(NOTHROW_TAKE); // Move constructor
+	Collection(Collection &&toMove, Alloc const &alloc); // Move constructor using another allocator
+	Collection(const_iterator begin, const_iterator end, Alloc const &alloc = Alloc()); // Range constructor
+	Collection(std::initializer_list<T> const &list, Alloc const &alloc = Alloc()); // Variadic parameter constructor
+
+	/* Deconstructor - destroys items and deallocates data pointer */
 	~Collection();
 
 	/* Function members */
 	size_t size() const; // Returns collection size
+	size_t capacity() const; // Returns allocated size of collection
 	bool empty() const; // Checks if collection is empty
-
-	void push(T t); // Adds a new item to collection
+	Alloc get_allocator() const; // Returns a copy of the allocator
+
+	void reserve(size_t count); // Allocates room for at least count items
+	void resize(size_t count); // Adds default items or removes items from the end until there are count
+	void resize(size_t count, T const &t); // Adds copies of item or removes items from the end until there are count
+	void shrink_to_fit(); // Frees any capacity beyond the current size
+
+	void push(T const &t); // Copies a new item onto the end of the collection
+	void push(T &&t); // Moves a new item onto the end of the collection
+	template<class... Args>
+	T &emplace_back(Args &&...args); // Constructs a new item in place at the end of the collection
+	template<class... Args>
+	T &emplace(size_t idx, Args &&...args); // Constructs a new item at specified index
 	void erase(size_t idx); // Removes item from collection at specified index
-	void insert(size_t idx, T); // Inserts item into collection at specified index
+	void erase(size_t first, size_t last); // Removes items [first, last) from collection
+	void insert(size_t idx, T const &t); // Inserts a copy of item into collection at specified index
+	void insert(size_t idx, T &&t); // Moves item into collection at specified index
+	void insert(size_t idx, const_iterator first, const_iterator last); // Inserts copies of a range at specified index
+	void append(Collection const &c); // Copies another collection's items onto the end
+	void append(Collection &&c); // Moves another collection's items onto the end, leaving it empty
+	void assign(const_iterator first, const_iterator last); // Replaces the items with copies of a range
 	void clear(); // Clears the collection of all items
 	void swap(size_t idx1, size_t idx2); // Swaps two items in the collection
-	void swap(Collection<T> &c); // Swap two Collections
+	void swap(Collection &c) noexcept(NOTHROW_TAKE); // Swap two Collections
 
 	/* Operators */
 	T &operator[](size_t idx); // Overload [] for accessing index
 	T const &operator[](size_t idx) const; // Const overload for accessing index
 
-	Collection<T> &operator=(Collection<T> const &toCopy); // Copies values from another collection
-	Collection<T> &operator=(Collection<T> &&toMove) noexcept; // Moves values from another collection
-	Collection<T> &operator=(std::initializer_list<T> const &list); // Variadic parameter assignment
+	Collection &operator=(Collection const &toCopy); // Copies values from another collection
+	Collection &operator=(Collection &&toMove) noexcept(NOTHROW_TAKE &&
+		(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)); // Moves values from another collection
+	Collection &operator=(std::initializer_list<T> const &list); // Variadic parameter assignment
 
 private:
 	/* Storage members */
-	T *m_pData; // Array of items
+	using Storage::m_pData; // Array of items, constructed up to m_size
+	using Storage::inlineData; // Returns where items go before allocating
 	size_t m_size; // Count of items in collection
 	size_t m_allocated; // Allocated size of collection
+	Alloc m_alloc; // Source of the array's memory
 
 	/* Support functions */
-	void shiftLeft(size_t idx); // Shifts items right of index to the left, thus overwriting the index.
-	void shiftRight(size_t idx); // Shifts index and following indexes to the right by one
+	void shiftItems(size_t from, size_t to, size_t count); // Moves count items bytewise from one index to another
+	template<class Iter>
+	void insertItems(size_t idx, Iter first, size_t count); // Inserts count items from first at specified index
+	bool overlaps(const_iterator first, const_iterator last) const; // Checks if a range lies in this collection
 	bool growIfNeed(size_t count); // Grows the array if more space is needed.
+	size_t grownCapacity(size_t count) const; // Returns the capacity to grow to for count more items
+	void reallocate(size_t allocated); // Moves the array to storage for exactly allocated items
+	void relocate(T *pData, size_t allocated); // Moves items into new storage and frees the old
+	template<class... Args>
+	void fill(size_t count, Args const &...args); // Constructs items at the end until there are count
+	void copyConstruct(T *pData, const_iterator first, const_iterator last); // Copies items into raw storage
+	void release(); // Destroys every item and frees the array
+	void take(Collection &other); // Takes other's array, or moves its inline items over, leaving it empty
+	bool ownsArray() const; // Checks if the items are in an array from the allocator
+
+	T *allocate(size_t count); // Allocates raw storage for count items
+	void deallocate(T *pData, size_t count); // Frees raw storage unless it is the inline storage
+	void destroy(T *first, T *last); // Destroys the items in [first, last)
 
 	/* Returns the base address of data (Can change when adding elements!) */
 	T *base() { return m_pData; }
 	T const *base() const { return m_pData; }
 };
 
+namespace pmr {
+	// Collection whose memory comes from a std::pmr::memory_resource
+	template <class T, class Growth = DoubleGrowth>
+	using Collection = mylib::Collection<T, std::pmr::polymorphic_allocator<T>, Growth>;
+}
+
+// Doubles the capacity until required fits
+inline size_t DoubleGrowth::capacity(size_t allocated, size_t required, size_t) {
+	if (allocated < 8) {
+		allocated = 8;
+	}
+
+	while (required > allocated) {
+		allocated = allocated > SIZE_MAX / 2 ? required : allocated * 2;
+	}
+
+	return allocated;
+}
+
+// Grows the capacity by half until required fits
+inline size_t HalfGrowth::capacity(size_t allocated, size_t required, size_t) {
+	if (allocated < 8) {
+		allocated = 8;
+	}
+
+	while (required > allocated) {
+		allocated = allocated > SIZE_MAX / 3 * 2 ? required : allocated + allocated / 2;
+	}
+
+	return allocated;
+}
+
+// Doubles the capacity, then adds the items that fit in the rest of its last page
+inline size_t PageGrowth::capacity(size_t allocated, size_t required, size_t itemSize) {
+	allocated = DoubleGrowth::capacity(allocated, required, itemSize);
+
+	if (allocated > (SIZE_MAX - PAGE_SIZE) / itemSize) {
+		return allocated;
+	}
+
+	size_t bytes = (allocated * itemSize + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+	return bytes / itemSize;
+}
+
 // ------
 // Public
 // ------
 
 // Preallocation constructor - Presets allocation
 // for efficiency if expected to be a large size.
-template<class T>
-inline Collection<T>::Collection(size_t preAllocSize) {
+// Inline storage that already fits that many is enough
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(size_t preAllocSize, Alloc const &alloc) : Collection(alloc) {
 	assert(preAllocSize > 0);
 
-	m_size = 0;
-	m_allocated = preAllocSize;
-	m_pData = new T[m_allocated];
+	if (preAllocSize > m_allocated) {
+		m_pData = allocate(preAllocSize);
+		m_allocated = preAllocSize;
+	}
 }
 
 // Move constructor
-template<class T>
-inline Collection<T>::Collection(Collection<T> &&toMove) noexcept {
-	// Take all of toMove's values
-	m_pData = toMove.m_pData;
-	m_allocated = toMove.m_allocated;
-	m_size = toMove.m_size;
-
-	// Set toMove to default
-	toMove.m_pData = nullptr;
-	toMove.m_allocated = 0;
-	toMove.m_size = 0;
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(Collection &&toMove) noexcept(NOTHROW_TAKE) : Collection(std::move(toMove.m_alloc)) {
+	take(toMove);
 }
 
-// Copy constructor
-template<class T>
-inline Collection<T>::Collection(Collection<T> const &toCopy) {
-	// Copy values and allocate
-	m_size = toCopy.m_size;
+// Move constructor using another allocator
+// Takes toMove's array when the allocators are equal, otherwise moves item by item
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(Collection &&toMove, Alloc const &alloc) : Collection(alloc) {
+	if (m_alloc == toMove.m_alloc) {
+		take(toMove);
+		return;
+	}
 
-	// If copied collection is empty
-	if (m_size == 0) {
-		// initialize values
-		m_allocated = 0;
-		m_pData = nullptr;
-	}
-	else { // otherwise
-		// allocate memory
-		m_allocated = toCopy.m_allocated;
-		m_pData = new T[m_size];
-
-		// and loop through array to copy values
-		for (size_t i = 0; i < m_size; ++i) {
-			m_pData[i] = toCopy.m_pData[i];
-		}
+	reserve(toMove.m_size);
+	for (T &item : toMove) {
+		emplace_back(std::move(item));
 	}
 }
 
-// Variadic parameter constructor
-template<class T>
-inline Collection<T>::Collection(std::initializer_list<T> const &list) {
-	m_size = 0;
+// Copy constructor
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(Collection const &toCopy)
+	: Collection(toCopy, AllocTraits::select_on_container_copy_construction(toCopy.m_alloc)) {}
 
-	// If list isnt empty
-	if (m_allocated = list.size()) {
-		m_pData = new T[m_allocated];
+// Copy constructor using another allocator
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(Collection const &toCopy, Alloc const &alloc)
+	: Collection(toCopy.begin(), toCopy.end(), alloc) {}
 
-		// Loop through each item in the list and copy it to collection
-		for (auto it = list.begin(); it != list.end(); ++it) {
-			m_pData[m_size++] = *it;
-		}
-	}
-	else {
-		m_pData = nullptr;
-	}
-}
+// Variadic parameter constructor
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(std::initializer_list<T> const &list, Alloc const &alloc)
+	: Collection(list.begin(), list.end(), alloc) {}
 
 // Range/Iterator constructor
-template<class T>
-inline Collection<T>::Collection(const_iterator begin, const_iterator end) : Collection() {
-	assert(begin < end);
-
-	// Loop between range and add to collection
-	for (; begin != end; ++begin) {
-		push(*begin);
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::Collection(const_iterator begin, const_iterator end, Alloc const &alloc) : Collection(alloc) {
+	assert(begin <= end);
+
+	// Allocate exactly enough, unless the range fits the inline storage
+	size_t count = static_cast<size_t>(end - begin);
+	if (count > m_allocated) {
+		m_pData = allocate(count);
+		m_allocated = count;
 	}
+
+	// The object is already constructed, so if a copy throws the destructor frees the array
+	copyConstruct(m_pData, begin, end);
+	m_size = count;
 }
 
-// Deconstructor, which deallocates memory
-template<class T>
-inline Collection<T>::~Collection() {
-	delete[] m_pData;
+// Deconstructor, which destroys live items and deallocates memory
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage>::~Collection() {
+	release();
 }
 
 // Returns current size of collection
-template<class T>
-inline size_t Collection<T>::size() const {
+template<class T, class Alloc, class Growth, class Storage>
+inline size_t Collection<T, Alloc, Growth, Storage>::size() const {
 	return m_size;
 }
 
+// Returns allocated size of collection
+template<class T, class Alloc, class Growth, class Storage>
+inline size_t Collection<T, Alloc, Growth, Storage>::capacity() const {
+	return m_allocated;
+}
+
 // Checks if the collection is empty
-template<class T>
-inline bool Collection<T>::empty() const {
+template<class T, class Alloc, class Growth, class Storage>
+inline bool Collection<T, Alloc, Growth, Storage>::empty() const {
 	return !m_size;
 }
 
-// Adds a new item to collection
-template<class T>
-inline void Collection<T>::push(T newItem) {
-	if (!growIfNeed(1)) {
+// Returns a copy of the allocator
+template<class T, class Alloc, class Growth, class Storage>
+inline Alloc Collection<T, Alloc, Growth, Storage>::get_allocator() const {
+	return m_alloc;
+}
+
+// Allocates room for at least count items
+// Unlike growing, this allocates exactly count when more room is needed
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::reserve(size_t count) {
+	if (count > m_allocated) {
+		reallocate(count);
+	}
+}
+
+// Adds value initialised items or removes items from the end until there are count
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::resize(size_t count) {
+	if (count <= m_size) {
+		destroy(m_pData + count, m_pData + m_size);
+		m_size = count;
 		return;
 	}
 
-	// Add new item to the next index and increment size
-	m_pData[m_size++] = newItem;
+	growIfNeed(count - m_size);
+	fill(count);
 }
 
-// Removes item from collection, decreases size, and shifts array left
-template<class T>
-inline void Collection<T>::erase(size_t idx) {
-	// Check if the index is valid
-	if (idx >= m_size) {
+// Adds copies of item or removes items from the end until there are count
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::resize(size_t count, T const &item) {
+	if (count <= m_size) {
+		destroy(m_pData + count, m_pData + m_size);
+		m_size = count;
+		return;
+	}
+
+	if (count <= m_allocated) {
+		fill(count, item);
 		return;
 	}
 
-	// Shift everything to the left starting from index and decrease size
-	shiftLeft(idx);
-	--m_size;
+	// item may be in the array about to move
+	T copy(item);
+	growIfNeed(count - m_size);
+	fill(count, copy);
+}
+
+// Frees any capacity beyond the current size
+// Items that fit the inline storage move back into it, so an empty
+// collection gives up its array entirely
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::shrink_to_fit() {
+	if (!ownsArray() || m_size == m_allocated) {
+		return;
+	}
+
+	if (m_size == 0) {
+		release();
+	}
+	else if (m_size <= Storage::INLINE_CAPACITY) {
+		relocate(inlineData(), Storage::INLINE_CAPACITY);
+	}
+	else {
+		reallocate(m_size);
+	}
+}
+
+// Copies a new item onto the end of the collection
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::push(T const &newItem) {
+	emplace_back(newItem);
+}
+
+// Moves a new item onto the end of the collection
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::push(T &&newItem) {
+	emplace_back(std::move(newItem));
+}
+
+// Constructs a new item in place at the end of the collection
+// When the array is full, the item is built in the new storage before the
+// old items move over, so args may safely refer to an item of this collection
+template<class T, class Alloc, class Growth, class Storage>
+template<class... Args>
+inline T &Collection<T, Alloc, Growth, Storage>::emplace_back(Args &&...args) {
+	if (m_size < m_allocated) {
+		AllocTraits::construct(m_alloc, m_pData + m_size, std::forward<Args>(args)...);
+	}
+	else if constexpr (REALLOCATES) {
+		// The array may move as it is resized, so the item is built beforehand
+		T item(std::forward<Args>(args)...);
+		growIfNeed(1);
+		AllocTraits::construct(m_alloc, m_pData + m_size, std::move(item));
+	}
+	else {
+		size_t allocated = grownCapacity(1);
+		T *pData = allocate(allocated);
+
+		try {
+			AllocTraits::construct(m_alloc, pData + m_size, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			deallocate(pData, allocated);
+			throw;
+		}
+
+		try {
+			relocate(pData, allocated);
+		}
+		catch (...) {
+			destroy(pData + m_size, pData + m_size + 1);
+			deallocate(pData, allocated);
+			throw;
+		}
+	}
+
+	return m_pData[m_size++];
 }
 
-// Inserts item into collection at specified index and shifts array right
-template<class T>
-inline void Collection<T>::insert(size_t idx, T item) {
+// Constructs a new item at specified index and shifts array right
+template<class T, class Alloc, class Growth, class Storage>
+template<class... Args>
+inline T &Collection<T, Alloc, Growth, Storage>::emplace(size_t idx, Args &&...args) {
 	// Check if the index is valid
 	assert(idx <= m_size);
 
+	if (idx == m_size) {
+		return emplace_back(std::forward<Args>(args)...);
+	}
+
+	// Build the item first, args may refer to an item about to move
+	T item(std::forward<Args>(args)...);
+
+	// Trivially relocatable items make room with a single memmove
+	if constexpr (is_trivially_relocatable<T>::value) {
+		insertItems(idx, std::make_move_iterator(&item), 1);
+		return m_pData[idx];
+	}
+
 	// Check if array needs to grow
-	if (!growIfNeed(1)) {
+	growIfNeed(1);
+
+	// The last item moves into raw storage, the rest shift right over live items
+	AllocTraits::construct(m_alloc, m_pData + m_size, std::move(m_pData[m_size - 1]));
+	++m_size;
+	for (size_t i = m_size - 2; i > idx; --i) {
+		m_pData[i] = std::move(m_pData[i - 1]);
+	}
+
+	m_pData[idx] = std::move(item);
+
+	return m_pData[idx];
+}
+
+// Removes item from collection, decreases size, and shifts array left
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::erase(size_t idx) {
+	// Check if the index is valid
+	if (idx >= m_size) {
 		return;
 	}
 
-	// Shift everything to the right and insert new item
-	++m_size;
-	shiftRight(idx);
-	m_pData[idx] = item;
+	erase(idx, idx + 1);
 }
 
-// Sets size to 0,
-template<class T>
-inline void Collection<T>::clear() {
+// Removes items [first, last) from collection, shifting the rest left in one pass
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::erase(size_t first, size_t last) {
+	assert(first <= last && last <= m_size);
+
+	size_t count = last - first;
+	if (count == 0) {
+		return;
+	}
+
+	if constexpr (is_trivially_relocatable<T>::value) {
+		destroy(m_pData + first, m_pData + last);
+		shiftItems(last, first, m_size - last);
+	}
+	else {
+		// Move the tail over the erased items, then destroy the vacated end
+		std::move(m_pData + last, m_pData + m_size, m_pData + first);
+		destroy(m_pData + m_size - count, m_pData + m_size);
+	}
+
+	m_size -= count;
+}
+
+// Inserts a copy of item into collection at specified index
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::insert(size_t idx, T const &item) {
+	emplace(idx, item);
+}
+
+// Moves item into collection at specified index
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::insert(size_t idx, T &&item) {
+	emplace(idx, std::move(item));
+}
+
+// Inserts copies of [first, last) at specified index
+// The range may come from this collection
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::insert(size_t idx, const_iterator first, const_iterator last) {
+	assert(idx <= m_size && first <= last);
+
+	size_t count = static_cast<size_t>(last - first);
+	if (count == 0) {
+		return;
+	}
+
+	// A range in this collection would move as room is made, so copy it out first
+	if (overlaps(first, last)) {
+		Collection copy(first, last, m_alloc);
+		insertItems(idx, std::make_move_iterator(copy.begin()), count);
+		return;
+	}
+
+	insertItems(idx, first, count);
+}
+
+// Copies another collection's items onto the end
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::append(Collection const &c) {
+	insert(m_size, c.begin(), c.end());
+}
+
+// Moves another collection's items onto the end, leaving it empty
+// Its array is taken whole when this one is empty and has no more room
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::append(Collection &&c) {
+	if (this == &c) {
+		append(static_cast<Collection const &>(c));
+		return;
+	}
+
+	if (m_size == 0 && c.ownsArray() && c.m_allocated >= m_allocated && m_alloc == c.m_alloc) {
+		release();
+		take(c);
+		return;
+	}
+
+	growIfNeed(c.m_size);
+
+	if constexpr (is_trivially_relocatable<T>::value) {
+		// The items are relocated, so c is left with nothing to destroy
+		if (c.m_size) {
+			std::memcpy(static_cast<void *>(m_pData + m_size), static_cast<void const *>(c.m_pData), c.m_size * sizeof(T));
+		}
+		m_size += c.m_size;
+		c.m_size = 0;
+	}
+	else {
+		for (T &item : c) {
+			emplace_back(std::move(item));
+		}
+		c.clear();
+	}
+}
+
+// Replaces the items with copies of [first, last)
+// A range in this collection is kept by erasing around it
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::assign(const_iterator first, const_iterator last) {
+	assert(first <= last);
+
+	if (overlaps(first, last)) {
+		size_t firstIdx = static_cast<size_t>(first - m_pData);
+		size_t lastIdx = static_cast<size_t>(last - m_pData);
+		erase(lastIdx, m_size);
+		erase(0, firstIdx);
+		return;
+	}
+
+	size_t count = static_cast<size_t>(last - first);
+	clear();
+	growIfNeed(count);
+	copyConstruct(m_pData, first, last);
+	m_size = count;
+}
+
+// Destroys every item and sets size to 0, keeping the allocation
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::clear() {
+	destroy(m_pData, m_pData + m_size);
 	m_size = 0;
 }
 
 // Swaps two items by index
-template<class T>
-inline void Collection<T>::swap(size_t idx1, size_t idx2) {
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::swap(size_t idx1, size_t idx2) {
 	// Ensure indexes are valid
 	assert(idx1 < m_size && idx2 < m_size);
 
@@ -231,92 +649,133 @@ inline void Collection<T>::swap(size_t idx1, size_t idx2) {
 }
 
 // Swaps two collection
-template<class T>
-inline void Collection<T>::swap(Collection<T> &c) {
-	// Move contents between collections
-	Collection<T> temp(std::move(*this));
-	*this = std::move(c);
-	c = std::move(temp);
+// The allocators swap too if they propagate on swap, otherwise they must be equal.
+// Arrays just trade places, inline items have to move through a temporary
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::swap(Collection &c) noexcept(NOTHROW_TAKE) {
+	using std::swap;
+
+	if constexpr (!AllocTraits::propagate_on_container_swap::value) {
+		assert(m_alloc == c.m_alloc);
+	}
+
+	if constexpr (Storage::INLINE_CAPACITY > 0) {
+		if (!ownsArray() || !c.ownsArray()) {
+			// Each allocator has to travel with the array it allocated
+			Collection temp(std::move(*this));
+			if constexpr (AllocTraits::propagate_on_container_swap::value) {
+				m_alloc = c.m_alloc;
+			}
+			take(c);
+			if constexpr (AllocTraits::propagate_on_container_swap::value) {
+				c.m_alloc = temp.m_alloc;
+			}
+			c.take(temp);
+			return;
+		}
+	}
+
+	if constexpr (AllocTraits::propagate_on_container_swap::value) {
+		swap(m_alloc, c.m_alloc);
+	}
+
+	swap(m_pData, c.m_pData);
+	swap(m_size, c.m_size);
+	swap(m_allocated, c.m_allocated);
 }
 
 // Bracket operator to access specified index
-template<class T>
-inline T &Collection<T>::operator[](size_t idx) {
+template<class T, class Alloc, class Growth, class Storage>
+inline T &Collection<T, Alloc, Growth, Storage>::operator[](size_t idx) {
 	assert(idx < m_size);
 
 	return m_pData[idx];
 }
 
 // Const bracket operator to access specified index
-template<class T>
-inline const T &Collection<T>::operator[](size_t idx) const {
+template<class T, class Alloc, class Growth, class Storage>
+inline const T &Collection<T, Alloc, Growth, Storage>::operator[](size_t idx) const {
 	assert(idx < m_size);
 
 	return m_pData[idx];
 }
 
 // Copies valies from another collection
-template<class T>
-inline Collection<T> &Collection<T>::operator=(Collection<T> const &toCopy) {
-	if (this != &toCopy) {
-		delete[] m_pData; // Deallocate memory
-		m_pData = nullptr;
-		m_size = toCopy.m_size; // Get size of collection
-		m_allocated = m_size;
-
-		// if new collection contains items
-		if (m_size) {
-			m_pData = new T[m_size]; // Allocate memory with size
+// Reuses the allocation when it is large enough and the allocator stays
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage> &Collection<T, Alloc, Growth, Storage>::operator=(Collection const &toCopy) {
+	if (this == &toCopy) {
+		return *this;
+	}
 
-			// Loop through array and copy values
-			for (size_t i = 0; i < m_size; ++i) {
-				m_pData[i] = toCopy.m_pData[i];
-			}
+	if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+		// Memory from the old allocator must go back to it before it is replaced
+		if (m_alloc != toCopy.m_alloc) {
+			release();
 		}
+		m_alloc = toCopy.m_alloc;
 	}
 
+	if (toCopy.m_size > m_allocated) {
+		Collection copy(toCopy, m_alloc);
+		release();
+		take(copy);
+		return *this;
+	}
+
+	clear();
+	copyConstruct(m_pData, toCopy.begin(), toCopy.end());
+	m_size = toCopy.m_size;
+
 	return *this;
 }
 
 // Move assignment
-template<class T>
-inline Collection<T> &Collection<T>::operator=(Collection<T> &&toMove) noexcept {
-	if (this != &toMove) {
-		delete[] m_pData;
+// Takes toMove's array if the allocator propagates or the two are equal,
+// otherwise the items have to move one by one into this collection's memory
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage> &Collection<T, Alloc, Growth, Storage>::operator=(Collection &&toMove) noexcept(NOTHROW_TAKE &&
+	(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)) {
+	if (this == &toMove) {
+		return *this;
+	}
 
-		// Take toMove's values
-		m_pData = toMove.m_pData;
-		m_allocated = toMove.m_allocated;
-		m_size = toMove.m_size;
+	if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+		release();
+		m_alloc = std::move(toMove.m_alloc);
+		take(toMove);
+	}
+	else {
+		if (m_alloc == toMove.m_alloc) {
+			release();
+			take(toMove);
+			return *this;
+		}
 
-		// Set toMove to default
-		toMove.m_pData = nullptr;
-		toMove.m_allocated = 0;
-		toMove.m_size = 0;
+		clear();
+		growIfNeed(toMove.m_size);
+		for (T &item : toMove) {
+			emplace_back(std::move(item));
+		}
 	}
 
 	return *this;
 }
 
 // Variadic params assignment
-template<class T>
-inline Collection<T> &Collection<T>::operator=(std::initializer_list<T> const &list) {
-	m_size = 0;
-	delete[] m_pData;
-
-	// If list isnt empty
-	if (m_allocated = list.size()) {
-		m_pData = new T[m_allocated];
-
-		// Loop through contents and copy to collection
-		for (auto it = list.begin(); it != list.end(); ++it) {
-			m_pData[m_size++] = *it;
-		}
-	}
-	else {
-		m_pData = nullptr;
+template<class T, class Alloc, class Growth, class Storage>
+inline Collection<T, Alloc, Growth, Storage> &Collection<T, Alloc, Growth, Storage>::operator=(std::initializer_list<T> const &list) {
+	if (list.size() > m_allocated) {
+		Collection copy(list, m_alloc);
+		release();
+		take(copy);
+		return *this;
 	}
 
+	clear();
+	copyConstruct(m_pData, list.begin(), list.end());
+	m_size = list.size();
+
 	return *this;
 }
 
@@ -325,66 +784,236 @@ inline Collection<T> &Collection<T>::operator=(std::initializer_list<T> const &l
 // Private
 // -------
 
-// Shifts items right of index to the left, thus overwriting the index.
-template<class T>
-inline void Collection<T>::shiftLeft(size_t idx) {
-	for (size_t i = idx; i < m_size - 1; ++i) {
-		m_pData[i] = std::move(m_pData[i + 1]);
+// Moves count items bytewise from index from to index to, for trivially relocatable items only
+// The source and destination may overlap, and to + count must be within capacity
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::shiftItems(size_t from, size_t to, size_t count) {
+	assert(to + count <= m_allocated);
+
+	if (count) {
+		std::memmove(static_cast<void *>(m_pData + to), static_cast<void const *>(m_pData + from), count * sizeof(T));
 	}
 }
 
-// Shifts index and following indexes to the right by one
-// Only to be used following growth check
-template<class T>
-inline void Collection<T>::shiftRight(size_t idx) {
-	for (size_t i = m_size - 1; i > idx; --i) {
-		m_pData[i] = std::move(m_pData[i - 1]);
+// Inserts count items, constructed from *first onwards, at specified index
+// The items can't come from this collection
+// Trivially relocatable items make room with one memmove, others are built at
+// the end and rotated into place, so either way each item moves once
+template<class T, class Alloc, class Growth, class Storage>
+template<class Iter>
+inline void Collection<T, Alloc, Growth, Storage>::insertItems(size_t idx, Iter first, size_t count) {
+	growIfNeed(count);
+
+	if constexpr (is_trivially_relocatable<T>::value) {
+		shiftItems(idx, idx + count, m_size - idx);
+
+		size_t built = 0;
+		try {
+			for (; built < count; ++built, ++first) {
+				AllocTraits::construct(m_alloc, m_pData + idx + built, *first);
+			}
+		}
+		catch (...) {
+			// Close the gap again
+			destroy(m_pData + idx, m_pData + idx + built);
+			shiftItems(idx + count, idx, m_size - idx);
+			throw;
+		}
+
+		m_size += count;
 	}
+	else {
+		size_t oldSize = m_size;
+		try {
+			for (size_t i = 0; i < count; ++i, ++first) {
+				emplace_back(*first);
+			}
+		}
+		catch (...) {
+			erase(oldSize, m_size);
+			throw;
+		}
+
+		std::rotate(m_pData + idx, m_pData + oldSize, m_pData + m_size);
+	}
+}
+
+// Checks if [first, last) lies within this collection's items
+template<class T, class Alloc, class Growth, class Storage>
+inline bool Collection<T, Alloc, Growth, Storage>::overlaps(const_iterator first, const_iterator last) const {
+	return first < m_pData + m_size && last > m_pData;
 }
 
 // Checks if the allocated memory needs to expand to
 // account for new items
-template<class T>
-inline bool Collection<T>::growIfNeed(size_t count) {
+template<class T, class Alloc, class Growth, class Storage>
+inline bool Collection<T, Alloc, Growth, Storage>::growIfNeed(size_t count) {
 	// Check if the array has space
 	if (m_size + count <= m_allocated) {
 		return true;
 	}
 
-	// Create a default array size of 8
-	if (m_allocated < 8) {
-		m_allocated = 8;
+	reallocate(grownCapacity(count));
+
+	return true;
+}
+
+// Returns the capacity to grow to for count more items
+template<class T, class Alloc, class Growth, class Storage>
+inline size_t Collection<T, Alloc, Growth, Storage>::grownCapacity(size_t count) const {
+	return Growth::capacity(m_allocated, m_size + count, sizeof(T));
+}
+
+// Moves the array to storage for exactly allocated items, which must be at least size()
+// When the allocator can, its own array is resized without a separate copy
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::reallocate(size_t allocated) {
+	assert(allocated >= m_size && allocated > 0);
+
+	if constexpr (REALLOCATES) {
+		if (ownsArray()) {
+			m_pData = m_alloc.reallocate(m_pData, m_allocated, allocated);
+			m_allocated = allocated;
+			return;
+		}
 	}
 
-	// Grow exponentially if there isn't enough space
-	while (m_size + count > m_allocated) {
-		m_allocated *= 2;
+	T *pData = allocate(allocated);
+
+	try {
+		relocate(pData, allocated);
 	}
+	catch (...) {
+		deallocate(pData, allocated);
+		throw;
+	}
+}
 
-	// If data has not been initialized
-	if (m_pData == nullptr) {
-		// allocate memory
-		m_pData = new T[m_allocated];
+// Moves items into new storage of the given size, then destroys and frees the old
+// Trivially relocatable items are copied bytewise, others are copied instead if
+// their move constructor could throw, so a throw here leaves the collection as
+// it was (and pData holding no items)
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::relocate(T *pData, size_t allocated) {
+	if constexpr (is_trivially_relocatable<T>::value) {
+		// The copies take over from the originals, which are never destroyed
+		if (m_size) {
+			std::memcpy(static_cast<void *>(pData), static_cast<void const *>(m_pData), m_size * sizeof(T));
+		}
 	}
-	else { //otherwise
-		// allocate new memory
-		T *pData = new T[m_allocated];
+	else {
+		size_t i = 0;
+		try {
+			for (; i < m_size; ++i) {
+				AllocTraits::construct(m_alloc, pData + i, std::move_if_noexcept(m_pData[i]));
+			}
+		}
+		catch (...) {
+			destroy(pData, pData + i);
+			throw;
+		}
+
+		destroy(m_pData, m_pData + m_size);
+	}
+
+	deallocate(m_pData, m_allocated);
+	m_pData = pData;
+	m_allocated = allocated;
+}
+
+// Constructs items from args at the end until there are count, which must fit
+// Each is counted as soon as it is built, so a throw leaves the ones before it
+template<class T, class Alloc, class Growth, class Storage>
+template<class... Args>
+inline void Collection<T, Alloc, Growth, Storage>::fill(size_t count, Args const &...args) {
+	assert(count <= m_allocated);
 
-		// check if allocation was successful
-		if (pData == nullptr) {
-			return false;
+	for (; m_size < count; ++m_size) {
+		AllocTraits::construct(m_alloc, m_pData + m_size, args...);
+	}
+}
+
+// Copy constructs [first, last) into raw storage
+// On a throw, the copies already made are destroyed
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::copyConstruct(T *pData, const_iterator first, const_iterator last) {
+	T *next = pData;
+	try {
+		for (; first != last; ++first, ++next) {
+			AllocTraits::construct(m_alloc, next, *first);
 		}
+	}
+	catch (...) {
+		destroy(pData, next);
+		throw;
+	}
+}
+
+// Destroys every item and frees the array, leaving the collection unallocated
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::release() {
+	destroy(m_pData, m_pData + m_size);
+	deallocate(m_pData, m_allocated);
+	m_pData = inlineData();
+	m_size = 0;
+	m_allocated = Storage::INLINE_CAPACITY;
+}
 
-		// loop through data and copy to new array
-		for (size_t i = 0; i < m_size; ++i) {
-			pData[i] = std::move(m_pData[i]);
+// Takes other's array, or moves its inline items into this inline storage,
+// leaving it empty. This collection must be empty and unallocated, and the
+// array must have come from an allocator equal to this one's
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::take(Collection &other) {
+	assert(m_size == 0 && !ownsArray());
+
+	if (!other.ownsArray()) {
+		if constexpr (Storage::INLINE_CAPACITY > 0) {
+			for (T &item : other) {
+				AllocTraits::construct(m_alloc, m_pData + m_size, std::move(item));
+				++m_size;
+			}
+			other.clear();
 		}
+		return;
+	}
+
+	m_pData = other.m_pData;
+	m_size = other.m_size;
+	m_allocated = other.m_allocated;
+
+	other.m_pData = other.inlineData();
+	other.m_size = 0;
+	other.m_allocated = Storage::INLINE_CAPACITY;
+}
 
-		// free old array and set it equal to new
-		delete[] m_pData;
-		m_pData = pData;
+// Checks if the items are in an array from the allocator, rather than the inline storage
+template<class T, class Alloc, class Growth, class Storage>
+inline bool Collection<T, Alloc, Growth, Storage>::ownsArray() const {
+	return m_pData != inlineData();
+}
+
+// Allocates raw storage for count items, constructing none of them
+template<class T, class Alloc, class Growth, class Storage>
+inline T *Collection<T, Alloc, Growth, Storage>::allocate(size_t count) {
+	return AllocTraits::allocate(m_alloc, count);
+}
+
+// Frees raw storage, which must hold no live items
+// The inline storage is part of the object and is left alone
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::deallocate(T *pData, size_t count) {
+	if (pData != inlineData()) {
+		AllocTraits::deallocate(m_alloc, pData, count);
 	}
+}
 
-	return m_pData != nullptr;
+// Destroys the items in [first, last)
+template<class T, class Alloc, class Growth, class Storage>
+inline void Collection<T, Alloc, Growth, Storage>::destroy(T *first, T *last) {
+	if constexpr (!std::is_trivially_destructible<T>::value) {
+		for (; first != last; ++first) {
+			AllocTraits::destroy(m_alloc, first);
+		}
+	}
 }
 _MYLIB_END
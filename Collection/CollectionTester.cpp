@@ -0,0 +1,571 @@
+/* CollectionTester
+ * A program to test Collection and SmallCollection against std::vector
+ * Prints 1 for each check that passes and 0 for each that fails
+ *
+ * Items are Counted, which owns heap memory and tracks every construction and
+ * destruction, so an item built twice, destroyed twice or used while dead
+ * shows up in the counts (and to a sanitizer) */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm> /* std::equal */
+#include <random> /* std::mt19937 */
+#include <stdexcept> /* std::runtime_error */
+#include <type_traits> /* std::true_type, std::bool_constant */
+#include <memory_resource> /* std::pmr::memory_resource, std::pmr::new_delete_resource */
+#include "Collection.hpp"
+#include "SmallCollection.hpp"
+#include "MallocAllocator.hpp"
+
+using namespace std;
+using namespace mylib;
+
+int failures = 0;
+
+// Prints whether a check passed
+void check(bool passed, string const &what) {
+	cout << passed << ' ' << what << endl;
+	failures += !passed;
+}
+
+// Item owning an int on the heap, which counts itself and checks it is alive whenever used
+struct Counted {
+	static const unsigned ALIVE = 0x600DF00D;
+	static const unsigned DEAD = 0xDEADDEAD;
+
+	static long long live; // Items constructed and not yet destroyed
+	static long long constructions;
+	static long long misuses; // Dead items destroyed, copied, moved or assigned
+	static int copiesBeforeThrow; // Copies allowed before one throws, or -1 for no limit
+
+	Counted() : Counted(0) {};
+	Counted(int v) : m_value(new int(v)), m_state(ALIVE) { ++live; ++constructions; };
+	Counted(Counted const &c) : m_value(nullptr), m_state(ALIVE) {
+		if (copiesBeforeThrow == 0) {
+			m_state = DEAD;
+			throw runtime_error("copy failed");
+		}
+		if (copiesBeforeThrow > 0) {
+			--copiesBeforeThrow;
+		}
+		m_value = new int(c.get());
+		++live;
+		++constructions;
+	};
+	Counted(Counted &&c) noexcept : m_value(c.m_value), m_state(ALIVE) {
+		misuses += c.m_state != ALIVE;
+		c.m_value = nullptr;
+		++live;
+		++constructions;
+	};
+	~Counted() {
+		misuses += m_state != ALIVE;
+		m_state = DEAD;
+		delete m_value;
+		--live;
+	};
+
+	Counted &operator=(Counted const &c) {
+		misuses += m_state != ALIVE;
+		if (this != &c) {
+			delete m_value;
+			m_value = new int(c.get());
+		}
+		return *this;
+	};
+	Counted &operator=(Counted &&c) noexcept {
+		misuses += m_state != ALIVE || c.m_state != ALIVE;
+		if (this != &c) {
+			delete m_value;
+			m_value = c.m_value;
+			c.m_value = nullptr;
+		}
+		return *this;
+	};
+
+	// Returns the value, or -1 once moved from
+	int get() const {
+		misuses += m_state != ALIVE;
+		return m_value ? *m_value : -1;
+	};
+
+private:
+	int *m_value;
+	unsigned m_state;
+};
+
+long long Counted::live = 0;
+long long Counted::constructions = 0;
+long long Counted::misuses = 0;
+int Counted::copiesBeforeThrow = -1;
+
+// Counted that declares itself trivially relocatable, as an owner of a single pointer may
+struct Relocatable : Counted {
+	using Counted::Counted;
+};
+
+namespace mylib {
+	template <>
+	struct is_trivially_relocatable<Relocatable> : true_type {};
+}
+
+// Checks a collection against a vector of the values it should hold
+template <class C>
+bool same(C const &c, vector<int> const &v) {
+	if (c.size() != v.size() || c.empty() != v.empty() || c.end() - c.begin() != static_cast<ptrdiff_t>(v.size())) {
+		return false;
+	}
+	for (size_t i = 0; i < v.size(); ++i) {
+		if (c[i].get() != v[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Source of memory that counts the items it has out, and which array went to which arena
+struct Arena {
+	long long items;
+};
+
+map<void const *, Arena *> owners;
+long long misfrees = 0; // Arrays freed through an allocator other than the one that allocated them
+
+// Allocator drawing from an Arena, equal only to allocators of the same one
+template <class T, bool Propagate>
+struct ArenaAllocator {
+	using value_type = T;
+	using propagate_on_container_copy_assignment = bool_constant<Propagate>;
+	using propagate_on_container_move_assignment = bool_constant<Propagate>;
+	using propagate_on_container_swap = bool_constant<Propagate>;
+
+	template <class U>
+	struct rebind { using other = ArenaAllocator<U, Propagate>; };
+
+	ArenaAllocator(Arena *a) : arena(a) {};
+	template <class U>
+	ArenaAllocator(ArenaAllocator<U, Propagate> const &a) : arena(a.arena) {};
+
+	T *allocate(size_t count) {
+		T *p = allocator<T>().allocate(count);
+		arena->items += count;
+		owners[p] = arena;
+		return p;
+	};
+	void deallocate(T *p, size_t count) {
+		auto owner = owners.find(p);
+		if (owner == owners.end() || owner->second != arena) {
+			++misfrees;
+		}
+		else {
+			owners.erase(owner);
+		}
+		arena->items -= count;
+		allocator<T>().deallocate(p, count);
+	};
+
+	bool operator==(ArenaAllocator const &a) const { return arena == a.arena; };
+	bool operator!=(ArenaAllocator const &a) const { return arena != a.arena; };
+
+	Arena *arena;
+};
+
+// Memory resource counting the bytes it has out
+struct CountingResource : std::pmr::memory_resource {
+	long long bytes = 0;
+
+private:
+	void *do_allocate(size_t size, size_t alignment) override {
+		bytes += size;
+		return std::pmr::new_delete_resource()->allocate(size, alignment);
+	};
+	void do_deallocate(void *p, size_t size, size_t alignment) override {
+		bytes -= size;
+		std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+	};
+	bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override {
+		return this == &other;
+	};
+};
+
+// MallocAllocator that counts the arrays it resizes
+template <class T>
+struct CountingMallocAllocator : MallocAllocator<T> {
+	static long long reallocations;
+
+	CountingMallocAllocator() = default;
+	template <class U>
+	CountingMallocAllocator(CountingMallocAllocator<U> const &) {};
+
+	T *reallocate(T *p, size_t oldCount, size_t newCount) {
+		++reallocations;
+		return MallocAllocator<T>::reallocate(p, oldCount, newCount);
+	};
+};
+
+template <class T>
+long long CountingMallocAllocator<T>::reallocations = 0;
+
+// Checks every capacity a collection grows to while pushing is the one Growth gives
+template <class Growth>
+bool followsGrowth(vector<size_t> &capacities) {
+	Collection<int, allocator<int>, Growth> c;
+	bool followed = true;
+	for (int i = 0; i < 100000; ++i) {
+		size_t expected = c.size() < c.capacity() ? c.capacity() : Growth::capacity(c.capacity(), c.size() + 1, sizeof(int));
+		c.push(i);
+		followed = followed && c.capacity() == expected && c[c.size() - 1] == i;
+		if (capacities.empty() || capacities.back() != c.capacity()) {
+			capacities.push_back(c.capacity());
+		}
+	}
+	return followed;
+}
+
+// Random range erases, inserts, appends and assigns against a vector
+template <class C>
+bool rangeOperations(C &c, vector<int> &v, mt19937 &rng) {
+	bool matched = true;
+	for (int step = 0; step < 3000; ++step) {
+		C other(c.get_allocator());
+		vector<int> otherValues;
+		for (size_t i = rng() % 6; i > 0; --i) {
+			int value = static_cast<int>(rng() % 1000);
+			other.push(value);
+			otherValues.push_back(value);
+		}
+
+		size_t first = rng() % (v.size() + 1);
+		size_t last = first + rng() % (v.size() - first + 1);
+		switch (v.size() > 200 ? 0 : rng() % 10) {
+		case 0:
+		case 1:
+			c.erase(first, last);
+			v.erase(v.begin() + first, v.begin() + last);
+			break;
+		case 2:
+		case 3:
+			c.insert(first, other.begin(), other.end());
+			v.insert(v.begin() + first, otherValues.begin(), otherValues.end());
+			break;
+		case 4:
+		case 5: {
+			// A range of the collection itself, which moves as room is made
+			size_t idx = rng() % (v.size() + 1);
+			vector<int> range(v.begin() + first, v.begin() + last);
+			c.insert(idx, c.begin() + first, c.begin() + last);
+			v.insert(v.begin() + idx, range.begin(), range.end());
+			break;
+		}
+		case 6:
+			c.append(other);
+			v.insert(v.end(), otherValues.begin(), otherValues.end());
+			matched = matched && same(other, otherValues);
+			break;
+		case 7:
+			c.append(move(other));
+			v.insert(v.end(), otherValues.begin(), otherValues.end());
+			matched = matched && other.empty();
+			break;
+		case 8:
+			c.assign(other.begin(), other.end());
+			v = otherValues;
+			break;
+		case 9:
+			c.assign(c.begin() + first, c.begin() + last);
+			v = vector<int>(v.begin() + first, v.begin() + last);
+			break;
+		}
+		matched = matched && same(c, v);
+	}
+	return matched;
+}
+
+// Checks a copy that throws partway through a range insert leaves the collection as it was
+template <class C>
+bool insertRollsBack(C &c, vector<int> const &v) {
+	C other = { 1, 2, 3, 4, 5 };
+	long long liveBefore = Counted::live;
+	Counted::copiesBeforeThrow = 3;
+	bool threw = false;
+	try {
+		c.insert(v.size() / 2, other.begin(), other.end());
+	}
+	catch (runtime_error &e) {
+		threw = true;
+	}
+	Counted::copiesBeforeThrow = -1;
+	return threw && Counted::live == liveBefore && same(c, v);
+}
+
+int main(void) {
+	mt19937 rng(11);
+
+	// Placement construction: only live items are ever constructed or destroyed
+	{
+		Collection<Counted> c(100);
+		check(c.capacity() == 100 && c.empty() && Counted::live == 0 && Counted::constructions == 0, "preallocating constructs no items");
+
+		vector<int> v;
+		bool matched = true;
+		for (int step = 0; step < 20000; ++step) {
+			int value = static_cast<int>(rng() % 1000);
+			switch (v.empty() ? 0 : rng() % 7) {
+			case 0:
+			case 1:
+				c.push(Counted(value));
+				v.push_back(value);
+				break;
+			case 2:
+				c.emplace_back(value);
+				v.push_back(value);
+				break;
+			case 3: {
+				size_t idx = rng() % (v.size() + 1);
+				c.emplace(idx, value);
+				v.insert(v.begin() + idx, value);
+				break;
+			}
+			case 4: {
+				size_t idx = rng() % v.size();
+				c.erase(idx);
+				v.erase(v.begin() + idx);
+				break;
+			}
+			case 5: {
+				// An item of the collection itself, which may move as it grows
+				size_t idx = rng() % (v.size() + 1);
+				c.insert(idx, c[v.size() - 1]);
+				v.insert(v.begin() + idx, v.back());
+				break;
+			}
+			case 6: {
+				size_t idx1 = rng() % v.size(), idx2 = rng() % v.size();
+				c.swap(idx1, idx2);
+				swap(v[idx1], v[idx2]);
+				break;
+			}
+			}
+			matched = matched && Counted::live == static_cast<long long>(v.size());
+		}
+		check(matched && same(c, v), "push, emplace, insert, erase and swap match std::vector (" + to_string(v.size()) + " items)");
+		check(Counted::live == static_cast<long long>(c.size()), "live items match the size");
+
+		long long before = Counted::constructions;
+		c.reserve(c.capacity() * 2);
+		check(Counted::constructions - before == static_cast<long long>(c.size()) && same(c, v), "reserve moves each item once, building no spares");
+
+		c.resize(c.size() + 10, Counted(7));
+		v.resize(v.size() + 10, 7);
+		c.resize(c.size() + 5);
+		v.resize(v.size() + 5, 0);
+		check(same(c, v) && Counted::live == static_cast<long long>(c.size()), "resize up builds only the new items");
+		c.resize(c.size() - 30);
+		v.resize(v.size() - 30);
+		check(same(c, v) && Counted::live == static_cast<long long>(c.size()), "resize down destroys only the removed items");
+
+		c.shrink_to_fit();
+		check(c.capacity() == c.size() && same(c, v), "shrink_to_fit");
+		c.clear();
+		check(c.empty() && Counted::live == 0 && c.capacity() > 0, "clear destroys every item and keeps the array");
+	}
+	check(Counted::live == 0 && Counted::misuses == 0, "no item destroyed twice or used after destruction");
+	cout << endl;
+
+	// Allocators: propagation on copy, move and swap
+	{
+		Arena a = { 0 }, b = { 0 };
+		typedef Collection<Counted, ArenaAllocator<Counted, true>> Propagating;
+		typedef Collection<Counted, ArenaAllocator<Counted, false>> Staying;
+		vector<int> v = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+		Propagating p1({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }, &a);
+		Propagating p2({ 1, 2 }, &b);
+		check(a.items == 10 && b.items == 2, "memory comes from the given allocator");
+
+		Propagating copied(p1);
+		check(same(copied, v) && copied.get_allocator() == p1.get_allocator(), "copy constructor selects the source's allocator");
+		Propagating copiedToB(p1, &b);
+		check(same(copiedToB, v) && copiedToB.get_allocator().arena == &b, "copy constructor with an allocator uses it");
+
+		p2 = p1;
+		check(same(p2, v) && p2.get_allocator().arena == &a, "copy assignment propagates the allocator");
+		p2 = Propagating({ 3 }, &b);
+		check(p2.size() == 1 && p2[0].get() == 3 && p2.get_allocator().arena == &b, "move assignment propagates the allocator");
+		p1.swap(p2);
+		check(same(p2, v) && p2.get_allocator().arena == &a && p1.get_allocator().arena == &b, "swap propagates the allocators");
+
+		Staying s1({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }, &a);
+		Staying s2({ 1 }, &b);
+		s2 = s1;
+		check(same(s2, v) && s2.get_allocator().arena == &b, "copy assignment keeps a non-propagating allocator");
+		Staying s3({ 4, 5 }, &b);
+		s3 = move(s1);
+		check(same(s3, v) && s3.get_allocator().arena == &b, "move assignment between unequal allocators moves item by item");
+		Staying s4(move(s2), &a);
+		check(same(s4, v) && s4.get_allocator().arena == &a, "move constructor with an unequal allocator moves item by item");
+		Staying s5({ 9 }, &a);
+		s5.swap(s4);
+		check(same(s5, v) && s4.size() == 1 && s5.get_allocator().arena == &a, "swap with equal allocators");
+	}
+	check(misfrees == 0 && owners.empty(), "every array went back to the allocator that made it");
+	check(Counted::live == 0 && Counted::misuses == 0, "no item destroyed twice or used after destruction");
+
+	// mylib::pmr::Collection draws from a memory resource
+	{
+		CountingResource resource;
+		{
+			mylib::pmr::Collection<Counted> c((std::pmr::polymorphic_allocator<Counted>(&resource)));
+			for (int i = 0; i < 1000; ++i) {
+				c.emplace_back(i);
+			}
+			check(c.get_allocator().resource() == &resource && resource.bytes >= static_cast<long long>(1000 * sizeof(Counted)),
+				"pmr::Collection allocates from its resource");
+
+			mylib::pmr::Collection<Counted> copy(c);
+			check(copy.get_allocator().resource() == std::pmr::get_default_resource() && copy.size() == 1000 && copy[999].get() == 999,
+				"copying a pmr::Collection uses the default resource, as std::pmr containers do");
+			mylib::pmr::Collection<Counted> moved(move(c));
+			check(moved.get_allocator().resource() == &resource && moved.size() == 1000 && c.empty(), "moving keeps the resource");
+		}
+		check(resource.bytes == 0, "pmr::Collection gives every byte back");
+	}
+	check(Counted::live == 0 && Counted::misuses == 0, "no item destroyed twice or used after destruction");
+	cout << endl;
+
+	// SmallCollection: inline until the items outgrow it, then on the heap
+	{
+		Arena a = { 0 }, b = { 0 };
+		typedef SmallCollection<Counted, 4, ArenaAllocator<Counted, true>> Small;
+
+		Small c(&a);
+		vector<int> v;
+		for (int i = 0; i < 4; ++i) {
+			c.push(i);
+			v.push_back(i);
+		}
+		check(c.isInline() && c.capacity() == 4 && a.items == 0 && same(c, v), "the first N items stay inline, allocating nothing");
+		c.push(4);
+		v.push_back(4);
+		check(!c.isInline() && a.items > 0 && same(c, v) && Counted::live == 5, "item N + 1 moves everything to the heap");
+		c.clear();
+		check(!c.isInline() && Counted::live == 0, "clear keeps the heap array");
+		c = { 1, 2 };
+		v = { 1, 2 };
+		c.shrink_to_fit();
+		check(c.isInline() && a.items == 0 && same(c, v), "shrink_to_fit brings few enough items back inline");
+
+		Small copy(c);
+		check(copy.isInline() && same(copy, v), "copy of an inline collection is inline");
+		Small moved(move(copy));
+		check(moved.isInline() && same(moved, v) && copy.empty() && Counted::live == 4, "move of an inline collection moves the items");
+
+		Small big({ 10, 11, 12, 13, 14, 15 }, &b);
+		moved.swap(big);
+		check(same(moved, { 10, 11, 12, 13, 14, 15 }) && same(big, v) && !moved.isInline() && big.isInline()
+			&& moved.get_allocator().arena == &b && big.get_allocator().arena == &a, "swap of inline and heap items, allocators following their arrays");
+
+		big = moved;
+		check(!big.isInline() && same(big, { 10, 11, 12, 13, 14, 15 }) && big.get_allocator().arena == &b, "copy assignment onto an inline collection");
+		moved = Small({ 5 }, &a);
+		check(moved.isInline() && b.items > 0 && same(moved, { 5 }), "move assignment of inline items gives up the heap array");
+
+		mt19937 smallRng(43);
+		Small ranged(&a);
+		vector<int> rangedValues;
+		check(rangeOperations(ranged, rangedValues, smallRng), "range erase, insert, append and assign cross between inline and heap");
+	}
+	check(misfrees == 0 && owners.empty(), "every array went back to the allocator that made it");
+	check(Counted::live == 0 && Counted::misuses == 0, "no item destroyed twice or used after destruction");
+	cout << endl;
+
+	// Growth policies and relocation
+	{
+		vector<size_t> doubles, halves, pages;
+		check(followsGrowth<DoubleGrowth>(doubles) && doubles[0] == 8 && doubles[1] == 16 && doubles[2] == 32, "DoubleGrowth: 8, 16, 32 ...");
+		check(followsGrowth<HalfGrowth>(halves) && halves[0] == 8 && halves[1] == 12 && halves[2] == 18, "HalfGrowth: 8, 12, 18 ...");
+		bool wholePages = followsGrowth<PageGrowth>(pages);
+		for (size_t capacity : pages) {
+			wholePages = wholePages && capacity * sizeof(int) % PageGrowth::PAGE_SIZE == 0;
+		}
+		check(wholePages && pages[0] == PageGrowth::PAGE_SIZE / sizeof(int), "PageGrowth fills whole pages");
+
+		// Items that can't be relocated are moved one by one
+		Collection<Counted> moving;
+		for (int i = 0; i < 1000; ++i) {
+			moving.emplace_back(i);
+		}
+		long long before = Counted::constructions;
+		moving.reserve(5000);
+		check(Counted::constructions - before == 1000, "growing moves each item that isn't trivially relocatable");
+
+		// Trivially relocatable items are copied bytewise, nothing is constructed or destroyed
+		Collection<Relocatable> copying;
+		vector<int> v;
+		for (int i = 0; i < 1000; ++i) {
+			copying.emplace_back(i);
+			v.push_back(i);
+		}
+		before = Counted::constructions;
+		long long liveBefore = Counted::live;
+		copying.reserve(5000);
+		check(Counted::constructions == before && Counted::live == liveBefore && same(copying, v), "growing relocates trivially relocatable items with memcpy");
+
+		// With MallocAllocator the array itself is resized by realloc
+		Collection<Relocatable, CountingMallocAllocator<Relocatable>> resizing;
+		vector<int> resizingValues;
+		for (int i = 0; i < 100000; ++i) {
+			resizing.emplace_back(i);
+			resizingValues.push_back(i);
+		}
+		check(CountingMallocAllocator<Relocatable>::reallocations > 0 && same(resizing, resizingValues)
+			&& Counted::live == liveBefore + 100000, "MallocAllocator grows the array with realloc");
+		before = Counted::constructions;
+		long long reallocations = CountingMallocAllocator<Relocatable>::reallocations;
+		resizing.erase(100, 99000);
+		resizingValues.erase(resizingValues.begin() + 100, resizingValues.begin() + 99000);
+		resizing.shrink_to_fit();
+		check(CountingMallocAllocator<Relocatable>::reallocations == reallocations + 1 && Counted::constructions == before
+			&& same(resizing, resizingValues), "shrink_to_fit resizes with realloc too");
+
+		Collection<int, MallocAllocator<int>, PageGrowth> ints;
+		vector<int> intValues;
+		for (int i = 0; i < 100000; ++i) {
+			ints.push(i);
+			intValues.push_back(i);
+		}
+		check(ints.size() == intValues.size() && equal(ints.begin(), ints.end(), intValues.begin()), "MallocAllocator with PageGrowth");
+	}
+	check(Counted::live == 0 && Counted::misuses == 0, "no item destroyed twice or used after destruction");
+	cout << endl;
+
+	// Range erase, insert, append and assign, through both the move and the memmove paths
+	{
+		Collection<Counted> moving;
+		vector<int> v;
+		bool matched = rangeOperations(moving, v, rng);
+		check(matched, "range operations match std::vector (" + to_string(v.size()) + " items)");
+		check(Counted::live == static_cast<long long>(moving.size()), "live items match the size");
+		check(insertRollsBack(moving, v), "a copy throwing partway through a range insert changes nothing");
+
+		Collection<Relocatable> relocating;
+		vector<int> relocatingValues;
+		matched = rangeOperations(relocating, relocatingValues, rng);
+		check(matched, "range operations on trivially relocatable items match std::vector (" + to_string(relocatingValues.size()) + " items)");
+		check(insertRollsBack(relocating, relocatingValues), "a throwing range insert closes the gap it made");
+
+		Collection<Counted> whole = { 1, 2, 3 };
+		Collection<Counted> empty;
+		empty.append(move(whole));
+		check(same(empty, { 1, 2, 3 }) && whole.empty() && whole.capacity() == 0, "appending to an empty collection takes the array whole");
+		empty.append(empty);
+		check(same(empty, { 1, 2, 3, 1, 2, 3 }), "appending a collection to itself");
+	}
+	check(Counted::live == 0 && Counted::misuses == 0, "no item destroyed twice or used after destruction");
+
+	cout << endl << (failures ? "FAILED: " + to_string(failures) : string("All passed")) << endl;
+
+	return failures != 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+/* MallocAllocator
+ * An allocator taking memory from malloc, which lets it resize an allocation
+ * with realloc. Collections of trivially relocatable items grow through that,
+ * so a large array usually grows in place, or is remapped by the system
+ * rather than copied */
+
+#include <cstdlib> /* std::malloc, std::realloc, std::free */
+#include <cstddef> /* std::size_t, std::max_align_t */
+#include <cstdint> /* SIZE_MAX */
+#include <new> /* std::bad_alloc, std::bad_array_new_length */
+#include <type_traits> /* std::true_type */
+#include "Collection.hpp"
+
+_MYLIB_BEGIN
+template <class T>
+struct MallocAllocator {
+	static_assert(alignof(T) <= alignof(std::max_align_t), "malloc can't align T");
+
+	using value_type = T;
+	using is_always_equal = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+
+	MallocAllocator() noexcept = default;
+	template <class U>
+	MallocAllocator(MallocAllocator<U> const &) noexcept {}
+
+	// Allocates room for count items, throwing std::bad_alloc if there isn't any
+	T *allocate(size_t count) {
+		if (count > SIZE_MAX / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+
+		void *p = std::malloc(count * sizeof(T));
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T *>(p);
+	}
+
+	// Frees an allocation
+	void deallocate(T *p, size_t) noexcept {
+		std::free(p);
+	}
+
+	// Resizes an allocation of oldCount items to newCount, keeping its bytes
+	// It may move, and on failure throws std::bad_alloc and leaves p as it was
+	T *reallocate(T *p, size_t, size_t newCount) {
+		if (newCount > SIZE_MAX / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+
+		void *resized = std::realloc(static_cast<void *>(p), newCount * sizeof(T));
+		if (resized == nullptr) {
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T *>(resized);
+	}
+};
+
+// All MallocAllocators share the one heap, so any can free another's memory
+template <class T, class U>
+inline bool operator==(MallocAllocator<T> const &, MallocAllocator<U> const &) {
+	return true;
+}
+
+template <class T, class U>
+inline bool operator!=(MallocAllocator<T> const &, MallocAllocator<U> const &) {
+	return false;
+}
+_MYLIB_END
@@ -0,0 +1,581 @@
+#pragma once
+/* MappedCollection
+ * A collection of trivially copyable items kept in a memory mapped file
+ *
+ * The file starts with a header of HEADER_SIZE bytes, recording the item size
+ * and count, followed by the items themselves. Opening a file maps it rather
+ * than reading it, so a collection saved by one run is there for the next in
+ * constant time, and can be larger than memory. Items must not hold pointers
+ * meant to outlive the process.
+ *
+ * The mode picks what writes do:
+ *   ReadOnly - the file is mapped read only, and nothing may be changed
+ *   ReadWrite - changes go to the file, which grows with ftruncate as the
+ *     collection does and is remapped (with mremap on Linux)
+ *   CopyOnWrite - changes stay private to the process; once it has to grow,
+ *     the items move to anonymous memory
+ *
+ * The system writes dirty pages back when it likes; sync() forces it. Growing
+ * can move the mapping, invalidating pointers just as with Collection. A
+ * ReadWrite file is cut back to its items when the collection is destroyed,
+ * but a file that was rejected on opening is left untouched.
+ *
+ * Changing a ReadOnly collection, including taking a writable reference or
+ * iterator with the non-const operator[], begin() or end(), throws
+ * std::logic_error; read it through a const reference instead. POSIX only */
+
+#include <assert.h> /* assert() */
+#include <utility> /* std::move, std::forward */
+#include <cstddef> /* std::size_t */
+#include <cstdint> /* std::uint64_t, SIZE_MAX */
+#include <cstring> /* std::memcpy, std::memmove, std::memcmp */
+#include <cerrno> /* errno */
+#include <string> /* std::string */
+#include <new> /* placement new */
+#include <stdexcept> /* std::runtime_error, std::length_error, std::logic_error */
+#include <system_error> /* std::system_error, std::generic_category */
+#include <type_traits> /* std::is_trivially_copyable */
+#include <fcntl.h> /* open */
+#include <unistd.h> /* close, ftruncate */
+#include <sys/mman.h> /* mmap, mremap, munmap, msync */
+#include <sys/stat.h> /* fstat */
+#include "Collection.hpp"
+
+_MYLIB_BEGIN
+// How a MappedCollection opens its file
+enum class MapMode {
+	ReadOnly, // Mapped read only, the file must exist
+	ReadWrite, // Changes are written to the file, which is created if missing
+	CopyOnWrite // Changes stay in the process, the file must exist
+};
+
+template <class T, class Growth = PageGrowth>
+class MappedCollection {
+	static_assert(std::is_trivially_copyable<T>::value, "MappedCollection items must be trivially copyable");
+
+public:
+	// Bytes before the first item, which keeps it aligned to this
+	static const size_t HEADER_SIZE = 64;
+	static_assert(alignof(T) <= HEADER_SIZE, "MappedCollection can't align T");
+
+	/* Types */
+	using value_type = T;
+
+	/* Iterators */
+	using iterator = T *;
+	using const_iterator = T const *;
+
+	iterator begin() { checkWritable(); return base(); } // Returns iterator to beginning, throwing if ReadOnly
+	const_iterator begin() const { return base(); } // Returns const iterator to beginning
+
+	iterator end() { checkWritable(); return base() + size(); } // Returns iterator to end, throwing if ReadOnly
+	const_iterator end() const { return base() + size(); } // Returns const iterator to end
+
+	/* Constuctors */
+	MappedCollection(std::string const &path, MapMode mode = MapMode::ReadWrite); // Opens and maps a file
+	MappedCollection(MappedCollection const &) = delete;
+	MappedCollection(MappedCollection &&toMove) noexcept; // Move constructor
+
+	/* Deconstructor - unmaps and closes the file, trimming a ReadWrite one to its items */
+	~MappedCollection();
+
+	/* Function members */
+	size_t size() const; // Returns collection size
+	size_t capacity() const; // Returns count of items the mapping has room for
+	bool empty() const; // Checks if collection is empty
+	MapMode mode() const; // Returns the mode the file was opened in
+
+	void reserve(size_t count); // Maps room for at least count items
+	void resize(size_t count); // Adds value initialised items or removes items from the end until there are count
+	void resize(size_t count, T const &t); // Adds copies of item or removes items from the end until there are count
+	void shrink_to_fit(); // Unmaps, and for ReadWrite truncates, any room beyond the current size
+	void sync(); // Writes changes to a ReadWrite file out, waiting until they are on disk
+
+	void push(T const &t); // Copies a new item onto the end of the collection
+	template<class... Args>
+	T &emplace_back(Args &&...args); // Constructs a new item in place at the end of the collection
+	void erase(size_t idx); // Removes item from collection at specified index
+	void erase(size_t first, size_t last); // Removes items [first, last) from collection
+	void insert(size_t idx, T const &t); // Inserts a copy of item into collection at specified index
+	void clear(); // Clears the collection of all items
+	void swap(size_t idx1, size_t idx2); // Swaps two items in the collection
+
+	/* Operators */
+	T &operator[](size_t idx); // Overload [] for accessing index
+	T const &operator[](size_t idx) const; // Const overload for accessing index
+
+	MappedCollection &operator=(MappedCollection const &) = delete;
+	MappedCollection &operator=(MappedCollection &&toMove) noexcept; // Closes this file and takes another
+
+private:
+	// Start of the file
+	struct Header {
+		char magic[8]; // MAGIC
+		std::uint64_t itemSize; // sizeof(T) of the writer
+		std::uint64_t size; // Count of items
+	};
+	static_assert(sizeof(Header) <= HEADER_SIZE, "MappedCollection header doesn't fit");
+
+	// Identifies a MappedCollection file
+	static constexpr char MAGIC[8] = { 'M', 'Y', 'L', 'I', 'B', 'C', 'O', 'L' };
+
+	/* Storage members */
+	std::string m_path; // File name, for error messages
+	int m_fd; // Open file, -1 once closed
+	MapMode m_mode; // How the file was opened
+	unsigned char *m_pMap; // Mapping of the header and items
+	size_t m_mapped; // Bytes mapped
+	bool m_anonymous; // Whether a CopyOnWrite collection has moved to anonymous memory
+	bool m_valid; // Whether the header was checked or written, so the file may be trimmed
+
+	/* Support functions */
+	Header *header(); // Returns the header in the mapping
+	Header const *header() const;
+	void mapFile(size_t length); // Maps the first length bytes of the file
+	void remap(size_t length); // Resizes the mapping to length bytes, growing the file first if it's written to
+	void growIfNeed(size_t count); // Grows the mapping if more space is needed
+	void checkWritable() const; // Throws if the collection is ReadOnly
+	void close() noexcept; // Unmaps and closes the file, trimming a ReadWrite one to its items
+	[[noreturn]] void fail(char const *action) const; // Throws the error errno holds
+
+	/* Returns the base address of data (Can change when adding elements!) */
+	T *base() { return m_pMap ? reinterpret_cast<T *>(m_pMap + HEADER_SIZE) : nullptr; }
+	T const *base() const { return m_pMap ? reinterpret_cast<T const *>(m_pMap + HEADER_SIZE) : nullptr; }
+};
+
+// ------
+// Public
+// ------
+
+// Opens and maps a file
+// An empty ReadWrite file is given a header; any other file must have one written for the same T
+template<class T, class Growth>
+inline MappedCollection<T, Growth>::MappedCollection(std::string const &path, MapMode mode)
+	: m_path(path), m_fd(-1), m_mode(mode), m_pMap(nullptr), m_mapped(0), m_anonymous(false), m_valid(false) {
+	m_fd = ::open(path.c_str(), mode == MapMode::ReadWrite ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+	if (m_fd < 0) {
+		fail("open");
+	}
+
+	try {
+		struct stat status;
+		if (::fstat(m_fd, &status) != 0) {
+			fail("read the size of");
+		}
+
+		size_t length = static_cast<size_t>(status.st_size);
+		bool created = length == 0 && mode == MapMode::ReadWrite;
+		if (created) {
+			length = HEADER_SIZE;
+			if (::ftruncate(m_fd, static_cast<off_t>(length)) != 0) {
+				fail("grow");
+			}
+		}
+
+		if (length < HEADER_SIZE) {
+			throw std::runtime_error("Not a MappedCollection file: " + m_path);
+		}
+
+		mapFile(length);
+
+		if (created) {
+			std::memcpy(header()->magic, MAGIC, sizeof(MAGIC));
+			header()->itemSize = sizeof(T);
+			header()->size = 0;
+		}
+		else if (std::memcmp(header()->magic, MAGIC, sizeof(MAGIC)) != 0) {
+			throw std::runtime_error("Not a MappedCollection file: " + m_path);
+		}
+		else if (header()->itemSize != sizeof(T)) {
+			throw std::runtime_error("MappedCollection item size differs: " + m_path);
+		}
+		else if (header()->size > capacity()) {
+			throw std::runtime_error("MappedCollection file is truncated: " + m_path);
+		}
+
+		m_valid = true;
+	}
+	catch (...) {
+		close();
+		throw;
+	}
+}
+
+// Move constructor
+template<class T, class Growth>
+inline MappedCollection<T, Growth>::MappedCollection(MappedCollection &&toMove) noexcept
+	: m_path(std::move(toMove.m_path)), m_fd(toMove.m_fd), m_mode(toMove.m_mode),
+	m_pMap(toMove.m_pMap), m_mapped(toMove.m_mapped), m_anonymous(toMove.m_anonymous), m_valid(toMove.m_valid) {
+	toMove.m_fd = -1;
+	toMove.m_pMap = nullptr;
+	toMove.m_mapped = 0;
+	toMove.m_valid = false;
+}
+
+// Deconstructor, which unmaps and closes the file
+template<class T, class Growth>
+inline MappedCollection<T, Growth>::~MappedCollection() {
+	close();
+}
+
+// Returns current size of collection, which lives in the file's header
+template<class T, class Growth>
+inline size_t MappedCollection<T, Growth>::size() const {
+	return m_pMap ? static_cast<size_t>(header()->size) : 0;
+}
+
+// Returns count of items the mapping has room for
+template<class T, class Growth>
+inline size_t MappedCollection<T, Growth>::capacity() const {
+	return m_pMap ? (m_mapped - HEADER_SIZE) / sizeof(T) : 0;
+}
+
+// Checks if the collection is empty
+template<class T, class Growth>
+inline bool MappedCollection<T, Growth>::empty() const {
+	return !size();
+}
+
+// Returns the mode the file was opened in
+template<class T, class Growth>
+inline MapMode MappedCollection<T, Growth>::mode() const {
+	return m_mode;
+}
+
+// Maps room for at least count items
+// Unlike growing, this maps exactly count when more room is needed
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::reserve(size_t count) {
+	checkWritable();
+
+	if (count > capacity()) {
+		if (count > (SIZE_MAX - HEADER_SIZE) / sizeof(T)) {
+			throw std::length_error("MappedCollection too large");
+		}
+		remap(HEADER_SIZE + count * sizeof(T));
+	}
+}
+
+// Adds value initialised items or removes items from the end until there are count
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::resize(size_t count) {
+	checkWritable();
+
+	size_t oldSize = size();
+	if (count > oldSize) {
+		growIfNeed(count - oldSize);
+		for (T *item = base() + oldSize; item != base() + count; ++item) {
+			new (item) T();
+		}
+	}
+
+	header()->size = count;
+}
+
+// Adds copies of item or removes items from the end until there are count
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::resize(size_t count, T const &item) {
+	checkWritable();
+
+	size_t oldSize = size();
+	if (count > oldSize) {
+		// item may be in the mapping about to move
+		T copy(item);
+		growIfNeed(count - oldSize);
+		for (T *next = base() + oldSize; next != base() + count; ++next) {
+			new (next) T(copy);
+		}
+	}
+
+	header()->size = count;
+}
+
+// Unmaps any room beyond the current size, truncating a ReadWrite file to match
+// A CopyOnWrite mapping of the file itself keeps its length, as the file can't change
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::shrink_to_fit() {
+	checkWritable();
+
+	if (size() == capacity() || (m_mode == MapMode::CopyOnWrite && !m_anonymous)) {
+		return;
+	}
+
+	size_t length = HEADER_SIZE + size() * sizeof(T);
+	remap(length);
+	if (m_mode == MapMode::ReadWrite && ::ftruncate(m_fd, static_cast<off_t>(length)) != 0) {
+		fail("truncate");
+	}
+}
+
+// Writes changes to a ReadWrite file out, waiting until they are on disk
+// Other modes have nothing to write
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::sync() {
+	if (m_mode == MapMode::ReadWrite && m_pMap && ::msync(m_pMap, m_mapped, MS_SYNC) != 0) {
+		fail("sync");
+	}
+}
+
+// Copies a new item onto the end of the collection
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::push(T const &newItem) {
+	emplace_back(newItem);
+}
+
+// Constructs a new item in place at the end of the collection
+// The item is built before the mapping can move, so args may refer to an item of this collection
+template<class T, class Growth>
+template<class... Args>
+inline T &MappedCollection<T, Growth>::emplace_back(Args &&...args) {
+	checkWritable();
+
+	T item(std::forward<Args>(args)...);
+	growIfNeed(1);
+
+	size_t idx = size();
+	new (base() + idx) T(item);
+	header()->size = idx + 1;
+
+	return base()[idx];
+}
+
+// Removes item from collection, decreases size, and shifts array left
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::erase(size_t idx) {
+	checkWritable();
+
+	// Check if the index is valid
+	if (idx >= size()) {
+		return;
+	}
+
+	erase(idx, idx + 1);
+}
+
+// Removes items [first, last) from collection, shifting the rest left in one memmove
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::erase(size_t first, size_t last) {
+	checkWritable();
+
+	assert(first <= last && last <= size());
+
+	if (first == last) {
+		return;
+	}
+
+	std::memmove(static_cast<void *>(base() + first), static_cast<void const *>(base() + last), (size() - last) * sizeof(T));
+	header()->size -= last - first;
+}
+
+// Inserts a copy of item at specified index, shifting the rest right in one memmove
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::insert(size_t idx, T const &item) {
+	checkWritable();
+
+	assert(idx <= size());
+
+	// item may be in the mapping about to move
+	T copy(item);
+	growIfNeed(1);
+
+	std::memmove(static_cast<void *>(base() + idx + 1), static_cast<void const *>(base() + idx), (size() - idx) * sizeof(T));
+	new (base() + idx) T(copy);
+	header()->size += 1;
+}
+
+// Clears the collection of all items, keeping the mapping
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::clear() {
+	checkWritable();
+
+	if (m_pMap) {
+		header()->size = 0;
+	}
+}
+
+// Swaps two items by index
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::swap(size_t idx1, size_t idx2) {
+	checkWritable();
+
+	// Ensure indexes are valid
+	assert(idx1 < size() && idx2 < size());
+
+	T temp(base()[idx1]);
+	base()[idx1] = base()[idx2];
+	base()[idx2] = temp;
+}
+
+// Bracket operator to access specified index
+template<class T, class Growth>
+inline T &MappedCollection<T, Growth>::operator[](size_t idx) {
+	checkWritable();
+
+	assert(idx < size());
+
+	return base()[idx];
+}
+
+// Const bracket operator to access specified index
+template<class T, class Growth>
+inline T const &MappedCollection<T, Growth>::operator[](size_t idx) const {
+	assert(idx < size());
+
+	return base()[idx];
+}
+
+// Closes this collection's file and takes toMove's
+template<class T, class Growth>
+inline MappedCollection<T, Growth> &MappedCollection<T, Growth>::operator=(MappedCollection &&toMove) noexcept {
+	if (this == &toMove) {
+		return *this;
+	}
+
+	close();
+	m_path = std::move(toMove.m_path);
+	m_fd = toMove.m_fd;
+	m_mode = toMove.m_mode;
+	m_pMap = toMove.m_pMap;
+	m_mapped = toMove.m_mapped;
+	m_anonymous = toMove.m_anonymous;
+	m_valid = toMove.m_valid;
+
+	toMove.m_fd = -1;
+	toMove.m_pMap = nullptr;
+	toMove.m_mapped = 0;
+	toMove.m_valid = false;
+
+	return *this;
+}
+
+
+// -------
+// Private
+// -------
+
+// Returns the header at the start of the mapping
+template<class T, class Growth>
+inline typename MappedCollection<T, Growth>::Header *MappedCollection<T, Growth>::header() {
+	return reinterpret_cast<Header *>(m_pMap);
+}
+
+template<class T, class Growth>
+inline typename MappedCollection<T, Growth>::Header const *MappedCollection<T, Growth>::header() const {
+	return reinterpret_cast<Header const *>(m_pMap);
+}
+
+// Maps the first length bytes of the file, shared unless copying on write
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::mapFile(size_t length) {
+	int protection = m_mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+	int flags = m_mode == MapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+
+	void *pMap = ::mmap(nullptr, length, protection, flags, m_fd, 0);
+	if (pMap == MAP_FAILED) {
+		fail("map");
+	}
+
+	m_pMap = static_cast<unsigned char *>(pMap);
+	m_mapped = length;
+}
+
+// Resizes the mapping to length bytes
+// A ReadWrite file grows first, as pages past its end can't be touched. A
+// CopyOnWrite mapping of the file can't grow past it either, so the first
+// time it grows the items are copied to anonymous memory instead
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::remap(size_t length) {
+	if (m_mode == MapMode::ReadWrite && length > m_mapped && ::ftruncate(m_fd, static_cast<off_t>(length)) != 0) {
+		fail("grow");
+	}
+
+	if (m_mode == MapMode::CopyOnWrite && !m_anonymous) {
+		void *pMap = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (pMap == MAP_FAILED) {
+			fail("map memory for");
+		}
+
+		std::memcpy(pMap, m_pMap, length < m_mapped ? length : m_mapped);
+		::munmap(m_pMap, m_mapped);
+		m_pMap = static_cast<unsigned char *>(pMap);
+		m_mapped = length;
+		m_anonymous = true;
+		return;
+	}
+
+#if defined(__linux__)
+	void *pMap = ::mremap(m_pMap, m_mapped, length, MREMAP_MAYMOVE);
+	if (pMap == MAP_FAILED) {
+		fail("remap");
+	}
+
+	m_pMap = static_cast<unsigned char *>(pMap);
+	m_mapped = length;
+#else
+	// Without mremap, map afresh and drop the old mapping
+	unsigned char *pOld = m_pMap;
+	size_t oldLength = m_mapped;
+	if (m_anonymous) {
+		void *pMap = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (pMap == MAP_FAILED) {
+			fail("map memory for");
+		}
+
+		std::memcpy(pMap, pOld, length < oldLength ? length : oldLength);
+		m_pMap = static_cast<unsigned char *>(pMap);
+		m_mapped = length;
+	}
+	else {
+		mapFile(length);
+	}
+	::munmap(pOld, oldLength);
+#endif
+}
+
+// Grows the mapping by the Growth policy if count more items don't fit
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::growIfNeed(size_t count) {
+	if (size() + count <= capacity()) {
+		return;
+	}
+
+	reserve(Growth::capacity(capacity(), size() + count, sizeof(T)));
+}
+
+// Throws std::logic_error if the collection is ReadOnly, whose mapping can't be written
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::checkWritable() const {
+	if (m_mode == MapMode::ReadOnly) {
+		throw std::logic_error("MappedCollection is read only: " + m_path);
+	}
+}
+
+// Unmaps and closes the file, trimming a ReadWrite one to its items
+// A file whose header was never validated is left as it was, since its
+// count can't be trusted. Errors are ignored: the header already records how
+// many items there are
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::close() noexcept {
+	if (m_pMap) {
+		size_t length = HEADER_SIZE + size() * sizeof(T);
+		::munmap(m_pMap, m_mapped);
+		if (m_mode == MapMode::ReadWrite && m_valid) {
+			(void)::ftruncate(m_fd, static_cast<off_t>(length));
+		}
+		m_pMap = nullptr;
+		m_mapped = 0;
+	}
+	m_valid = false;
+
+	if (m_fd >= 0) {
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+// Throws a system_error for errno, naming the action and the file
+template<class T, class Growth>
+inline void MappedCollection<T, Growth>::fail(char const *action) const {
+	throw std::system_error(errno, std::generic_category(), std::string("Cannot ") + action + " " + m_path);
+}
+_MYLIB_END
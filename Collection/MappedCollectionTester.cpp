@@ -0,0 +1,217 @@
+/* MappedCollectionTester
+ * A program to test MappedCollection against std::vector
+ * Prints 1 for each check that passes and 0 for each that fails. Writes and removes a file in /tmp */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm> /* std::equal */
+#include <random> /* std::mt19937 */
+#include <cstdio> /* std::remove */
+#include <stdexcept> /* std::logic_error, std::runtime_error */
+#include <unistd.h> /* getpid */
+#include <sys/stat.h> /* stat */
+#include "MappedCollection.hpp"
+
+using namespace std;
+using namespace mylib;
+
+int failures = 0;
+
+// Prints whether a check passed
+void check(bool passed, string const &what) {
+	cout << passed << ' ' << what << endl;
+	failures += !passed;
+}
+
+// Item with padding, as files usually hold
+struct Point {
+	int x;
+	double y;
+
+	bool operator==(Point const &p) const { return x == p.x && y == p.y; }
+};
+
+// Checks a collection against a vector
+template <class T>
+bool same(MappedCollection<T> const &c, vector<T> const &v) {
+	return c.size() == v.size() && c.empty() == v.empty() && equal(c.begin(), c.end(), v.begin(), v.end());
+}
+
+// Returns the size of a file in bytes, or -1 if it can't be read
+long long fileSize(string const &path) {
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 ? static_cast<long long>(info.st_size) : -1;
+}
+
+int main(void) {
+	string path = "/tmp/MappedCollectionTester." + to_string(getpid());
+	mt19937 rng(9);
+	vector<Point> v;
+
+	// ReadWrite: random changes go to the file
+	{
+		MappedCollection<Point> c(path);
+		check(c.empty() && c.mode() == MapMode::ReadWrite, "a new file opens empty");
+
+		bool matched = true;
+		for (int step = 0; step < 20000; ++step) {
+			Point p = { static_cast<int>(rng() % 1000), step / 8.0 };
+			switch (v.empty() ? 0 : rng() % 6) {
+			case 0:
+			case 1:
+				c.push(p);
+				v.push_back(p);
+				break;
+			case 2: {
+				size_t idx = rng() % (v.size() + 1);
+				c.insert(idx, p);
+				v.insert(v.begin() + idx, p);
+				break;
+			}
+			case 3: {
+				size_t idx = rng() % v.size();
+				c.erase(idx);
+				v.erase(v.begin() + idx);
+				break;
+			}
+			case 4: {
+				size_t idx1 = rng() % v.size(), idx2 = rng() % v.size();
+				c.swap(idx1, idx2);
+				swap(v[idx1], v[idx2]);
+				break;
+			}
+			case 5:
+				c.emplace_back(p) = p;
+				v.push_back(p);
+				break;
+			}
+			matched = matched && c.size() == v.size();
+		}
+		check(matched && same(c, v), "push, insert, erase and swap match std::vector (" + to_string(v.size()) + " items)");
+
+		c.erase(5, 105);
+		v.erase(v.begin() + 5, v.begin() + 105);
+		c[0] = Point{ -1, -1.0 };
+		v[0] = Point{ -1, -1.0 };
+		check(same(c, v), "erase of a range and assignment through operator[]");
+
+		c.reserve(100000);
+		check(c.capacity() >= 100000 && same(c, v), "reserve keeps the items");
+		c.sync();
+	}
+	size_t expectedSize = MappedCollection<Point>::HEADER_SIZE + v.size() * sizeof(Point);
+	check(fileSize(path) == static_cast<long long>(expectedSize), "closing trims the file to its items");
+
+	// Reopening ReadWrite finds the same items, and can keep growing
+	{
+		MappedCollection<Point> c(path);
+		check(same(c, v), "reopened ReadWrite holds the same items");
+		c.resize(v.size() + 10, Point{ 7, 7.0 });
+		v.resize(v.size() + 10, Point{ 7, 7.0 });
+		check(same(c, v), "resize with a value");
+	}
+
+	// ReadOnly: readable through a const reference, every change throws
+	{
+		MappedCollection<Point> c(path, MapMode::ReadOnly);
+		MappedCollection<Point> const &reader = c;
+		check(same(c, v) && reader[3] == v[3], "reopened ReadOnly holds the same items");
+		long long sum = 0;
+		for (Point const &p : reader) {
+			sum += p.x;
+		}
+		long long expectedSum = 0;
+		for (Point const &p : v) {
+			expectedSum += p.x;
+		}
+		check(sum == expectedSum, "ReadOnly iterates through a const reference");
+
+		int threw = 0;
+		try { c.push(Point{ 1, 1.0 }); } catch (logic_error &e) { ++threw; }
+		try { c.insert(0, Point{ 1, 1.0 }); } catch (logic_error &e) { ++threw; }
+		try { c.erase(0); } catch (logic_error &e) { ++threw; }
+		try { c.swap(0, 1); } catch (logic_error &e) { ++threw; }
+		try { c.resize(1); } catch (logic_error &e) { ++threw; }
+		try { c.clear(); } catch (logic_error &e) { ++threw; }
+		try { c[0].x = 99; } catch (logic_error &e) { ++threw; }
+		try {
+			for (Point &p : c) {
+				p.x = 99;
+			}
+		}
+		catch (logic_error &e) { ++threw; }
+		try { *(c.end() - 1) = Point{ 99, 99.0 }; } catch (logic_error &e) { ++threw; }
+		check(threw == 9, "every ReadOnly mutation throws logic_error, including non-const operator[], begin() and end()");
+		check(same(c, v), "ReadOnly items unchanged after the attempts");
+	}
+	check(fileSize(path) == static_cast<long long>(MappedCollection<Point>::HEADER_SIZE + v.size() * sizeof(Point)),
+		"closing a ReadOnly file leaves its size");
+
+	// CopyOnWrite: changes are seen but never reach the file
+	{
+		MappedCollection<Point> c(path, MapMode::CopyOnWrite);
+		c[0] = Point{ 42, 42.0 };
+		for (int i = 0; i < 50000; ++i) {
+			c.push(Point{ i, 0.0 });
+		}
+		check(c.size() == v.size() + 50000 && c[0] == Point{ 42, 42.0 }, "CopyOnWrite changes are visible, including growth");
+	}
+	{
+		MappedCollection<Point> c(path, MapMode::ReadOnly);
+		check(same(c, v), "CopyOnWrite changes are not written to the file");
+	}
+
+	// Wrong item type: rejected, and the file is left exactly as it was
+	long long sizeBefore = fileSize(path);
+	try {
+		MappedCollection<long long> wrong(path);
+		check(false, "reopening with another item size throws");
+	}
+	catch (runtime_error &e) {
+		check(true, "reopening with another item size throws");
+	}
+	check(fileSize(path) == sizeBefore, "a rejected ReadWrite reopen leaves the file size unchanged");
+	{
+		MappedCollection<Point> c(path, MapMode::ReadOnly);
+		check(same(c, v), "a rejected reopen leaves the items intact");
+	}
+
+	// Missing file: only ReadWrite creates it
+	string missing = path + ".missing";
+	try {
+		MappedCollection<Point> c(missing, MapMode::ReadOnly);
+		check(false, "ReadOnly on a missing file throws");
+	}
+	catch (runtime_error &e) {
+		check(fileSize(missing) == -1, "ReadOnly on a missing file throws and creates nothing");
+	}
+
+	// Move construction and assignment hand the file over
+	{
+		MappedCollection<Point> a(path);
+		MappedCollection<Point> b(move(a));
+		check(same(b, v), "move constructor");
+		MappedCollection<Point> c(missing);
+		c.push(Point{ 1, 2.0 });
+		c = move(b);
+		check(same(c, v), "move assignment");
+	}
+	check(fileSize(missing) == static_cast<long long>(MappedCollection<Point>::HEADER_SIZE + sizeof(Point)),
+		"move assignment closes and trims the file it replaced");
+
+	// Clearing a ReadWrite collection empties the file
+	{
+		MappedCollection<Point> c(path);
+		c.clear();
+		c.shrink_to_fit();
+	}
+	check(fileSize(path) == static_cast<long long>(MappedCollection<Point>::HEADER_SIZE), "clear and shrink_to_fit leave only the header");
+
+	remove(path.c_str());
+	remove(missing.c_str());
+
+	cout << endl << (failures ? "FAILED: " + to_string(failures) : string("All passed")) << endl;
+
+	return failures != 0;
+}
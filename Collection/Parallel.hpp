@@ -0,0 +1,286 @@
+#pragma once
+/* Parallel
+ * Parallel versions of common algorithms, run on ThreadPool::shared()
+ *
+ * Each takes either a range of random access iterators, or whole collections
+ * (Collection, SmallCollection or anything else with begin(), end() and, for
+ * outputs, resize()). Ranges shorter than SERIAL_THRESHOLD run serially on the
+ * calling thread, as does everything when the machine has a single core.
+ *
+ * Elements are handed out in chunks sized to give every thread several, and
+ * chunks are only split further while other threads are idle, so uneven work
+ * balances itself. reduce and inclusive_scan expect op to be associative, but
+ * not commutative: partial results are always combined in order. sort isn't
+ * stable. An exception thrown by a callback is rethrown once every thread has
+ * stopped working on the call */
+
+#include <cstddef> /* std::size_t */
+#include <vector> /* std::vector */
+#include <optional> /* std::optional */
+#include <algorithm> /* std::sort, std::merge, std::lower_bound, std::upper_bound, std::min */
+#include <iterator> /* std::iterator_traits, std::make_move_iterator */
+#include <functional> /* std::plus, std::less */
+#include <utility> /* std::move */
+#include "ThreadPool.hpp"
+
+_MYLIB_BEGIN
+namespace parallel {
+	// Ranges shorter than this run serially
+	const size_t SERIAL_THRESHOLD = 1024;
+
+	// Returns the chunk size for count elements: enough chunks for each thread to
+	// get 16, but at most 4096 elements in one so that splitting stays possible
+	inline size_t chunkSize(size_t count) {
+		size_t chunk = count / (ThreadPool::shared().concurrency() * 16);
+		return chunk < 1 ? 1 : chunk > 4096 ? 4096 : chunk;
+	}
+
+	// Calls f on every element of [first, last)
+	template <class Iter, class F>
+	void for_each(Iter first, Iter last, F f) {
+		size_t count = static_cast<size_t>(last - first);
+		if (count < SERIAL_THRESHOLD) {
+			for (; first != last; ++first) {
+				f(*first);
+			}
+			return;
+		}
+
+		ThreadPool::shared().forRange(0, count, chunkSize(count), [first, &f](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				f(first[i]);
+			}
+		});
+	}
+
+	// Calls f on every element of a collection
+	template <class C, class F>
+	void for_each(C &c, F f) {
+		parallel::for_each(c.begin(), c.end(), f);
+	}
+
+	// Writes f of each element of [first, last) to out, returning the end of the output
+	// out may be first
+	template <class Iter, class Out, class F>
+	Out transform(Iter first, Iter last, Out out, F f) {
+		size_t count = static_cast<size_t>(last - first);
+		if (count < SERIAL_THRESHOLD) {
+			for (; first != last; ++first, ++out) {
+				*out = f(*first);
+			}
+			return out;
+		}
+
+		ThreadPool::shared().forRange(0, count, chunkSize(count), [first, out, &f](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				out[i] = f(first[i]);
+			}
+		});
+
+		return out + count;
+	}
+
+	// Resizes out to match in, then writes f of each element of in to it
+	template <class C, class D, class F>
+	void transform(C const &in, D &out, F f) {
+		out.resize(in.size());
+		parallel::transform(in.begin(), in.end(), out.begin(), f);
+	}
+
+	// Folds [first, last) into init with op
+	// Each chunk is folded separately, then the chunks are folded left to right
+	template <class Iter, class T, class Op = std::plus<>>
+	T reduce(Iter first, Iter last, T init, Op op = Op()) {
+		size_t count = static_cast<size_t>(last - first);
+		if (count < SERIAL_THRESHOLD) {
+			for (; first != last; ++first) {
+				init = op(std::move(init), *first);
+			}
+			return init;
+		}
+
+		size_t chunk = chunkSize(count);
+		size_t chunks = (count + chunk - 1) / chunk;
+		std::vector<std::optional<T>> partials(chunks);
+
+		ThreadPool::shared().forRange(0, chunks, 1, [first, count, chunk, &partials, &op](size_t begin, size_t end) {
+			for (size_t c = begin; c < end; ++c) {
+				size_t i = c * chunk;
+				size_t last = std::min(i + chunk, count);
+
+				T partial(first[i]);
+				for (++i; i < last; ++i) {
+					partial = op(std::move(partial), first[i]);
+				}
+				partials[c].emplace(std::move(partial));
+			}
+		});
+
+		for (std::optional<T> &partial : partials) {
+			init = op(std::move(init), std::move(*partial));
+		}
+
+		return init;
+	}
+
+	// Folds a collection into init with op
+	template <class C, class T, class Op = std::plus<>>
+	T reduce(C const &c, T init, Op op = Op()) {
+		return parallel::reduce(c.begin(), c.end(), std::move(init), op);
+	}
+
+	// Writes the running fold of [first, last) with op to out, returning the end of the output
+	// Chunks are folded, their totals scanned serially, and then each chunk is
+	// scanned again starting from the total of those before it. out may be first
+	template <class Iter, class Out, class Op = std::plus<>>
+	Out inclusive_scan(Iter first, Iter last, Out out, Op op = Op()) {
+		using T = typename std::iterator_traits<Iter>::value_type;
+
+		size_t count = static_cast<size_t>(last - first);
+		if (count == 0) {
+			return out;
+		}
+
+		if (count < SERIAL_THRESHOLD) {
+			T running(*first);
+			*out = running;
+			for (++first, ++out; first != last; ++first, ++out) {
+				running = op(std::move(running), *first);
+				*out = running;
+			}
+			return out;
+		}
+
+		size_t chunk = chunkSize(count);
+		size_t chunks = (count + chunk - 1) / chunk;
+		std::vector<std::optional<T>> offsets(chunks);
+		ThreadPool &pool = ThreadPool::shared();
+
+		// Total each chunk but the last, whose total nothing needs
+		pool.forRange(0, chunks - 1, 1, [first, chunk, &offsets, &op](size_t begin, size_t end) {
+			for (size_t c = begin; c < end; ++c) {
+				size_t i = c * chunk;
+				size_t last = i + chunk;
+
+				T total(first[i]);
+				for (++i; i < last; ++i) {
+					total = op(std::move(total), first[i]);
+				}
+				offsets[c + 1].emplace(std::move(total));
+			}
+		});
+
+		// Each chunk's offset is the total of all chunks before it
+		for (size_t c = 2; c < chunks; ++c) {
+			offsets[c] = op(*offsets[c - 1], std::move(*offsets[c]));
+		}
+
+		pool.forRange(0, chunks, 1, [first, out, count, chunk, &offsets, &op](size_t begin, size_t end) {
+			for (size_t c = begin; c < end; ++c) {
+				size_t i = c * chunk;
+				size_t last = std::min(i + chunk, count);
+
+				T running = offsets[c] ? op(*offsets[c], first[i]) : T(first[i]);
+				out[i] = running;
+				for (++i; i < last; ++i) {
+					running = op(std::move(running), first[i]);
+					out[i] = running;
+				}
+			}
+		});
+
+		return out + count;
+	}
+
+	// Resizes out to match in, then writes the running fold of in with op to it
+	template <class C, class D, class Op = std::plus<>>
+	void inclusive_scan(C const &in, D &out, Op op = Op()) {
+		out.resize(in.size());
+		parallel::inclusive_scan(in.begin(), in.end(), out.begin(), op);
+	}
+
+	// Merges sorted [a, a + aCount) and [b, b + bCount) into out, moving the elements
+	// Merges larger than grain split around the middle element of the longer input
+	template <class Iter, class Out, class Compare>
+	void merge(Iter a, size_t aCount, Iter b, size_t bCount, Out out, size_t grain, Compare const &comp) {
+		if (aCount + bCount <= grain) {
+			std::merge(std::make_move_iterator(a), std::make_move_iterator(a + aCount),
+				std::make_move_iterator(b), std::make_move_iterator(b + bCount), out, comp);
+			return;
+		}
+
+		// Elements of a go before equal elements of b
+		size_t aSplit;
+		size_t bSplit;
+		if (aCount >= bCount) {
+			aSplit = aCount / 2;
+			bSplit = static_cast<size_t>(std::lower_bound(b, b + bCount, a[aSplit], comp) - b);
+		}
+		else {
+			bSplit = bCount / 2;
+			aSplit = static_cast<size_t>(std::upper_bound(a, a + aCount, b[bSplit], comp) - a);
+		}
+
+		ThreadPool::shared().invoke(
+			[&] { parallel::merge(a, aSplit, b, bSplit, out, grain, comp); },
+			[&] { parallel::merge(a + aSplit, aCount - aSplit, b + bSplit, bCount - bSplit, out + aSplit + bSplit, grain, comp); });
+	}
+
+	// Sorts the count elements at from, leaving them at to if toOther, or in place otherwise
+	// Pieces of up to grain elements are sorted serially. The two ranges swap
+	// roles at each level, so every merge moves the elements across
+	template <class Iter, class Other, class Compare>
+	void mergeSort(Iter from, Other to, size_t count, bool toOther, size_t grain, Compare const &comp) {
+		if (count <= grain) {
+			std::sort(from, from + count, comp);
+			if (toOther) {
+				std::move(from, from + count, to);
+			}
+			return;
+		}
+
+		// Sort the halves into whichever range the merge reads from
+		size_t half = count / 2;
+		ThreadPool::shared().invoke(
+			[&] { parallel::mergeSort(from, to, half, !toOther, grain, comp); },
+			[&] { parallel::mergeSort(from + half, to + half, count - half, !toOther, grain, comp); });
+
+		if (toOther) {
+			parallel::merge(from, half, from + half, count - half, to, grain, comp);
+		}
+		else {
+			parallel::merge(to, half, to + half, count - half, from, grain, comp);
+		}
+	}
+
+	// Sorts [first, last) by comp
+	// Pieces, 8 per thread, are sorted serially and merged in parallel through a
+	// buffer the size of the range
+	template <class Iter, class Compare = std::less<>>
+	void sort(Iter first, Iter last, Compare comp = Compare()) {
+		using T = typename std::iterator_traits<Iter>::value_type;
+
+		size_t count = static_cast<size_t>(last - first);
+		size_t threads = ThreadPool::shared().concurrency();
+		if (count < SERIAL_THRESHOLD || threads == 1) {
+			std::sort(first, last, comp);
+			return;
+		}
+
+		size_t grain = count / (threads * 8);
+		if (grain < SERIAL_THRESHOLD) {
+			grain = SERIAL_THRESHOLD;
+		}
+
+		// The elements move into the buffer and are sorted back out of it
+		std::vector<T> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+		parallel::mergeSort(buffer.begin(), first, count, true, grain, comp);
+	}
+
+	// Sorts a collection by comp
+	template <class C, class Compare = std::less<>>
+	void sort(C &c, Compare comp = Compare()) {
+		parallel::sort(c.begin(), c.end(), comp);
+	}
+}
+_MYLIB_END
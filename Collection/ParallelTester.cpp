@@ -0,0 +1,159 @@
+/* ParallelTester
+ * A program to test the parallel algorithms and ThreadPool against their std equivalents
+ * Prints 1 for each check that passes and 0 for each that fails. Link with the threads library */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <numeric> /* std::accumulate, std::partial_sum, std::iota */
+#include <algorithm> /* std::sort, std::transform */
+#include <functional> /* std::greater */
+#include <atomic> /* std::atomic */
+#include <random> /* std::mt19937 */
+#include <stdexcept> /* std::runtime_error */
+#include "Parallel.hpp"
+#include "SmallCollection.hpp"
+
+using namespace std;
+using namespace mylib;
+
+int failures = 0;
+
+// Prints whether a check passed
+void check(bool passed, string const &what) {
+	cout << passed << ' ' << what << endl;
+	failures += !passed;
+}
+
+int main(void) {
+	cout << "Threads: " << ThreadPool::shared().concurrency() << endl << endl;
+
+	mt19937 rng(7);
+
+	// Sizes either side of SERIAL_THRESHOLD, and one large enough to split many times
+	for (size_t n : { size_t(0), size_t(1), size_t(1000), size_t(1025), size_t(300000) }) {
+		string size = " (" + to_string(n) + " items)";
+
+		Collection<long long> c;
+		vector<long long> v;
+		for (size_t i = 0; i < n; ++i) {
+			long long value = static_cast<long long>(rng() % 2000) - 1000;
+			c.push(value);
+			v.push_back(value);
+		}
+
+		// for_each and transform
+		Collection<long long> doubled(c);
+		parallel::for_each(doubled, [](long long &x) { x *= 2; });
+		vector<long long> expected(v);
+		for (long long &x : expected) {
+			x *= 2;
+		}
+		check(equal(doubled.begin(), doubled.end(), expected.begin(), expected.end()), "for_each matches a loop" + size);
+
+		Collection<long long> squared;
+		parallel::transform(c, squared, [](long long x) { return x * x; });
+		transform(v.begin(), v.end(), expected.begin(), [](long long x) { return x * x; });
+		check(equal(squared.begin(), squared.end(), expected.begin(), expected.end()), "transform matches std::transform" + size);
+
+		// reduce and inclusive_scan
+		check(parallel::reduce(c, 5LL) == accumulate(v.begin(), v.end(), 5LL), "reduce matches std::accumulate" + size);
+
+		Collection<long long> scanned;
+		parallel::inclusive_scan(c, scanned);
+		partial_sum(v.begin(), v.end(), expected.begin());
+		check(equal(scanned.begin(), scanned.end(), expected.begin(), expected.end()), "inclusive_scan matches std::partial_sum" + size);
+
+		// Non-commutative op: chunks must be combined in order
+		vector<string> words(n);
+		for (size_t i = 0; i < n; ++i) {
+			words[i] = string(1, static_cast<char>('a' + i % 26));
+		}
+		check(parallel::reduce(words.begin(), words.end(), string()) == accumulate(words.begin(), words.end(), string()),
+			"reduce keeps the order of a non-commutative op" + size);
+
+		// sort, both orders
+		Collection<long long> sorted(c);
+		parallel::sort(sorted);
+		expected = v;
+		sort(expected.begin(), expected.end());
+		check(equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()), "sort matches std::sort" + size);
+
+		parallel::sort(sorted.begin(), sorted.end(), greater<>());
+		sort(expected.begin(), expected.end(), greater<>());
+		check(equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()), "sort with greater<> matches std::sort" + size);
+
+		cout << endl;
+	}
+
+	// Sorting items that own memory
+	vector<string> names(50000);
+	for (string &name : names) {
+		name = to_string(rng() % 100000);
+	}
+	vector<string> expectedNames(names);
+	parallel::sort(names);
+	sort(expectedNames.begin(), expectedNames.end());
+	check(names == expectedNames, "sort of strings matches std::sort");
+
+	// Collections other than Collection work too
+	SmallCollection<int, 8> small;
+	for (int i = 0; i < 5000; ++i) {
+		small.push(i);
+	}
+	check(parallel::reduce(small, 0LL) == 5000LL * 4999 / 2, "reduce over a SmallCollection");
+
+	// ThreadPool directly: every index visited exactly once
+	vector<atomic<int>> visits(100000);
+	ThreadPool::shared().forRange(0, visits.size(), 64, [&visits](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			++visits[i];
+		}
+	});
+	bool once = true;
+	for (atomic<int> &count : visits) {
+		once = once && count == 1;
+	}
+	check(once, "forRange visits every index once");
+
+	// A pool with more workers than cores still covers the range exactly
+	ThreadPool pool(4);
+	atomic<long long> total(0);
+	pool.forRange(0, 100000, 100, [&total](size_t first, size_t last) {
+		long long part = 0;
+		for (size_t i = first; i < last; ++i) {
+			part += i;
+		}
+		total += part;
+	});
+	check(total == 100000LL * 99999 / 2, "forRange on a 4 worker pool sums every index");
+
+	// Nested calls run on the same pool without deadlocking
+	atomic<long long> nestedTotal(0);
+	ThreadPool::shared().invoke(
+		[&] { nestedTotal += parallel::reduce(small, 0LL); },
+		[&] { nestedTotal += parallel::reduce(small, 0LL); });
+	check(nestedTotal == 2 * (5000LL * 4999 / 2), "invoke runs nested parallel calls");
+
+	// A callback's exception reaches the caller, once everything has stopped
+	try {
+		vector<int> items(20000);
+		iota(items.begin(), items.end(), 0);
+		parallel::for_each(items, [](int &x) {
+			if (x == 12345) {
+				throw runtime_error("callback failed");
+			}
+		});
+		check(false, "for_each rethrows a callback's exception");
+	}
+	catch (runtime_error &e) {
+		check(string(e.what()) == "callback failed", "for_each rethrows a callback's exception");
+	}
+
+	// The pool is still usable afterwards
+	check(parallel::reduce(small, 0LL) == 5000LL * 4999 / 2, "pool still works after an exception");
+
+	cout << endl << (failures ? "FAILED: " + to_string(failures) : string("All passed")) << endl;
+
+	return failures != 0;
+}
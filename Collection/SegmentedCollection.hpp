@@ -0,0 +1,731 @@
+#pragma once
+/* SegmentedCollection
+ * A double ended collection stored in fixed size blocks, whose items never move
+ *
+ * Items live in blocks of BlockSize, by default enough to fill 4 KiB, found
+ * through a map of block pointers. Growing at either end adds a block, or at
+ * worst grows the map, so no item is ever moved or copied by it and pointers
+ * and references to items stay valid until the item is removed. Indexing is
+ * one division and two loads.
+ *
+ * Iterators are random access, but hold on to the map, so like a deque's they
+ * are invalidated by anything that adds items. Blocks are freed as soon as
+ * the last item in them is removed. segment() gives each block's items as a
+ * Span for the simd:: and parallel:: kernels */
+
+#include <assert.h> /* assert() */
+#include <utility> /* std::move, std::forward, std::swap */
+#include <iterator> /* std::random_access_iterator_tag */
+#include <initializer_list> /* std::initializer_list */
+#include <cstddef> /* std::size_t, std::ptrdiff_t */
+#include <cstring> /* std::memcpy, std::memmove */
+#include <memory> /* std::allocator, std::allocator_traits */
+#include <type_traits> /* std::conditional_t, std::is_trivially_destructible */
+#include "Collection.hpp"
+#include "Span.hpp"
+
+_MYLIB_BEGIN
+template <class T, size_t BlockSize = (sizeof(T) < 256 ? 4096 / sizeof(T) : 16), class Alloc = std::allocator<T>>
+class SegmentedCollection {
+	static_assert(BlockSize > 0, "SegmentedCollection needs room for at least one item per block");
+
+	using AllocTraits = std::allocator_traits<Alloc>;
+	using MapAlloc = typename AllocTraits::template rebind_alloc<T *>;
+	using MapTraits = std::allocator_traits<MapAlloc>;
+
+	// Slots in the first map
+	static const size_t MIN_SLOTS = 8;
+
+	// Random access iterator over the items, Const for read only access
+	template <bool Const>
+	class Iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, T const *, T *>;
+		using reference = std::conditional_t<Const, T const &, T &>;
+
+		Iterator() : m_map(nullptr), m_pos(0) {};
+		Iterator(Iterator<false> const &it) : m_map(it.m_map), m_pos(it.m_pos) {}; // Converts to a read only iterator
+
+		reference operator*() const { return m_map[m_pos / BlockSize][m_pos % BlockSize]; }
+		pointer operator->() const { return &**this; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		Iterator &operator++() { ++m_pos; return *this; }
+		Iterator &operator--() { --m_pos; return *this; }
+		Iterator operator++(int) { Iterator it(*this); ++m_pos; return it; }
+		Iterator operator--(int) { Iterator it(*this); --m_pos; return it; }
+		Iterator &operator+=(difference_type n) { m_pos += n; return *this; }
+		Iterator &operator-=(difference_type n) { m_pos -= n; return *this; }
+
+		friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+		friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+		friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+		friend difference_type operator-(Iterator const &a, Iterator const &b) { return difference_type(a.m_pos - b.m_pos); }
+
+		friend bool operator==(Iterator const &a, Iterator const &b) { return a.m_pos == b.m_pos; }
+		friend bool operator!=(Iterator const &a, Iterator const &b) { return a.m_pos != b.m_pos; }
+		friend bool operator<(Iterator const &a, Iterator const &b) { return a.m_pos < b.m_pos; }
+		friend bool operator>(Iterator const &a, Iterator const &b) { return a.m_pos > b.m_pos; }
+		friend bool operator<=(Iterator const &a, Iterator const &b) { return a.m_pos <= b.m_pos; }
+		friend bool operator>=(Iterator const &a, Iterator const &b) { return a.m_pos >= b.m_pos; }
+
+	private:
+		friend class SegmentedCollection;
+		friend class Iterator<true>;
+		Iterator(T *const *map, size_t pos) : m_map(map), m_pos(pos) {};
+
+		T *const *m_map; // The collection's map when the iterator was made
+		size_t m_pos; // Position counted in items from the start of the map's first block
+	};
+
+public:
+	/* Types */
+	using value_type = T;
+	using allocator_type = Alloc;
+
+	static const size_t BLOCK_SIZE = BlockSize; // Items per block
+
+	/* Iterators */
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	iterator begin() { return iterator(m_map, m_first); } // Returns iterator to beginning
+	const_iterator begin() const { return const_iterator(m_map, m_first); } // Returns const iterator to beginning
+
+	iterator end() { return iterator(m_map, m_first + m_size); } // Returns iterator to end
+	const_iterator end() const { return const_iterator(m_map, m_first + m_size); } // Returns const iterator to end
+
+	/* Constuctors */
+	SegmentedCollection() : SegmentedCollection(Alloc()) {}; // Default constructor
+	explicit SegmentedCollection(Alloc const &alloc) : m_map(nullptr), m_slots(0), m_first(0), m_size(0), m_alloc(alloc) {}; // Allocator constructor
+	SegmentedCollection(SegmentedCollection const &toCopy); // Copy contructor
+	SegmentedCollection(SegmentedCollection const &toCopy, Alloc const &alloc); // Copy constructor using another allocator
+	SegmentedCollection(SegmentedCollection &&toMove) noexcept; // Move constructor
+	SegmentedCollection(T const *begin, T const *end, Alloc const &alloc = Alloc()); // Range constructor
+	SegmentedCollection(std::initializer_list<T> const &list, Alloc const &alloc = Alloc()); // Variadic parameter constructor
+
+	/* Deconstructor - destroys items and frees the blocks and map */
+	~SegmentedCollection();
+
+	/* Function members */
+	size_t size() const; // Returns collection size
+	bool empty() const; // Checks if collection is empty
+	Alloc get_allocator() const; // Returns a copy of the allocator
+
+	void resize(size_t count); // Adds default items or removes items from the end until there are count
+	void resize(size_t count, T const &t); // Adds copies of item or removes items from the end until there are count
+	void shrink_to_fit(); // Shrinks the map to the blocks in use
+
+	void push(T const &t); // Copies a new item onto the end of the collection
+	void push(T &&t); // Moves a new item onto the end of the collection
+	void push_front(T const &t); // Copies a new item onto the front of the collection
+	void push_front(T &&t); // Moves a new item onto the front of the collection
+	template<class... Args>
+	T &emplace_back(Args &&...args); // Constructs a new item in place at the end of the collection
+	template<class... Args>
+	T &emplace_front(Args &&...args); // Constructs a new item in place at the front of the collection
+	void pop_back(); // Removes the last item
+	void pop_front(); // Removes the first item
+	void clear(); // Clears the collection of all items
+	void swap(size_t idx1, size_t idx2); // Swaps two items in the collection
+	void swap(SegmentedCollection &c) noexcept; // Swap two SegmentedCollections
+
+	T &front(); // Returns the first item
+	T const &front() const; // Returns the first item, read only
+	T &back(); // Returns the last item
+	T const &back() const; // Returns the last item, read only
+
+	size_t segments() const; // Returns the count of blocks holding items
+	Span<T> segment(size_t idx); // Returns the items of the idx-th block in use
+	Span<T const> segment(size_t idx) const; // Returns the items of the idx-th block in use, read only
+
+	/* Operators */
+	T &operator[](size_t idx); // Overload [] for accessing index
+	T const &operator[](size_t idx) const; // Const overload for accessing index
+
+	SegmentedCollection &operator=(SegmentedCollection const &toCopy); // Copies values from another collection
+	SegmentedCollection &operator=(SegmentedCollection &&toMove) noexcept(
+		AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value); // Moves values from another collection
+	SegmentedCollection &operator=(std::initializer_list<T> const &list); // Variadic parameter assignment
+
+private:
+	/* Storage members */
+	T **m_map; // Block pointers, null for every slot not holding items
+	size_t m_slots; // Allocated size of the map
+	size_t m_first; // Position of the first item, counted in items from the start of slot 0
+	size_t m_size; // Count of items in collection
+	Alloc m_alloc; // Source of the blocks' and map's memory
+
+	/* Support functions */
+	size_t firstSlot() const; // Returns the slot of the first item
+	size_t usedSlots() const; // Returns the count of slots holding items
+	void makeRoom(bool front); // Recentres or grows the map so a block fits past the given end
+	void emptied(); // Recentres the first position once the last item is gone
+	void destroyAll(); // Destroys every item and frees every block
+	void release(); // Destroys every item and frees the blocks and map
+	void take(SegmentedCollection &other); // Takes other's map and blocks, leaving it empty
+
+	T *allocateBlock(); // Allocates raw storage for a block
+	void deallocateBlock(T *block); // Frees a block, which must hold no live items
+	T **allocateMap(size_t slots); // Allocates a map of null slots
+	void deallocateMap(T **map, size_t slots); // Frees a map
+};
+
+// ------
+// Public
+// ------
+
+// Copy constructor
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc>::SegmentedCollection(SegmentedCollection const &toCopy)
+	: SegmentedCollection(toCopy, AllocTraits::select_on_container_copy_construction(toCopy.m_alloc)) {}
+
+// Copy constructor using another allocator
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc>::SegmentedCollection(SegmentedCollection const &toCopy, Alloc const &alloc)
+	: SegmentedCollection(alloc) {
+	for (T const &item : toCopy) {
+		emplace_back(item);
+	}
+}
+
+// Move constructor
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc>::SegmentedCollection(SegmentedCollection &&toMove) noexcept
+	: SegmentedCollection(std::move(toMove.m_alloc)) {
+	take(toMove);
+}
+
+// Range/Iterator constructor
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc>::SegmentedCollection(T const *begin, T const *end, Alloc const &alloc)
+	: SegmentedCollection(alloc) {
+	assert(begin <= end);
+
+	for (; begin != end; ++begin) {
+		emplace_back(*begin);
+	}
+}
+
+// Variadic parameter constructor
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc>::SegmentedCollection(std::initializer_list<T> const &list, Alloc const &alloc)
+	: SegmentedCollection(list.begin(), list.end(), alloc) {}
+
+// Deconstructor, which destroys live items and frees memory
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc>::~SegmentedCollection() {
+	release();
+}
+
+// Returns current size of collection
+template<class T, size_t BlockSize, class Alloc>
+inline size_t SegmentedCollection<T, BlockSize, Alloc>::size() const {
+	return m_size;
+}
+
+// Checks if the collection is empty
+template<class T, size_t BlockSize, class Alloc>
+inline bool SegmentedCollection<T, BlockSize, Alloc>::empty() const {
+	return !m_size;
+}
+
+// Returns a copy of the allocator
+template<class T, size_t BlockSize, class Alloc>
+inline Alloc SegmentedCollection<T, BlockSize, Alloc>::get_allocator() const {
+	return m_alloc;
+}
+
+// Adds value initialised items or removes items from the end until there are count
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::resize(size_t count) {
+	while (m_size > count) {
+		pop_back();
+	}
+
+	while (m_size < count) {
+		emplace_back();
+	}
+}
+
+// Adds copies of item or removes items from the end until there are count
+// Items never move, so item may be one of this collection's
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::resize(size_t count, T const &item) {
+	while (m_size > count) {
+		pop_back();
+	}
+
+	while (m_size < count) {
+		emplace_back(item);
+	}
+}
+
+// Moves the block pointers into a map with no spare slots, freeing it when empty
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::shrink_to_fit() {
+	size_t used = usedSlots();
+	if (used == m_slots) {
+		return;
+	}
+
+	T **map = nullptr;
+	if (used) {
+		map = allocateMap(used);
+		std::memcpy(map, m_map + firstSlot(), used * sizeof(T *));
+	}
+
+	deallocateMap(m_map, m_slots);
+	m_first %= BlockSize;
+	m_map = map;
+	m_slots = used;
+}
+
+// Copies a new item onto the end of the collection
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::push(T const &newItem) {
+	emplace_back(newItem);
+}
+
+// Moves a new item onto the end of the collection
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::push(T &&newItem) {
+	emplace_back(std::move(newItem));
+}
+
+// Copies a new item onto the front of the collection
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::push_front(T const &newItem) {
+	emplace_front(newItem);
+}
+
+// Moves a new item onto the front of the collection
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::push_front(T &&newItem) {
+	emplace_front(std::move(newItem));
+}
+
+// Constructs a new item in place at the end of the collection
+// A block is allocated if the last one is full; no item moves
+template<class T, size_t BlockSize, class Alloc>
+template<class... Args>
+inline T &SegmentedCollection<T, BlockSize, Alloc>::emplace_back(Args &&...args) {
+	size_t pos = m_first + m_size;
+	if (pos / BlockSize >= m_slots) {
+		makeRoom(false);
+		pos = m_first + m_size;
+	}
+
+	T *&block = m_map[pos / BlockSize];
+	bool fresh = block == nullptr;
+	if (fresh) {
+		block = allocateBlock();
+	}
+
+	try {
+		AllocTraits::construct(m_alloc, block + pos % BlockSize, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		if (fresh) {
+			deallocateBlock(block);
+			block = nullptr;
+		}
+		throw;
+	}
+
+	++m_size;
+	return block[pos % BlockSize];
+}
+
+// Constructs a new item in place at the front of the collection
+// A block is allocated if the first one is full; no item moves
+template<class T, size_t BlockSize, class Alloc>
+template<class... Args>
+inline T &SegmentedCollection<T, BlockSize, Alloc>::emplace_front(Args &&...args) {
+	if (m_first == 0) {
+		makeRoom(true);
+	}
+
+	size_t pos = m_first - 1;
+	T *&block = m_map[pos / BlockSize];
+	bool fresh = block == nullptr;
+	if (fresh) {
+		block = allocateBlock();
+	}
+
+	try {
+		AllocTraits::construct(m_alloc, block + pos % BlockSize, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		if (fresh) {
+			deallocateBlock(block);
+			block = nullptr;
+		}
+		throw;
+	}
+
+	--m_first;
+	++m_size;
+	return block[pos % BlockSize];
+}
+
+// Removes the last item, freeing its block if nothing else is in it
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::pop_back() {
+	assert(m_size > 0);
+
+	size_t pos = m_first + m_size - 1;
+	T *&block = m_map[pos / BlockSize];
+	AllocTraits::destroy(m_alloc, block + pos % BlockSize);
+	--m_size;
+
+	if (m_size == 0 || pos % BlockSize == 0) {
+		deallocateBlock(block);
+		block = nullptr;
+	}
+
+	if (m_size == 0) {
+		emptied();
+	}
+}
+
+// Removes the first item, freeing its block if nothing else is in it
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::pop_front() {
+	assert(m_size > 0);
+
+	size_t pos = m_first;
+	T *&block = m_map[pos / BlockSize];
+	AllocTraits::destroy(m_alloc, block + pos % BlockSize);
+	++m_first;
+	--m_size;
+
+	if (m_size == 0 || m_first % BlockSize == 0) {
+		deallocateBlock(block);
+		block = nullptr;
+	}
+
+	if (m_size == 0) {
+		emptied();
+	}
+}
+
+// Clears the collection of all items, keeping the map
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::clear() {
+	destroyAll();
+	emptied();
+}
+
+// Swaps two items by index
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::swap(size_t idx1, size_t idx2) {
+	// Ensure indexes are valid
+	assert(idx1 < m_size && idx2 < m_size);
+
+	// Move instead of copying.
+	T temp(std::move((*this)[idx1]));
+	(*this)[idx1] = std::move((*this)[idx2]);
+	(*this)[idx2] = std::move(temp);
+}
+
+// Swaps two collections
+// The allocators swap too if they propagate on swap, otherwise they must be equal
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::swap(SegmentedCollection &c) noexcept {
+	using std::swap;
+
+	if constexpr (AllocTraits::propagate_on_container_swap::value) {
+		swap(m_alloc, c.m_alloc);
+	}
+	else {
+		assert(m_alloc == c.m_alloc);
+	}
+
+	swap(m_map, c.m_map);
+	swap(m_slots, c.m_slots);
+	swap(m_first, c.m_first);
+	swap(m_size, c.m_size);
+}
+
+// Returns the first item
+template<class T, size_t BlockSize, class Alloc>
+inline T &SegmentedCollection<T, BlockSize, Alloc>::front() {
+	return (*this)[0];
+}
+
+// Returns the first item, read only
+template<class T, size_t BlockSize, class Alloc>
+inline T const &SegmentedCollection<T, BlockSize, Alloc>::front() const {
+	return (*this)[0];
+}
+
+// Returns the last item
+template<class T, size_t BlockSize, class Alloc>
+inline T &SegmentedCollection<T, BlockSize, Alloc>::back() {
+	return (*this)[m_size - 1];
+}
+
+// Returns the last item, read only
+template<class T, size_t BlockSize, class Alloc>
+inline T const &SegmentedCollection<T, BlockSize, Alloc>::back() const {
+	return (*this)[m_size - 1];
+}
+
+// Returns the count of blocks holding items
+template<class T, size_t BlockSize, class Alloc>
+inline size_t SegmentedCollection<T, BlockSize, Alloc>::segments() const {
+	return usedSlots();
+}
+
+// Returns the items of the idx-th block in use
+// Only the first and last blocks can be partly filled
+template<class T, size_t BlockSize, class Alloc>
+inline Span<T> SegmentedCollection<T, BlockSize, Alloc>::segment(size_t idx) {
+	assert(idx < usedSlots());
+
+	size_t start = (firstSlot() + idx) * BlockSize;
+	size_t first = start < m_first ? m_first : start;
+	size_t last = start + BlockSize < m_first + m_size ? start + BlockSize : m_first + m_size;
+	return Span<T>(m_map[start / BlockSize] + (first - start), last - first);
+}
+
+// Returns the items of the idx-th block in use, read only
+template<class T, size_t BlockSize, class Alloc>
+inline Span<T const> SegmentedCollection<T, BlockSize, Alloc>::segment(size_t idx) const {
+	Span<T> items = const_cast<SegmentedCollection *>(this)->segment(idx);
+	return Span<T const>(items.data(), items.size());
+}
+
+// Bracket operator to access specified index
+template<class T, size_t BlockSize, class Alloc>
+inline T &SegmentedCollection<T, BlockSize, Alloc>::operator[](size_t idx) {
+	assert(idx < m_size);
+
+	size_t pos = m_first + idx;
+	return m_map[pos / BlockSize][pos % BlockSize];
+}
+
+// Const bracket operator to access specified index
+template<class T, size_t BlockSize, class Alloc>
+inline T const &SegmentedCollection<T, BlockSize, Alloc>::operator[](size_t idx) const {
+	assert(idx < m_size);
+
+	size_t pos = m_first + idx;
+	return m_map[pos / BlockSize][pos % BlockSize];
+}
+
+// Copies values from another collection
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc> &SegmentedCollection<T, BlockSize, Alloc>::operator=(SegmentedCollection const &toCopy) {
+	if (this == &toCopy) {
+		return *this;
+	}
+
+	if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+		// Memory from the old allocator must go back to it before it is replaced
+		if (m_alloc != toCopy.m_alloc) {
+			release();
+		}
+		m_alloc = toCopy.m_alloc;
+	}
+
+	clear();
+	for (T const &item : toCopy) {
+		emplace_back(item);
+	}
+
+	return *this;
+}
+
+// Move assignment
+// Takes toMove's map and blocks if the allocator propagates or the two are
+// equal, otherwise the items have to move one by one into this collection's memory
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc> &SegmentedCollection<T, BlockSize, Alloc>::operator=(SegmentedCollection &&toMove) noexcept(
+	AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+	if (this == &toMove) {
+		return *this;
+	}
+
+	if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+		release();
+		m_alloc = std::move(toMove.m_alloc);
+		take(toMove);
+	}
+	else {
+		if (m_alloc == toMove.m_alloc) {
+			release();
+			take(toMove);
+			return *this;
+		}
+
+		clear();
+		for (T &item : toMove) {
+			emplace_back(std::move(item));
+		}
+	}
+
+	return *this;
+}
+
+// Variadic params assignment
+template<class T, size_t BlockSize, class Alloc>
+inline SegmentedCollection<T, BlockSize, Alloc> &SegmentedCollection<T, BlockSize, Alloc>::operator=(std::initializer_list<T> const &list) {
+	clear();
+	for (T const &item : list) {
+		emplace_back(item);
+	}
+
+	return *this;
+}
+
+
+// -------
+// Private
+// -------
+
+// Returns the slot of the first item
+template<class T, size_t BlockSize, class Alloc>
+inline size_t SegmentedCollection<T, BlockSize, Alloc>::firstSlot() const {
+	return m_first / BlockSize;
+}
+
+// Returns the count of slots holding items
+template<class T, size_t BlockSize, class Alloc>
+inline size_t SegmentedCollection<T, BlockSize, Alloc>::usedSlots() const {
+	return m_size ? (m_first + m_size - 1) / BlockSize - firstSlot() + 1 : 0;
+}
+
+// Makes a free slot past the front or back block, moving only block pointers
+// The used slots are centred in the map with one more slot's room, in the same
+// map while it is at most half full and otherwise in one twice the size. Each
+// move leaves at least a quarter of the map free at both ends, so it happens
+// once per that many new blocks
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::makeRoom(bool front) {
+	size_t from = firstSlot();
+	size_t used = usedSlots();
+	size_t needed = used + 1;
+
+	T **map = m_map;
+	size_t slots = m_slots;
+	if (needed * 2 > slots) {
+		slots = slots * 2 < MIN_SLOTS ? MIN_SLOTS : slots * 2;
+		map = allocateMap(slots);
+	}
+
+	size_t to = (slots - needed) / 2 + (front ? 1 : 0);
+	if (used) {
+		std::memmove(map + to, m_map + from, used * sizeof(T *));
+	}
+
+	if (map == m_map) {
+		// Clear the slots the pointers moved out of
+		for (size_t i = from; i < from + used; ++i) {
+			if (i < to || i >= to + used) {
+				map[i] = nullptr;
+			}
+		}
+	}
+	else {
+		deallocateMap(m_map, m_slots);
+		m_map = map;
+		m_slots = slots;
+	}
+
+	m_first = to * BlockSize + m_first % BlockSize;
+}
+
+// Recentres the first position once the last item is gone,
+// leaving room to grow either way in the map there is
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::emptied() {
+	m_first = m_slots / 2 * BlockSize;
+}
+
+// Destroys every item and frees every block, block by block
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::destroyAll() {
+	size_t from = firstSlot();
+	size_t used = usedSlots();
+
+	if constexpr (!std::is_trivially_destructible<T>::value) {
+		for (size_t i = 0; i < used; ++i) {
+			for (T &item : segment(i)) {
+				AllocTraits::destroy(m_alloc, &item);
+			}
+		}
+	}
+
+	for (size_t i = from; i < from + used; ++i) {
+		deallocateBlock(m_map[i]);
+		m_map[i] = nullptr;
+	}
+
+	m_size = 0;
+}
+
+// Destroys every item and frees the blocks and map, leaving the collection unallocated
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::release() {
+	destroyAll();
+	deallocateMap(m_map, m_slots);
+	m_map = nullptr;
+	m_slots = 0;
+	m_first = 0;
+}
+
+// Takes other's map and blocks, leaving it empty
+// They must have come from an allocator equal to this one's
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::take(SegmentedCollection &other) {
+	m_map = other.m_map;
+	m_slots = other.m_slots;
+	m_first = other.m_first;
+	m_size = other.m_size;
+
+	other.m_map = nullptr;
+	other.m_slots = 0;
+	other.m_first = 0;
+	other.m_size = 0;
+}
+
+// Allocates raw storage for a block, constructing no items
+template<class T, size_t BlockSize, class Alloc>
+inline T *SegmentedCollection<T, BlockSize, Alloc>::allocateBlock() {
+	return AllocTraits::allocate(m_alloc, BlockSize);
+}
+
+// Frees a block, which must hold no live items
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::deallocateBlock(T *block) {
+	if (block != nullptr) {
+		AllocTraits::deallocate(m_alloc, block, BlockSize);
+	}
+}
+
+// Allocates a map with every slot null
+template<class T, size_t BlockSize, class Alloc>
+inline T **SegmentedCollection<T, BlockSize, Alloc>::allocateMap(size_t slots) {
+	MapAlloc alloc(m_alloc);
+	T **map = MapTraits::allocate(alloc, slots);
+	for (size_t i = 0; i < slots; ++i) {
+		map[i] = nullptr;
+	}
+
+	return map;
+}
+
+// Frees a map
+template<class T, size_t BlockSize, class Alloc>
+inline void SegmentedCollection<T, BlockSize, Alloc>::deallocateMap(T **map, size_t slots) {
+	if (map != nullptr) {
+		MapAlloc alloc(m_alloc);
+		MapTraits::deallocate(alloc, map, slots);
+	}
+}
+_MYLIB_END
@@ -0,0 +1,164 @@
+/* SegmentedCollectionTester
+ * A program to test SegmentedCollection against std::deque
+ * Prints 1 for each check that passes and 0 for each that fails */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm> /* std::equal, std::sort, std::reverse */
+#include <random> /* std::mt19937 */
+#include "SegmentedCollection.hpp"
+
+using namespace std;
+using namespace mylib;
+
+int failures = 0;
+
+// Prints whether a check passed
+void check(bool passed, string const &what) {
+	cout << passed << ' ' << what << endl;
+	failures += !passed;
+}
+
+// Checks a collection against a deque by index, by iteration and by segment
+template <class C, class T>
+bool same(C const &c, deque<T> const &d) {
+	if (c.size() != d.size() || c.empty() != d.empty() || !equal(c.begin(), c.end(), d.begin(), d.end())) {
+		return false;
+	}
+	for (size_t i = 0; i < d.size(); ++i) {
+		if (c[i] != d[i]) {
+			return false;
+		}
+	}
+
+	// Segments cover the items in order, each within one block
+	size_t pos = 0;
+	for (size_t s = 0; s < c.segments(); ++s) {
+		Span<T const> segment = c.segment(s);
+		if (segment.empty() || segment.size() > C::BLOCK_SIZE || !equal(segment.begin(), segment.end(), d.begin() + pos)) {
+			return false;
+		}
+		pos += segment.size();
+	}
+	return pos == d.size() && (d.empty() || (c.front() == d.front() && c.back() == d.back()));
+}
+
+int main(void) {
+	mt19937 rng(3);
+
+	// Small blocks, so every few operations cross into a new one
+	SegmentedCollection<string, 7> c;
+	deque<string> d;
+	bool matched = true;
+	for (int step = 0; step < 20000; ++step) {
+		string value = to_string(rng() % 100000);
+		switch (d.empty() ? rng() % 2 : rng() % 6) {
+		case 0:
+			c.push(value);
+			d.push_back(value);
+			break;
+		case 1:
+			c.push_front(value);
+			d.push_front(value);
+			break;
+		case 2:
+			c.emplace_back(3, 'x');
+			d.emplace_back(3, 'x');
+			break;
+		case 3:
+			c.emplace_front(value);
+			d.emplace_front(value);
+			break;
+		case 4:
+			c.pop_back();
+			d.pop_back();
+			break;
+		case 5:
+			c.pop_front();
+			d.pop_front();
+			break;
+		}
+		if (step % 997 == 0) {
+			matched = matched && same(c, d);
+		}
+	}
+	check(matched && same(c, d), "pushes and pops at both ends match std::deque (" + to_string(d.size()) + " items)");
+
+	// Emptying through either end and refilling
+	while (!d.empty()) {
+		c.pop_front();
+		d.pop_front();
+	}
+	check(same(c, d) && c.segments() == 0, "emptied from the front frees every block");
+	for (int i = 0; i < 50; ++i) {
+		c.push_front(to_string(i));
+		d.push_front(to_string(i));
+	}
+	check(same(c, d), "refilled from the front");
+
+	// Addresses stay put while either end grows
+	SegmentedCollection<int, 16> numbers;
+	vector<int *> addresses;
+	for (int i = 0; i < 1000; ++i) {
+		addresses.push_back(&numbers.emplace_back(i));
+	}
+	for (int i = 1; i <= 5000; ++i) {
+		numbers.push_front(-i);
+		numbers.push(1000 + i);
+	}
+	bool stable = true;
+	for (int i = 0; i < 1000; ++i) {
+		stable = stable && *addresses[i] == i && &numbers[5000 + i] == addresses[i];
+	}
+	check(stable, "items keep their address while both ends grow");
+
+	// Random access iterators work with std algorithms
+	deque<int> numbersDeque(numbers.begin(), numbers.end());
+	check(numbers.end() - numbers.begin() == static_cast<ptrdiff_t>(numbers.size()) && numbers.begin()[5000] == 0
+		&& *(numbers.end() - 1) == 6000, "iterator arithmetic");
+	reverse(numbers.begin(), numbers.end());
+	reverse(numbersDeque.begin(), numbersDeque.end());
+	check(same(numbers, numbersDeque), "std::reverse matches std::deque");
+	for (int &x : numbers) {
+		x = static_cast<int>(rng() % 1000);
+	}
+	numbersDeque.assign(numbers.begin(), numbers.end());
+	sort(numbers.begin(), numbers.end());
+	sort(numbersDeque.begin(), numbersDeque.end());
+	check(same(numbers, numbersDeque), "std::sort matches std::deque");
+
+	// Index swap and resize
+	c.swap(0, 49);
+	swap(d[0], d[49]);
+	c.resize(100, "fill");
+	d.resize(100, "fill");
+	check(same(c, d), "swap of two items and resize with a value");
+	c.resize(30);
+	d.resize(30);
+	check(same(c, d), "resize down");
+
+	// Copy, move, swap and assignment
+	SegmentedCollection<string, 7> copy(c);
+	check(same(copy, d), "copy constructor");
+	SegmentedCollection<string, 7> moved(move(copy));
+	check(same(moved, d) && copy.empty(), "move constructor");
+	SegmentedCollection<string, 7> other = { "a", "b", "c" };
+	deque<string> otherDeque = { "a", "b", "c" };
+	other.swap(moved);
+	check(same(other, d) && same(moved, otherDeque), "swap of whole collections");
+	moved = other;
+	check(same(moved, d), "copy assignment");
+	other = { "x" };
+	check(other.size() == 1 && other.front() == "x", "initializer list assignment");
+	moved = move(other);
+	check(moved.size() == 1 && moved.back() == "x", "move assignment");
+
+	c.clear();
+	check(c.empty() && c.segments() == 0 && c.begin() == c.end(), "clear");
+
+	cout << endl << (failures ? "FAILED: " + to_string(failures) : string("All passed")) << endl;
+
+	return failures != 0;
+}
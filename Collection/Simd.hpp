@@ -0,0 +1,398 @@
+#pragma once
+/* Simd
+ * Vectorised find, count, contains, min_element, max_element and sum over
+ * contiguous ranges of arithmetic values, such as a Collection<int>
+ *
+ * Each kernel is written once over GCC vector types and compiled twice: with
+ * 32 byte vectors for AVX2, and with 16 byte ones for the baseline target,
+ * which on x86-64 is SSE2. The AVX2 build is picked at run time when the
+ * processor has it. Without GCC
+ * vector extensions (or for bool and long double) the std algorithms are used.
+ *
+ * Results match the std algorithms, except that float and double sums are
+ * added in a different order, so they may round differently. min_element and
+ * max_element return the first of equal elements and, like std, skip NaNs
+ * unless the first element is one */
+
+#include <cstddef> /* std::size_t */
+#include <cstdint> /* SIZE_MAX */
+#include <cstring> /* std::memcpy */
+#include <algorithm> /* std::find, std::count, std::min_element, std::max_element */
+#include <limits> /* std::numeric_limits */
+#include <type_traits> /* std::is_integral, std::is_floating_point, std::is_signed */
+#include "Collection.hpp"
+
+// The kernels pass 32 byte vectors around only inside functions built for AVX2
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#if defined(__GNUC__)
+#define MYLIB_SIMD 1
+#define MYLIB_SIMD_INLINE __attribute__((always_inline)) inline
+#if defined(__x86_64__) || defined(__i386__)
+#define MYLIB_SIMD_AVX2 1
+#endif
+#endif
+
+_MYLIB_BEGIN
+namespace simd {
+	// Whether T has vectorised kernels: integers other than bool, float and double
+	template <class T>
+	struct supported : std::integral_constant<bool,
+		(std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8) ||
+		std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+	// Type sum returns for T: the 64 bit integer of the same signedness, or T itself for floating point
+	template <class T>
+	using SumType = typename std::conditional<std::is_floating_point<T>::value, T,
+		typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type;
+
+	// Keeps a parameter out of template argument deduction, so find(p, q, 0) works for any T
+	template <class T>
+	struct identity {
+		using type = T;
+	};
+
+#if MYLIB_SIMD
+	// Vector of T filling BYTES
+	template <size_t BYTES, class T>
+	struct Vector {
+		static const size_t LANES = BYTES / sizeof(T);
+		typedef T type __attribute__((vector_size(BYTES)));
+	};
+
+	// Vector of LANES items of T, narrower than a full vector when widening sums
+	template <class T, size_t LANES>
+	struct Narrow {
+		typedef T type __attribute__((vector_size(LANES * sizeof(T))));
+	};
+
+	// Lane type sums of T are gathered in before they are added into a SumType
+	template <class T>
+	using SumLane = typename std::conditional<std::is_floating_point<T>::value, T,
+		typename std::conditional<(sizeof(T) < 4),
+			typename std::conditional<std::is_signed<T>::value, int, unsigned>::type,
+			SumType<T>>::type>::type;
+
+	// Loads a vector from a possibly unaligned address
+	template <size_t BYTES, class T>
+	MYLIB_SIMD_INLINE typename Vector<BYTES, T>::type load(T const *p) {
+		typename Vector<BYTES, T>::type v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	// Checks if any lane of a comparison result is set
+	template <class M>
+	MYLIB_SIMD_INLINE bool any(M const &mask) {
+		typedef typename Vector<sizeof(M), unsigned long long>::type Quads;
+		Quads quads = (Quads)mask;
+
+		unsigned long long bits = 0;
+		for (size_t i = 0; i < sizeof(M) / 8; ++i) {
+			bits |= quads[i];
+		}
+		return bits != 0;
+	}
+
+	/* Kernel bodies, inlined into each target's build */
+
+	template <size_t BYTES, class T>
+	MYLIB_SIMD_INLINE T const *findBody(T const *first, T const *last, T value) {
+		using V = typename Vector<BYTES, T>::type;
+		const size_t LANES = Vector<BYTES, T>::LANES;
+
+		V needle = V{} + value;
+		for (; static_cast<size_t>(last - first) >= 2 * LANES; first += 2 * LANES) {
+			if (any((load<BYTES>(first) == needle) | (load<BYTES>(first + LANES) == needle))) {
+				break;
+			}
+		}
+
+		for (; first != last && !(*first == value); ++first) {}
+		return first;
+	}
+
+	template <size_t BYTES, class T>
+	MYLIB_SIMD_INLINE size_t countBody(T const *first, T const *last, T value) {
+		using V = typename Vector<BYTES, T>::type;
+		using M = decltype(V{} == V{});
+		const size_t LANES = Vector<BYTES, T>::LANES;
+
+		// Lanes count down by 1 per match, and are emptied before they can overflow
+		const size_t FLUSH = sizeof(T) == 1 ? 127 : sizeof(T) == 2 ? 32767 : SIZE_MAX;
+
+		V needle = V{} + value;
+		M lanes = {};
+		size_t blocks = 0;
+		size_t total = 0;
+
+		for (; static_cast<size_t>(last - first) >= LANES; first += LANES) {
+			lanes += load<BYTES>(first) == needle;
+			if (++blocks == FLUSH) {
+				for (size_t i = 0; i < LANES; ++i) {
+					total -= lanes[i];
+				}
+				lanes = M{};
+				blocks = 0;
+			}
+		}
+
+		for (size_t i = 0; i < LANES; ++i) {
+			total -= lanes[i];
+		}
+
+		for (; first != last; ++first) {
+			total += *first == value;
+		}
+
+		return total;
+	}
+
+	// Returns the first smallest (or with Max, largest) element
+	// Lanes keep their own extreme, then the extreme of the lanes is searched for.
+	// Floating point lanes start from infinity so that NaNs are skipped
+	template <size_t BYTES, bool Max, class T>
+	MYLIB_SIMD_INLINE T const *extremeBody(T const *first, T const *last) {
+		using V = typename Vector<BYTES, T>::type;
+		const size_t LANES = Vector<BYTES, T>::LANES;
+
+		if (first == last) {
+			return last;
+		}
+
+		T start = *first;
+		if constexpr (std::is_floating_point<T>::value) {
+			if (start != start) {
+				return first;
+			}
+			start = Max ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+		}
+
+		V extremes = V{} + start;
+		T const *p = first;
+		for (; static_cast<size_t>(last - p) >= LANES; p += LANES) {
+			V v = load<BYTES>(p);
+			extremes = (Max ? v > extremes : v < extremes) ? v : extremes;
+		}
+
+		T extreme = extremes[0];
+		for (size_t i = 1; i < LANES; ++i) {
+			if (Max ? extremes[i] > extreme : extremes[i] < extreme) {
+				extreme = extremes[i];
+			}
+		}
+
+		for (; p != last; ++p) {
+			if (Max ? *p > extreme : *p < extreme) {
+				extreme = *p;
+			}
+		}
+
+		return findBody<BYTES>(first, last, extreme);
+	}
+
+	// Elements are widened as they load to fill a vector of SumLane,
+	// and added into two of them in turn
+	template <size_t BYTES, class T>
+	MYLIB_SIMD_INLINE SumType<T> sumBody(T const *first, T const *last) {
+		using W = typename Vector<BYTES, SumLane<T>>::type;
+		const size_t LANES = Vector<BYTES, SumLane<T>>::LANES;
+		using N = typename Narrow<T, LANES>::type;
+
+		// Lanes narrower than the result are emptied before they can overflow, others wrap like it
+		const size_t FLUSH = sizeof(T) < 4 ? 1 << (30 - 8 * sizeof(T)) : SIZE_MAX;
+
+		W even = {};
+		W odd = {};
+		size_t blocks = 0;
+		SumType<T> total = 0;
+
+		for (; static_cast<size_t>(last - first) >= 2 * LANES; first += 2 * LANES) {
+			N narrow[2];
+			std::memcpy(narrow, first, sizeof(narrow));
+			even += __builtin_convertvector(narrow[0], W);
+			odd += __builtin_convertvector(narrow[1], W);
+
+			if (++blocks == FLUSH) {
+				for (size_t i = 0; i < LANES; ++i) {
+					total += even[i] + static_cast<SumType<T>>(odd[i]);
+				}
+				even = odd = W{};
+				blocks = 0;
+			}
+		}
+
+		for (size_t i = 0; i < LANES; ++i) {
+			total += even[i] + static_cast<SumType<T>>(odd[i]);
+		}
+
+		for (; first != last; ++first) {
+			total += *first;
+		}
+
+		return total;
+	}
+
+#if MYLIB_SIMD_AVX2
+	/* AVX2 builds of the kernels */
+
+	template <class T>
+	__attribute__((target("avx2"))) T const *findAvx2(T const *first, T const *last, T value) {
+		return findBody<32>(first, last, value);
+	}
+
+	template <class T>
+	__attribute__((target("avx2"))) size_t countAvx2(T const *first, T const *last, T value) {
+		return countBody<32>(first, last, value);
+	}
+
+	template <bool Max, class T>
+	__attribute__((target("avx2"))) T const *extremeAvx2(T const *first, T const *last) {
+		return extremeBody<32, Max>(first, last);
+	}
+
+	template <class T>
+	__attribute__((target("avx2"))) SumType<T> sumAvx2(T const *first, T const *last) {
+		return sumBody<32>(first, last);
+	}
+
+	// Checks once whether the processor has AVX2
+	inline bool hasAvx2() {
+		static const bool avx2 = __builtin_cpu_supports("avx2");
+		return avx2;
+	}
+#endif
+#endif
+
+	/* Range kernels */
+
+	// Returns the first element equal to value, or last if there is none
+	template <class T>
+	T const *find(T const *first, T const *last, typename identity<T>::type value) {
+#if MYLIB_SIMD
+		if constexpr (supported<T>::value) {
+#if MYLIB_SIMD_AVX2
+			if (hasAvx2()) {
+				return findAvx2(first, last, value);
+			}
+#endif
+			return findBody<16>(first, last, value);
+		}
+#endif
+		return std::find(first, last, value);
+	}
+
+	// Returns the number of elements equal to value
+	template <class T>
+	size_t count(T const *first, T const *last, typename identity<T>::type value) {
+#if MYLIB_SIMD
+		if constexpr (supported<T>::value) {
+#if MYLIB_SIMD_AVX2
+			if (hasAvx2()) {
+				return countAvx2(first, last, value);
+			}
+#endif
+			return countBody<16>(first, last, value);
+		}
+#endif
+		return static_cast<size_t>(std::count(first, last, value));
+	}
+
+	// Checks if any element equals value
+	template <class T>
+	bool contains(T const *first, T const *last, typename identity<T>::type value) {
+		return simd::find(first, last, value) != last;
+	}
+
+	// Returns the first smallest element, or last if the range is empty
+	template <class T>
+	T const *min_element(T const *first, T const *last) {
+#if MYLIB_SIMD
+		if constexpr (supported<T>::value) {
+#if MYLIB_SIMD_AVX2
+			if (hasAvx2()) {
+				return extremeAvx2<false>(first, last);
+			}
+#endif
+			return extremeBody<16, false>(first, last);
+		}
+#endif
+		return std::min_element(first, last);
+	}
+
+	// Returns the first largest element, or last if the range is empty
+	template <class T>
+	T const *max_element(T const *first, T const *last) {
+#if MYLIB_SIMD
+		if constexpr (supported<T>::value) {
+#if MYLIB_SIMD_AVX2
+			if (hasAvx2()) {
+				return extremeAvx2<true>(first, last);
+			}
+#endif
+			return extremeBody<16, true>(first, last);
+		}
+#endif
+		return std::max_element(first, last);
+	}
+
+	// Returns the sum of the elements, integers being added in 64 bits
+	template <class T>
+	SumType<T> sum(T const *first, T const *last) {
+#if MYLIB_SIMD
+		if constexpr (supported<T>::value) {
+#if MYLIB_SIMD_AVX2
+			if (hasAvx2()) {
+				return sumAvx2(first, last);
+			}
+#endif
+			return sumBody<16>(first, last);
+		}
+#endif
+		SumType<T> total = 0;
+		for (; first != last; ++first) {
+			total += *first;
+		}
+		return total;
+	}
+
+	/* Collection kernels, taking anything with contiguous begin() and end() */
+
+	template <class C>
+	auto find(C const &c, typename C::value_type value) {
+		return simd::find(c.begin(), c.end(), value);
+	}
+
+	template <class C>
+	size_t count(C const &c, typename C::value_type value) {
+		return simd::count(c.begin(), c.end(), value);
+	}
+
+	template <class C>
+	bool contains(C const &c, typename C::value_type value) {
+		return simd::contains(c.begin(), c.end(), value);
+	}
+
+	template <class C>
+	auto min_element(C const &c) {
+		return simd::min_element(c.begin(), c.end());
+	}
+
+	template <class C>
+	auto max_element(C const &c) {
+		return simd::max_element(c.begin(), c.end());
+	}
+
+	template <class C>
+	auto sum(C const &c) {
+		return simd::sum(c.begin(), c.end());
+	}
+}
+_MYLIB_END
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
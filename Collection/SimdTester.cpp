@@ -0,0 +1,116 @@
+/* SimdTester
+ * A program to test the vectorised algorithms against their std equivalents
+ * Prints 1 for each check that passes and 0 for each that fails */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint> /* std::int8_t, std::uint8_t, std::int16_t, std::uint64_t */
+#include <cmath> /* NAN */
+#include <numeric> /* std::accumulate */
+#include <algorithm> /* std::find, std::count, std::min_element, std::max_element */
+#include <random> /* std::mt19937 */
+#include "Simd.hpp"
+
+using namespace std;
+using namespace mylib;
+
+int failures = 0;
+
+// Prints whether a check passed
+void check(bool passed, string const &what) {
+	cout << passed << ' ' << what << endl;
+	failures += !passed;
+}
+
+// Compares every kernel with std over every subrange starting at offsets 0 to 7, so unaligned heads and tails are covered
+template <class T>
+void testType(string const &name, int low, int high) {
+	mt19937 rng(11);
+	Collection<T> c;
+	for (int i = 0; i < 1100; ++i) {
+		c.push(static_cast<T>(low + static_cast<int>(rng() % (high - low + 1))));
+	}
+
+	bool found = true, counted = true, contained = true, minimum = true, maximum = true, summed = true;
+	for (size_t offset = 0; offset < 8; ++offset) {
+		for (size_t length : { size_t(0), size_t(1), size_t(3), size_t(15), size_t(16), size_t(17), size_t(31), size_t(33), size_t(100), size_t(1000) }) {
+			T const *first = c.begin() + offset;
+			T const *last = first + length;
+			T value = c[offset + length / 2];
+			T absent = static_cast<T>(high + 1);
+
+			found = found && simd::find(first, last, value) == find(first, last, value)
+				&& simd::find(first, last, absent) == last;
+			counted = counted && simd::count(first, last, value) == static_cast<size_t>(count(first, last, value));
+			contained = contained && simd::contains(first, last, value) == (find(first, last, value) != last);
+			minimum = minimum && simd::min_element(first, last) == min_element(first, last);
+			maximum = maximum && simd::max_element(first, last) == max_element(first, last);
+			summed = summed && simd::sum(first, last) == accumulate(first, last, simd::SumType<T>(0));
+		}
+	}
+
+	check(found, "find matches std::find for " + name);
+	check(counted, "count matches std::count for " + name);
+	check(contained, "contains matches std::find for " + name);
+	check(minimum, "min_element matches std::min_element for " + name);
+	check(maximum, "max_element matches std::max_element for " + name);
+	check(summed, "sum matches std::accumulate for " + name);
+
+	// The collection overloads forward to the pointer ones
+	check(simd::sum(c) == accumulate(c.begin(), c.end(), simd::SumType<T>(0)), "sum of a whole Collection<" + name + ">");
+	cout << endl;
+}
+
+int main(void) {
+	cout << "AVX2: " << simd::hasAvx2() << endl << endl;
+
+	// Value ranges are small enough for float sums to be exact, and leave room for an absent value
+	testType<int8_t>("int8_t", -100, 100);
+	testType<uint8_t>("uint8_t", 0, 250);
+	testType<int16_t>("int16_t", -30000, 30000);
+	testType<int>("int", -1000000, 1000000);
+	testType<unsigned>("unsigned", 0, 2000000000);
+	testType<long long>("long long", -1000000000, 1000000000);
+	testType<uint64_t>("uint64_t", 0, 1000000000);
+	testType<float>("float", -1000, 1000);
+	testType<double>("double", -1000000, 1000000);
+
+	// Narrow sums widen instead of wrapping
+	vector<uint8_t> bytes(100000, 255);
+	check(simd::sum(bytes.data(), bytes.data() + bytes.size()) == 255ULL * 100000, "sum of uint8_t does not overflow");
+	vector<int8_t> negatives(100000, -128);
+	check(simd::sum(negatives.data(), negatives.data() + negatives.size()) == -128LL * 100000, "sum of int8_t does not overflow");
+
+	// Equal extremes: the first one is returned, as std does
+	vector<int> ties(100, 5);
+	ties[40] = ties[70] = 1;
+	ties[50] = ties[90] = 9;
+	check(simd::min_element(ties.data(), ties.data() + ties.size()) == ties.data() + 40, "min_element returns the first of equal minimums");
+	check(simd::max_element(ties.data(), ties.data() + ties.size()) == ties.data() + 50, "max_element returns the first of equal maximums");
+
+	// NaNs are skipped unless first, and never compare equal
+	vector<double> withNan(50);
+	for (size_t i = 0; i < withNan.size(); ++i) {
+		withNan[i] = static_cast<double>(i % 7) - 3;
+	}
+	withNan[20] = NAN;
+	double const *first = withNan.data(), *last = first + withNan.size();
+	check(simd::min_element(first, last) == min_element(first, last), "min_element skips a NaN in the middle");
+	check(simd::max_element(first, last) == max_element(first, last), "max_element skips a NaN in the middle");
+	check(simd::find(first, last, NAN) == last && simd::count(first, last, NAN) == 0, "NaN is never found");
+	withNan[0] = NAN;
+	check(simd::min_element(first, last) == first && min_element(first, last) == first, "min_element returns a leading NaN");
+	check(simd::max_element(first, last) == first && max_element(first, last) == first, "max_element returns a leading NaN");
+
+	// Empty ranges
+	Collection<float> empty;
+	check(simd::find(empty, 1.0f) == empty.end() && simd::count(empty, 1.0f) == 0 && !simd::contains(empty, 1.0f),
+		"find, count and contains on an empty collection");
+	check(simd::min_element(empty) == empty.end() && simd::max_element(empty) == empty.end() && simd::sum(empty) == 0,
+		"min_element, max_element and sum on an empty collection");
+
+	cout << endl << (failures ? "FAILED: " + to_string(failures) : string("All passed")) << endl;
+
+	return failures != 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+/* SmallCollection
+ * A Collection that keeps up to N items inside the object itself
+ *
+ * Only once an item beyond the Nth is added does the array move to memory
+ * from Alloc, after which it behaves exactly like a Collection. Clearing
+ * keeps the heap array; it is only given up when the collection is assigned
+ * or swapped another's items, or shrunk back to N items or fewer.
+ *
+ * It is a Collection with InlineStorage, so the interface is Collection's
+ * plus isInline(). The one difference is in invalidation: moving or swapping
+ * a SmallCollection whose items are inline moves the items themselves, so
+ * iterators into it don't carry over to the new owner */
+
+#include <cstddef> /* std::size_t */
+#include <memory> /* std::allocator */
+#include "Collection.hpp"
+
+_MYLIB_BEGIN
+// Storage policy with room for the first N items inside the object
+template <class T, size_t N>
+class InlineStorage {
+	static_assert(N > 0, "SmallCollection needs room for at least one inline item");
+
+public:
+	bool isInline() const { return m_pData == inlineData(); } // Checks if the items are still stored in the object
+
+protected:
+	static const size_t INLINE_CAPACITY = N; // Count of items that fit without allocating
+
+	InlineStorage() : m_pData(inlineData()) {};
+	InlineStorage(InlineStorage const &) = delete; // The pointer must keep pointing at this object's own buffer
+	InlineStorage &operator=(InlineStorage const &) = delete;
+
+	T *inlineData() { return reinterpret_cast<T *>(m_inline); } // Returns the inline buffer
+	T const *inlineData() const { return reinterpret_cast<T const *>(m_inline); }
+
+	T *m_pData; // Array of items, either the inline buffer or from the allocator
+
+private:
+	alignas(T) unsigned char m_inline[N * sizeof(T)]; // Raw storage for the first N items
+};
+
+template <class T, size_t N, class Alloc = std::allocator<T>, class Growth = DoubleGrowth>
+using SmallCollection = Collection<T, Alloc, Growth, InlineStorage<T, N>>;
+_MYLIB_END
@@ -0,0 +1,356 @@
+#pragma once
+/* SoACollection
+ * A collection of rows of Fields stored as a structure of arrays
+ *
+ * Each field has its own Collection, so a loop over one field reads only that
+ * field's memory, and column<I>() hands it to simd:: or parallel:: kernels as
+ * a Span. Rows are added, removed and moved in every column together, and a
+ * change that throws part way is undone in the columns it already reached.
+ *
+ * operator[] returns a Row, a proxy for the fields at one index, which can be
+ * read with get<I>(), tied into a tuple of references, copied out as a tuple,
+ * or assigned from one. Like a pointer, a Row is invalidated by anything that
+ * adds or removes rows before its index */
+
+#include <assert.h> /* assert() */
+#include <utility> /* std::forward, std::index_sequence, std::index_sequence_for */
+#include <tuple> /* std::tuple, std::tuple_element_t, std::tie, std::get, std::apply */
+#include <cstddef> /* std::size_t */
+#include <cstdint> /* SIZE_MAX */
+#include "Collection.hpp"
+#include "Span.hpp"
+
+_MYLIB_BEGIN
+template <class... Fields>
+class SoACollection {
+	static_assert(sizeof...(Fields) > 0, "SoACollection needs at least one field");
+
+	using Indexes = std::index_sequence_for<Fields...>;
+
+public:
+	/* Types */
+	using value_type = std::tuple<Fields...>; // A row's values, copied out
+
+	template <size_t I>
+	using Field = std::tuple_element_t<I, value_type>; // Type of the Ith field
+
+	class ConstRow;
+
+	// Proxy for the fields of one row
+	class Row {
+	public:
+		template <size_t I>
+		Field<I> &get() const { return m_owner->template get<I>(m_idx); } // Returns the Ith field
+		std::tuple<Fields &...> tie() const { return m_owner->tieRow(m_idx, Indexes()); } // Returns references to every field
+		size_t index() const { return m_idx; } // Returns the row's index
+
+		Row(Row const &) = default; // Copies the proxy, still viewing the same row
+		operator value_type() const { return tie(); } // Copies the fields out
+		Row &operator=(value_type const &values) { tie() = values; return *this; } // Assigns every field
+		Row &operator=(Row const &row) { tie() = row.tie(); return *this; } // Assigns another row's fields, rather than rebinding
+
+	private:
+		friend class SoACollection;
+		friend class ConstRow;
+		Row(SoACollection *owner, size_t idx) : m_owner(owner), m_idx(idx) {};
+
+		SoACollection *m_owner;
+		size_t m_idx;
+	};
+
+	// Read only proxy for the fields of one row
+	class ConstRow {
+	public:
+		ConstRow(Row const &row) : m_owner(row.m_owner), m_idx(row.m_idx) {}; // Views a writable row
+
+		template <size_t I>
+		Field<I> const &get() const { return m_owner->template get<I>(m_idx); } // Returns the Ith field
+		std::tuple<Fields const &...> tie() const { return m_owner->tieRow(m_idx, Indexes()); } // Returns references to every field
+		size_t index() const { return m_idx; } // Returns the row's index
+
+		operator value_type() const { return tie(); } // Copies the fields out
+
+	private:
+		friend class SoACollection;
+		ConstRow(SoACollection const *owner, size_t idx) : m_owner(owner), m_idx(idx) {};
+
+		SoACollection const *m_owner;
+		size_t m_idx;
+	};
+
+	/* Constuctors */
+	SoACollection() = default; // Default constructor
+	explicit SoACollection(size_t count); // Preallocation constructor
+
+	/* Function members */
+	size_t size() const; // Returns count of rows
+	size_t capacity() const; // Returns count of rows every column has room for
+	bool empty() const; // Checks if there are no rows
+
+	void reserve(size_t count); // Allocates room for at least count rows in every column
+	void resize(size_t count); // Adds value initialised rows or removes rows from the end until there are count
+	void shrink_to_fit(); // Frees any capacity beyond the current size
+
+	template<class... Args>
+	void push(Args &&...args); // Adds a row at the end, constructing each field from its argument
+	template<class... Args>
+	void insert(size_t idx, Args &&...args); // Adds a row at specified index, constructing each field from its argument
+	void erase(size_t idx); // Removes the row at specified index
+	void erase(size_t first, size_t last); // Removes rows [first, last)
+	void clear(); // Removes every row
+	void swap(size_t idx1, size_t idx2); // Swaps two rows
+	void swap(SoACollection &c) noexcept; // Swaps two SoACollections
+
+	template <size_t I>
+	Span<Field<I>> column(); // Returns the Ith field of every row
+	template <size_t I>
+	Span<Field<I> const> column() const; // Returns the Ith field of every row, read only
+
+	template <size_t I>
+	Field<I> &get(size_t idx); // Returns the Ith field of a row
+	template <size_t I>
+	Field<I> const &get(size_t idx) const; // Returns the Ith field of a row, read only
+
+	/* Operators */
+	Row operator[](size_t idx); // Returns a proxy for a row
+	ConstRow operator[](size_t idx) const; // Returns a read only proxy for a row
+
+private:
+	/* Storage members */
+	std::tuple<Collection<Fields>...> m_columns; // One array per field, all the same size
+
+	/* Support functions */
+	template<class F>
+	void eachColumn(F const &f); // Calls f on every column in field order
+	template<size_t... Is, class... Args>
+	void insertRow(size_t idx, std::index_sequence<Is...>, Args &&...args); // Constructs a row's fields at specified index
+	void truncate(size_t count); // Removes rows past count from any column that has them
+
+	template<size_t... Is>
+	std::tuple<Fields &...> tieRow(size_t idx, std::index_sequence<Is...>); // Returns references to a row's fields
+	template<size_t... Is>
+	std::tuple<Fields const &...> tieRow(size_t idx, std::index_sequence<Is...>) const; // Returns const references to a row's fields
+};
+
+// ------
+// Public
+// ------
+
+// Preallocation constructor - reserves count rows in every column
+template<class... Fields>
+inline SoACollection<Fields...>::SoACollection(size_t count) {
+	reserve(count);
+}
+
+// Returns count of rows, which every column shares
+template<class... Fields>
+inline size_t SoACollection<Fields...>::size() const {
+	return std::get<0>(m_columns).size();
+}
+
+// Returns the smallest capacity of any column
+template<class... Fields>
+inline size_t SoACollection<Fields...>::capacity() const {
+	return std::apply([](auto const &...columns) {
+		size_t allocated = SIZE_MAX;
+		((allocated = columns.capacity() < allocated ? columns.capacity() : allocated), ...);
+		return allocated;
+	}, m_columns);
+}
+
+// Checks if there are no rows
+template<class... Fields>
+inline bool SoACollection<Fields...>::empty() const {
+	return size() == 0;
+}
+
+// Allocates room for at least count rows in every column
+template<class... Fields>
+inline void SoACollection<Fields...>::reserve(size_t count) {
+	eachColumn([count](auto &column) { column.reserve(count); });
+}
+
+// Adds value initialised rows or removes rows from the end until there are count
+// If a column fails to grow, the columns are cut back to the old size
+template<class... Fields>
+inline void SoACollection<Fields...>::resize(size_t count) {
+	size_t oldSize = size();
+	try {
+		eachColumn([count](auto &column) { column.resize(count); });
+	}
+	catch (...) {
+		truncate(oldSize);
+		throw;
+	}
+}
+
+// Frees any capacity beyond the current size
+template<class... Fields>
+inline void SoACollection<Fields...>::shrink_to_fit() {
+	eachColumn([](auto &column) { column.shrink_to_fit(); });
+}
+
+// Adds a row at the end, constructing each field from its argument
+template<class... Fields>
+template<class... Args>
+inline void SoACollection<Fields...>::push(Args &&...args) {
+	static_assert(sizeof...(Args) == sizeof...(Fields), "push takes one argument per field");
+
+	insertRow(size(), Indexes(), std::forward<Args>(args)...);
+}
+
+// Adds a row at specified index, constructing each field from its argument
+template<class... Fields>
+template<class... Args>
+inline void SoACollection<Fields...>::insert(size_t idx, Args &&...args) {
+	static_assert(sizeof...(Args) == sizeof...(Fields), "insert takes one argument per field");
+	assert(idx <= size());
+
+	insertRow(idx, Indexes(), std::forward<Args>(args)...);
+}
+
+// Removes the row at specified index
+template<class... Fields>
+inline void SoACollection<Fields...>::erase(size_t idx) {
+	// Check if the index is valid
+	if (idx >= size()) {
+		return;
+	}
+
+	erase(idx, idx + 1);
+}
+
+// Removes rows [first, last) from every column
+template<class... Fields>
+inline void SoACollection<Fields...>::erase(size_t first, size_t last) {
+	assert(first <= last && last <= size());
+
+	eachColumn([first, last](auto &column) { column.erase(first, last); });
+}
+
+// Removes every row
+template<class... Fields>
+inline void SoACollection<Fields...>::clear() {
+	eachColumn([](auto &column) { column.clear(); });
+}
+
+// Swaps two rows, field by field
+template<class... Fields>
+inline void SoACollection<Fields...>::swap(size_t idx1, size_t idx2) {
+	// Ensure indexes are valid
+	assert(idx1 < size() && idx2 < size());
+
+	eachColumn([idx1, idx2](auto &column) { column.swap(idx1, idx2); });
+}
+
+// Swaps two SoACollections, column by column
+template<class... Fields>
+inline void SoACollection<Fields...>::swap(SoACollection &c) noexcept {
+	std::apply([&c](auto &...columns) {
+		std::apply([&columns...](auto &...others) { (columns.swap(others), ...); }, c.m_columns);
+	}, m_columns);
+}
+
+// Returns the Ith field of every row
+// Adding or removing rows invalidates it
+template<class... Fields>
+template<size_t I>
+inline Span<typename SoACollection<Fields...>::template Field<I>> SoACollection<Fields...>::column() {
+	Collection<Field<I>> &column = std::get<I>(m_columns);
+	return Span<Field<I>>(column.begin(), column.size());
+}
+
+// Returns the Ith field of every row, read only
+template<class... Fields>
+template<size_t I>
+inline Span<typename SoACollection<Fields...>::template Field<I> const> SoACollection<Fields...>::column() const {
+	Collection<Field<I>> const &column = std::get<I>(m_columns);
+	return Span<Field<I> const>(column.begin(), column.size());
+}
+
+// Returns the Ith field of a row
+template<class... Fields>
+template<size_t I>
+inline typename SoACollection<Fields...>::template Field<I> &SoACollection<Fields...>::get(size_t idx) {
+	return std::get<I>(m_columns)[idx];
+}
+
+// Returns the Ith field of a row, read only
+template<class... Fields>
+template<size_t I>
+inline typename SoACollection<Fields...>::template Field<I> const &SoACollection<Fields...>::get(size_t idx) const {
+	return std::get<I>(m_columns)[idx];
+}
+
+// Returns a proxy for a row
+template<class... Fields>
+inline typename SoACollection<Fields...>::Row SoACollection<Fields...>::operator[](size_t idx) {
+	assert(idx < size());
+
+	return Row(this, idx);
+}
+
+// Returns a read only proxy for a row
+template<class... Fields>
+inline typename SoACollection<Fields...>::ConstRow SoACollection<Fields...>::operator[](size_t idx) const {
+	assert(idx < size());
+
+	return ConstRow(this, idx);
+}
+
+
+// -------
+// Private
+// -------
+
+// Calls f on every column in field order
+template<class... Fields>
+template<class F>
+inline void SoACollection<Fields...>::eachColumn(F const &f) {
+	std::apply([&f](auto &...columns) { (f(columns), ...); }, m_columns);
+}
+
+// Constructs a row's fields at specified index, column by column
+// If one throws, the fields already constructed are removed again
+template<class... Fields>
+template<size_t... Is, class... Args>
+inline void SoACollection<Fields...>::insertRow(size_t idx, std::index_sequence<Is...>, Args &&...args) {
+	size_t inserted = 0;
+	try {
+		((std::get<Is>(m_columns).emplace(idx, std::forward<Args>(args)), ++inserted), ...);
+	}
+	catch (...) {
+		eachColumn([idx, &inserted](auto &column) {
+			if (inserted > 0) {
+				column.erase(idx);
+				--inserted;
+			}
+		});
+		throw;
+	}
+}
+
+// Removes rows past count from any column that has them
+template<class... Fields>
+inline void SoACollection<Fields...>::truncate(size_t count) {
+	eachColumn([count](auto &column) {
+		if (column.size() > count) {
+			column.erase(count, column.size());
+		}
+	});
+}
+
+// Returns references to a row's fields
+template<class... Fields>
+template<size_t... Is>
+inline std::tuple<Fields &...> SoACollection<Fields...>::tieRow(size_t idx, std::index_sequence<Is...>) {
+	return std::tie(std::get<Is>(m_columns)[idx]...);
+}
+
+// Returns const references to a row's fields
+template<class... Fields>
+template<size_t... Is>
+inline std::tuple<Fields const &...> SoACollection<Fields...>::tieRow(size_t idx, std::index_sequence<Is...>) const {
+	return std::tie(std::get<Is>(m_columns)[idx]...);
+}
+_MYLIB_END
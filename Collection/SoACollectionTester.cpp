@@ -0,0 +1,176 @@
+/* SoACollectionTester
+ * A program to test SoACollection and Span against a std::vector of tuples
+ * Prints 1 for each check that passes and 0 for each that fails */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tuple> /* std::tuple, std::get, std::tie */
+#include <numeric> /* std::accumulate */
+#include <random> /* std::mt19937 */
+#include <stdexcept> /* std::runtime_error */
+#include "SoACollection.hpp"
+#include "Simd.hpp"
+
+using namespace std;
+using namespace mylib;
+
+int failures = 0;
+
+// Prints whether a check passed
+void check(bool passed, string const &what) {
+	cout << passed << ' ' << what << endl;
+	failures += !passed;
+}
+
+typedef SoACollection<int, double, string> Table;
+typedef tuple<int, double, string> Record;
+
+// Checks every row of a table against the same rows in a vector
+bool same(Table const &table, vector<Record> const &records) {
+	if (table.size() != records.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < records.size(); ++i) {
+		if (Record(table[i]) != records[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Field whose construction from a negative number throws
+struct Fragile {
+	Fragile() : value(0) {};
+	Fragile(int v) : value(v) {
+		if (v < 0) {
+			throw runtime_error("negative");
+		}
+	};
+
+	int value;
+};
+
+int main(void) {
+	mt19937 rng(5);
+	Table table;
+	vector<Record> records;
+
+	// Random pushes, inserts, erases and swaps
+	bool matched = true;
+	for (int step = 0; step < 5000; ++step) {
+		int value = static_cast<int>(rng() % 1000);
+		Record record(value, value / 4.0, to_string(value));
+		switch (records.empty() ? 0 : rng() % 5) {
+		case 0:
+		case 1:
+			table.push(get<0>(record), get<1>(record), get<2>(record));
+			records.push_back(record);
+			break;
+		case 2: {
+			size_t idx = rng() % (records.size() + 1);
+			table.insert(idx, get<0>(record), get<1>(record), get<2>(record));
+			records.insert(records.begin() + idx, record);
+			break;
+		}
+		case 3: {
+			size_t idx = rng() % records.size();
+			table.erase(idx);
+			records.erase(records.begin() + idx);
+			break;
+		}
+		case 4: {
+			size_t idx1 = rng() % records.size(), idx2 = rng() % records.size();
+			table.swap(idx1, idx2);
+			swap(records[idx1], records[idx2]);
+			break;
+		}
+		}
+		matched = matched && table.size() == records.size();
+	}
+	check(matched && same(table, records), "push, insert, erase and swap match a vector of tuples (" + to_string(records.size()) + " rows)");
+
+	// Range erase
+	table.erase(10, 60);
+	records.erase(records.begin() + 10, records.begin() + 60);
+	check(same(table, records), "erase of a range");
+
+	// Columns as Spans
+	long long expectedSum = 0;
+	for (Record const &record : records) {
+		expectedSum += get<0>(record);
+	}
+	Span<int> ints = table.column<0>();
+	check(ints.size() == records.size() && accumulate(ints.begin(), ints.end(), 0LL) == expectedSum, "column<0> sums like the first field");
+	check(simd::sum(ints.begin(), ints.end()) == expectedSum, "column<0> works with simd::sum");
+	Span<double const> doubles = static_cast<Table const &>(table).column<1>();
+	check(doubles.data() == &table.get<1>(0) && doubles[5] == get<1>(records[5]), "const column<1> views the same memory");
+
+	// Rows: get, tie, assignment
+	table[0].get<2>() = "changed";
+	get<2>(records[0]) = "changed";
+	int a;
+	double b;
+	string c;
+	tie(a, b, c) = table[1].tie();
+	check(Record(a, b, c) == records[1] && table[0].get<2>() == "changed", "Row get and tie");
+
+	table[2] = Record(-1, -0.5, "assigned");
+	records[2] = Record(-1, -0.5, "assigned");
+	table[3] = table[4];
+	records[3] = records[4];
+	check(same(table, records), "Row assignment from a tuple and from another row");
+
+	get<0>(table[5].tie()) = 12345;
+	get<0>(records[5]) = 12345;
+	check(table.get<0>(5) == 12345, "assigning through tie writes the field");
+
+	// resize
+	table.resize(table.size() + 3);
+	records.resize(records.size() + 3);
+	check(same(table, records), "resize adds value initialised rows");
+	table.resize(7);
+	records.resize(7);
+	check(same(table, records), "resize removes rows from the end");
+
+	// Copy, move and swap of whole tables
+	Table copy(table);
+	check(same(copy, records), "copy constructor");
+	Table moved(move(copy));
+	check(same(moved, records) && copy.empty(), "move constructor");
+	Table other;
+	other.push(1, 1.0, string("one"));
+	other.swap(moved);
+	check(same(other, records) && moved.size() == 1 && moved.get<2>(0) == "one", "swap of whole tables");
+
+	table.clear();
+	check(table.empty() && table.column<2>().empty(), "clear");
+
+	// A field that throws leaves every column as it was
+	SoACollection<int, string, Fragile> fragile;
+	for (int i = 0; i < 10; ++i) {
+		fragile.push(i, to_string(i), i);
+	}
+	try {
+		fragile.insert(4, 99, string("99"), -1);
+		check(false, "insert rethrows a field's exception");
+	}
+	catch (runtime_error &e) {
+		bool intact = fragile.size() == 10 && fragile.column<0>().size() == 10 && fragile.column<1>().size() == 10;
+		for (int i = 0; i < 10 && intact; ++i) {
+			intact = fragile.get<0>(i) == i && fragile.get<1>(i) == to_string(i) && fragile.get<2>(i).value == i;
+		}
+		check(intact, "insert that throws in the last field rolls back the others");
+	}
+	try {
+		fragile.push(10, string("10"), -1);
+		check(false, "push rethrows a field's exception");
+	}
+	catch (runtime_error &e) {
+		check(fragile.size() == 10 && fragile.column<1>().size() == 10, "push that throws rolls back the others");
+	}
+
+	cout << endl << (failures ? "FAILED: " + to_string(failures) : string("All passed")) << endl;
+
+	return failures != 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+/* Span
+ * A view of count contiguous items owned by something else
+ *
+ * It has begin(), end() and value_type like the collections, so the
+ * collection overloads of simd:: and parallel:: accept it. It is invalidated
+ * by anything that would invalidate a pointer into its owner */
+
+#include <assert.h> /* assert() */
+#include <cstddef> /* std::size_t */
+#include <type_traits> /* std::remove_cv_t */
+#include "Collection.hpp"
+
+_MYLIB_BEGIN
+template <class T>
+class Span {
+public:
+	/* Types */
+	using value_type = std::remove_cv_t<T>;
+
+	/* Iterators */
+	using iterator = T *;
+	using const_iterator = T *;
+
+	iterator begin() const { return m_pData; } // Returns iterator to beginning
+	iterator end() const { return m_pData + m_size; } // Returns iterator to end
+
+	/* Constuctors */
+	Span() : m_pData(nullptr), m_size(0) {}; // Empty span
+	Span(T *pData, size_t count) : m_pData(pData), m_size(count) {}; // Span of count items from pData
+
+	/* Function members */
+	size_t size() const { return m_size; } // Returns count of items
+	bool empty() const { return !m_size; } // Checks if there are no items
+	T *data() const { return m_pData; } // Returns the first item's address
+
+	/* Operators */
+	T &operator[](size_t idx) const; // Accesses the item at index
+
+private:
+	T *m_pData; // First item
+	size_t m_size; // Count of items
+};
+
+// Accesses the item at index
+template<class T>
+inline T &Span<T>::operator[](size_t idx) const {
+	assert(idx < m_size);
+
+	return m_pData[idx];
+}
+_MYLIB_END
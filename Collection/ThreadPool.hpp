@@ -0,0 +1,350 @@
+#pragma once
+/* ThreadPool
+ * A fixed set of worker threads sharing fork-join work by stealing
+ *
+ * Each worker has its own deque of tasks: it pushes and pops at the back, so
+ * it works depth first on what it split off last, while idle workers steal
+ * from the front, where the largest pieces of work are. Threads outside the
+ * pool share one more deque. A thread waiting for its tasks to finish runs
+ * tasks itself rather than blocking, which lets parallel calls nest.
+ *
+ * Work is submitted with forRange and invoke, which return once everything
+ * they started is done, rethrowing the first exception any piece of it threw.
+ * Programs using it must link with the platform's threads library */
+
+#include <cstddef> /* std::size_t */
+#include <vector> /* std::vector */
+#include <deque> /* std::deque */
+#include <memory> /* std::unique_ptr */
+#include <functional> /* std::function */
+#include <thread> /* std::thread */
+#include <mutex> /* std::mutex, std::lock_guard, std::unique_lock */
+#include <condition_variable> /* std::condition_variable */
+#include <atomic> /* std::atomic */
+#include <exception> /* std::exception_ptr */
+#include "Collection.hpp"
+
+_MYLIB_BEGIN
+class ThreadPool {
+public:
+	/* Constructors */
+	// Starts the given number of workers; with none, all work runs on the calling thread
+	explicit ThreadPool(size_t workers);
+	ThreadPool(ThreadPool const &) = delete;
+	ThreadPool &operator=(ThreadPool const &) = delete;
+
+	/* Deconstructor - stops and joins the workers */
+	~ThreadPool();
+
+	/* Function members */
+	size_t workers() const; // Returns the number of worker threads
+	size_t concurrency() const; // Returns the number of threads work can run on, the caller included
+
+	// Calls body(first, last) over pieces of [begin, end) no larger than grain, in parallel
+	// A piece is only split off while the calling thread's deque is empty, which
+	// is to say while other threads have taken everything it offered them
+	template<class F>
+	void forRange(size_t begin, size_t end, size_t grain, F const &body);
+
+	// Calls f and g, in parallel when a worker is free to take g
+	template<class F, class G>
+	void invoke(F const &f, G const &g);
+
+	/* Static members */
+	// Returns the pool shared by the whole program, with a worker for every core but the caller's
+	static ThreadPool &shared();
+
+private:
+	using Task = std::function<void()>;
+
+	// Deque of tasks, guarded by its mutex
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	// Completion of the tasks one call started, and the first exception they threw
+	struct Join {
+		std::atomic<size_t> pending{0};
+		std::atomic<bool> failed{false};
+		std::mutex mutex;
+		std::exception_ptr error;
+
+		void fail(std::exception_ptr e); // Records an exception unless one already was
+	};
+
+	std::vector<std::unique_ptr<Queue>> m_queues; // One per worker, then one for outside threads
+	std::vector<std::thread> m_threads;
+	std::atomic<size_t> m_queued{0}; // Tasks in all queues, which workers sleep until there are
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+	bool m_stopping = false;
+
+	// The pool the current thread works for, if any, and the index of its queue
+	static inline thread_local ThreadPool *t_pool = nullptr;
+	static inline thread_local size_t t_index = 0;
+
+	/* Support functions */
+	size_t localIndex() const; // Returns the queue of the current thread
+	bool localEmpty(); // Checks if the current thread's queue is empty
+	void push(Task task); // Queues a task on the current thread's queue and wakes a worker
+	bool pop(size_t idx, Task &task); // Takes the newest task from a queue
+	bool steal(size_t idx, Task &task); // Takes the oldest task from any queue but idx
+	bool runOne(); // Runs one task from anywhere, returning false if there was none
+	void wait(Join &join); // Runs tasks until join has none pending, then rethrows its exception
+	void work(size_t idx); // Worker thread loop
+
+	template<class F>
+	void split(size_t begin, size_t end, size_t grain, F const &body, Join &join);
+};
+
+// ------
+// Public
+// ------
+
+// Constructor - starts the workers
+inline ThreadPool::ThreadPool(size_t workers) {
+	for (size_t i = 0; i <= workers; ++i) {
+		m_queues.emplace_back(new Queue());
+	}
+
+	m_threads.reserve(workers);
+	for (size_t i = 0; i < workers; ++i) {
+		m_threads.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+// Deconstructor - wakes every worker to stop, then waits for them
+inline ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+
+	for (std::thread &thread : m_threads) {
+		thread.join();
+	}
+}
+
+// Returns the number of worker threads
+inline size_t ThreadPool::workers() const {
+	return m_threads.size();
+}
+
+// Returns the number of threads work can run on, the caller included
+inline size_t ThreadPool::concurrency() const {
+	return m_threads.size() + 1;
+}
+
+// Calls body over pieces of [begin, end) in parallel, returning when all are done
+template<class F>
+inline void ThreadPool::forRange(size_t begin, size_t end, size_t grain, F const &body) {
+	if (grain == 0) {
+		grain = 1;
+	}
+
+	if (begin >= end) {
+		return;
+	}
+
+	if (m_threads.empty() || end - begin <= grain) {
+		body(begin, end);
+		return;
+	}
+
+	Join join;
+	split(begin, end, grain, body, join);
+	wait(join);
+}
+
+// Calls f and g, offering g to the workers while f runs here
+template<class F, class G>
+inline void ThreadPool::invoke(F const &f, G const &g) {
+	if (m_threads.empty()) {
+		f();
+		g();
+		return;
+	}
+
+	Join join;
+	join.pending = 1;
+	push([&g, &join] {
+		try {
+			g();
+		}
+		catch (...) {
+			join.fail(std::current_exception());
+		}
+		join.pending.fetch_sub(1, std::memory_order_release);
+	});
+
+	try {
+		f();
+	}
+	catch (...) {
+		join.fail(std::current_exception());
+	}
+
+	wait(join);
+}
+
+// Returns the pool shared by the whole program
+inline ThreadPool &ThreadPool::shared() {
+	static ThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+	return pool;
+}
+
+
+// -------
+// Private
+// -------
+
+// Records an exception unless one already was
+inline void ThreadPool::Join::fail(std::exception_ptr e) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!error) {
+		error = e;
+	}
+	failed = true;
+}
+
+// Returns the queue of the current thread: its own for a worker, the shared one otherwise
+inline size_t ThreadPool::localIndex() const {
+	return t_pool == this ? t_index : m_threads.size();
+}
+
+// Checks if the current thread's queue is empty
+inline bool ThreadPool::localEmpty() {
+	Queue &queue = *m_queues[localIndex()];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	return queue.tasks.empty();
+}
+
+// Queues a task on the current thread's queue and wakes a worker
+// The count goes up before the sleep mutex is taken, so a worker either sees it or is woken
+inline void ThreadPool::push(Task task) {
+	Queue &queue = *m_queues[localIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+
+	m_queued.fetch_add(1);
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_wake.notify_one();
+}
+
+// Takes the newest task from a queue
+inline bool ThreadPool::pop(size_t idx, Task &task) {
+	Queue &queue = *m_queues[idx];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty()) {
+		return false;
+	}
+
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	m_queued.fetch_sub(1);
+	return true;
+}
+
+// Takes the oldest task from the first queue after idx that has one
+inline bool ThreadPool::steal(size_t idx, Task &task) {
+	size_t count = m_queues.size();
+	for (size_t i = 1; i < count; ++i) {
+		Queue &queue = *m_queues[(idx + i) % count];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+
+		task = std::move(queue.tasks.front());
+		queue.tasks.pop_front();
+		m_queued.fetch_sub(1);
+		return true;
+	}
+
+	return false;
+}
+
+// Runs one task, its own queue's newest first, otherwise stolen
+inline bool ThreadPool::runOne() {
+	size_t idx = localIndex();
+
+	Task task;
+	if (!pop(idx, task) && !steal(idx, task)) {
+		return false;
+	}
+
+	task();
+	return true;
+}
+
+// Runs tasks until join has none pending, then rethrows the first exception
+inline void ThreadPool::wait(Join &join) {
+	while (join.pending.load(std::memory_order_acquire)) {
+		if (!runOne()) {
+			std::this_thread::yield();
+		}
+	}
+
+	if (join.error) {
+		std::rethrow_exception(join.error);
+	}
+}
+
+// Worker thread loop, running tasks and sleeping while there are none
+inline void ThreadPool::work(size_t idx) {
+	t_pool = this;
+	t_index = idx;
+
+	while (true) {
+		if (runOne()) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wake.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+		if (m_stopping) {
+			return;
+		}
+	}
+}
+
+// Works through [begin, end) a grain at a time, splitting off the back half
+// for other threads whenever they have taken everything offered so far
+template<class F>
+inline void ThreadPool::split(size_t begin, size_t end, size_t grain, F const &body, Join &join) {
+	try {
+		while (end - begin > grain) {
+			if (join.failed) {
+				return;
+			}
+
+			if (!localEmpty()) {
+				body(begin, begin + grain);
+				begin += grain;
+				continue;
+			}
+
+			size_t middle = begin + (end - begin) / 2;
+			join.pending.fetch_add(1);
+			push([this, middle, end, grain, &body, &join] {
+				split(middle, end, grain, body, join);
+				join.pending.fetch_sub(1, std::memory_order_release);
+			});
+			end = middle;
+		}
+
+		if (!join.failed) {
+			body(begin, end);
+		}
+	}
+	catch (...) {
+		join.fail(std::current_exception());
+	}
+}
+_MYLIB_END